@@ -23,19 +23,33 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <assert.h>
 
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
 #include <picoapi.h>
 #include <picoapid.h>
+#include <picoextapi.h>
 #include <picoos.h>
 
+#include "picottsd.h"
+
 
 /* adaptation layer defines */
 #define PICO_MEM_SIZE       2500000
 #define DummyLen 100000000
 
+/* parallel synthesis (--jobs): additional memory per engine, and minimum
+   size of the text chunks handed to the engines */
+#define PICO_ENGINE_MEM_SIZE (PICOCTRL_DEFAULT_ENGINE_SIZE + 100000)
+#define JOB_CHUNK_SIZE      2000
+
 /* string constants */
-#define MAX_OUTBUF_SIZE     128
+#define MAX_OUTBUF_SIZE     4096
 #ifdef picolangdir
 const char * PICO_LINGWARE_PATH             = picolangdir "/";
 #else
@@ -67,7 +81,8 @@ pico_Char *     picoUtppFileName    = NULL;
 pico_Char *     picoTaResourceName  = NULL;
 pico_Char *     picoSgResourceName  = NULL;
 pico_Char *     picoUtppResourceName = NULL;
-int     picoSynthAbort = 0;
+char    picoMarkupOpen[PICO_MARKUP_SIZE];
+char    picoMarkupClose[PICO_MARKUP_SIZE];
 
 #define CHUNK_SIZE 16384UL
 /* buffered read from source until EOF; user should free the buffer */
@@ -95,13 +110,503 @@ size_t myread(FILE *source, char **buffer) {
     } while (1);
 }
 
+/* output: a wave file written through picoos (its header is completed when
+   the file is closed), or a stream of raw PCM or of WAV with a streaming
+   header, written to stdout (or a file) piece by piece as samples arrive */
+#define OUTPUT_BUF_SIZE     (4 * MAX_OUTBUF_SIZE)
+
+typedef struct {
+    picoos_Common   common;
+    picoos_SDFile   sdFile;
+    FILE *          stream;
+    /* samples passed on by the engine (see outputSpeech) not yet written */
+    short           buffer[OUTPUT_BUF_SIZE/2];
+    size_t          numBuffered;
+    int             failed;     /* a write failed; later samples are dropped */
+} output_t;
+
+/* RIFF and data chunk length of a WAV header written before the length is
+   known; understood as "until end of stream" by common players */
+#define WAV_STREAM_LEN  0xffffffffUL
+
+static void putLe(unsigned char * b, unsigned long v, int numBytes)
+{
+    int i;
+
+    for (i = 0; i < numBytes; i++) {
+        b[i] = (unsigned char) ((v >> (8 * i)) & 0xff);
+    }
+}
+
+/* opens 'fileName' ("-" for stdout) for output; returns 0 on success */
+static int outputOpen(output_t * out, picoos_Common common, const char * fileName, int raw)
+{
+    unsigned char hdr[44];
+
+    memset(out, 0, sizeof(*out));
+    out->common = common;
+    if (!raw && strcmp(fileName, "-")) {
+        return (TRUE == picoos_sdfOpenOut(common, &out->sdFile, (picoos_char *) fileName,
+                                          SAMPLE_FREQ_16KHZ, PICOOS_ENC_LIN)) ? 0 : -1;
+    }
+    out->stream = strcmp(fileName, "-") ? fopen(fileName, "wb") : stdout;
+    if (NULL == out->stream) {
+        return -1;
+    }
+    if (!raw) {
+        /* 16 kHz mono 16 bit PCM */
+        memcpy(hdr, "RIFF", 4);
+        putLe(hdr + 4, WAV_STREAM_LEN, 4);
+        memcpy(hdr + 8, "WAVEfmt ", 8);
+        putLe(hdr + 16, 16, 4);
+        putLe(hdr + 20, 1, 2);
+        putLe(hdr + 22, 1, 2);
+        putLe(hdr + 24, SAMPLE_FREQ_16KHZ, 4);
+        putLe(hdr + 28, 2 * SAMPLE_FREQ_16KHZ, 4);
+        putLe(hdr + 32, 2, 2);
+        putLe(hdr + 34, 16, 2);
+        memcpy(hdr + 36, "data", 4);
+        putLe(hdr + 40, WAV_STREAM_LEN, 4);
+        if (fwrite(hdr, 1, sizeof(hdr), out->stream) != sizeof(hdr)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* writes samples as little endian 16 bit PCM; returns 0 on success. Once a
+   write failed, nothing is written anymore and -1 is returned. */
+static int outputPutSamples(output_t * out, size_t numSamples, const short * samples)
+{
+    unsigned char b[2 * 1024];
+    size_t i, n;
+
+    if (out->failed) {
+        return -1;
+    }
+    if (out->sdFile) {
+        out->failed = (TRUE != picoos_sdfPutSamples(out->sdFile, numSamples, (picoos_int16 *) samples));
+        return out->failed ? -1 : 0;
+    }
+    while (numSamples > 0) {
+        n = (numSamples > 1024) ? 1024 : numSamples;
+        for (i = 0; i < n; i++) {
+            putLe(b + 2 * i, (unsigned short) samples[i], 2);
+        }
+        if (fwrite(b, 2, n, out->stream) != n) {
+            out->failed = 1;
+            return -1;
+        }
+        samples += n;
+        numSamples -= n;
+    }
+    /* pass every piece on at once, e.g. to a player reading from a pipe */
+    out->failed = (0 != fflush(out->stream));
+    return out->failed ? -1 : 0;
+}
+
+/* speech callback of the engine (see pico_setSpeechCallback): collects
+   the samples in out->buffer and writes them whenever it is full; a write
+   error is recorded in out->failed and reported by outputFlush */
+static void outputSpeech(void * userData, const pico_Int16 * samples, pico_Uint16 numSamples)
+{
+    output_t * out = (output_t *) userData;
+
+    if (out->numBuffered + numSamples > OUTPUT_BUF_SIZE/2) {
+        outputPutSamples(out, out->numBuffered, out->buffer);
+        out->numBuffered = 0;
+    }
+    memcpy(out->buffer + out->numBuffered, samples, numSamples * sizeof(short));
+    out->numBuffered += numSamples;
+}
+
+/* writes the samples collected by outputSpeech; returns 0 if all samples
+   so far were written */
+static int outputFlush(output_t * out)
+{
+    if (out->numBuffered) {
+        outputPutSamples(out, out->numBuffered, out->buffer);
+        out->numBuffered = 0;
+    }
+    return out->failed ? -1 : 0;
+}
+
+/* returns 0 on success */
+static int outputClose(output_t * out)
+{
+    int ret = 0;
+
+    if (out->sdFile) {
+        ret = (TRUE == picoos_sdfCloseOut(out->common, &out->sdFile)) ? 0 : -1;
+    } else if (out->stream) {
+        ret = ((stdout == out->stream) ? fflush(stdout) : fclose(out->stream)) ? -1 : 0;
+        out->stream = NULL;
+    }
+    return ret;
+}
+
+/* parallel synthesis: the text is split into chunks of whole sentences which
+   are synthesized by a pool of engines and written to the output in order */
+#define JOB_WAITING 0
+#define JOB_DONE    1
+#define JOB_FAILED  2
+
+typedef struct {
+    const char * text;          /* start of chunk (not zero terminated) */
+    size_t       len;
+    short *      samples;       /* synthesized chunk, malloc'ed */
+    size_t       numSamples;
+    size_t       capacity;      /* number of samples allocated */
+    int          state;
+} job_t;
+
+typedef struct {
+    job_t *         job;
+    int             numJobs;
+    int             nextJob;    /* next job to be taken by a worker */
+    int             written;    /* jobs written to the output so far */
+    int             maxAhead;   /* limits the memory held by finished jobs */
+    picoos_Mutex    lock;
+    picoos_Cond     cond;
+    pico_Engine     engine[PICO_MAX_NUM_ENGINES];
+} jobqueue_t;
+
+/* returns the end of the chunk starting at 'start': the first sentence end
+   at least JOB_CHUNK_SIZE bytes after 'start', or the end of the text. A
+   sentence ends at '.', '!' or '?' (optionally followed by closing quotes or
+   brackets) followed by white space and a line break, capital letter or
+   digit; periods after words shorter than four letters (likely
+   abbreviations, e.g. "Dr.") are not taken as sentence ends */
+static size_t chunkEnd(const char * text, size_t start, size_t len)
+{
+    size_t i, j, w;
+    int newline;
+
+    for (i = start + JOB_CHUNK_SIZE; i < len; i++) {
+        if ((text[i] != '.') && (text[i] != '!') && (text[i] != '?')) {
+            continue;
+        }
+        for (w = 0; (w < i) && isalpha((unsigned char) text[i - 1 - w]); w++);
+        if ((text[i] == '.') && (w < 4)) {
+            continue;
+        }
+        for (j = i + 1; (j < len) && strchr("\"')]", text[j]); j++);
+        if ((j < len) && !isspace((unsigned char) text[j])) {
+            continue;
+        }
+        newline = 0;
+        while ((j < len) && isspace((unsigned char) text[j])) {
+            newline |= (text[j] == '\n');
+            j++;
+        }
+        if ((j >= len) || newline || isupper((unsigned char) text[j]) || isdigit((unsigned char) text[j])) {
+            return j;
+        }
+    }
+    return len;
+}
+
+/* synthesis callback of the engines: appends the speech to job->samples */
+static pico_Status jobSpeech(void * userData, pico_Int16 event, const pico_Int16 * samples,
+                             pico_Int32 numSamples, const pico_Char * markName)
+{
+    job_t * job = (job_t *) userData;
+    short * grown;
+
+    if (event != PICO_EVENT_AUDIO) {
+        return PICO_OK;
+    }
+    if (job->numSamples + numSamples > job->capacity) {
+        grown = (short *) realloc(job->samples,
+                                  (2 * job->capacity + numSamples) * sizeof(short));
+        if (!grown) {
+            return PICO_EXC_OUT_OF_MEM;
+        }
+        job->samples = grown;
+        job->capacity = 2 * job->capacity + numSamples;
+    }
+    memcpy(job->samples + job->numSamples, samples, numSamples * sizeof(short));
+    job->numSamples += numSamples;
+    return PICO_OK;
+}
+
+/* synthesizes one chunk of text into job->samples; returns 0 on success */
+static int synthesizeJob(pico_Engine engine, job_t * job)
+{
+    /* the chunk with the prosody markup around it */
+    size_t openLen = strlen(picoMarkupOpen), closeLen = strlen(picoMarkupClose);
+    char * text = (char *) malloc(openLen + job->len + closeLen);
+    int ret;
+
+    if (!text) {
+        return -1;
+    }
+    memcpy(text, picoMarkupOpen, openLen);
+    memcpy(text + openLen, job->text, job->len);
+    memcpy(text + openLen + job->len, picoMarkupClose, closeLen);
+
+    /* start from a clean engine state, so that the output does not depend
+       on which engine synthesized the previous chunks */
+    ret = (pico_resetEngine(engine, PICO_RESET_FULL)
+           || pico_synthesize(engine, (const pico_Char *) text,
+                              openLen + job->len + closeLen, jobSpeech, job)) ? -1 : 0;
+    free(text);
+    return ret;
+}
+
+typedef struct {
+    jobqueue_t * queue;
+    pico_Engine  engine;
+} worker_t;
+
+static void synthesisWorker(void * arg)
+{
+    jobqueue_t * q = ((worker_t *) arg)->queue;
+    pico_Engine engine = ((worker_t *) arg)->engine;
+    job_t * job;
+    int failed;
+
+    picoos_lockMutex(q->lock);
+    for (;;) {
+        while ((q->nextJob < q->numJobs) && (q->nextJob >= q->written + q->maxAhead)) {
+            picoos_waitCond(q->cond, q->lock);
+        }
+        if (q->nextJob >= q->numJobs) {
+            break;
+        }
+        job = &q->job[q->nextJob++];
+        picoos_unlockMutex(q->lock);
+        failed = synthesizeJob(engine, job);
+        picoos_lockMutex(q->lock);
+        job->state = failed ? JOB_FAILED : JOB_DONE;
+        picoos_signalCond(q->cond);
+    }
+    picoos_unlockMutex(q->lock);
+}
+
+/* synthesizes 'text' on 'jobs' engines created with 'mode' (see
+   pico_newEngineEx) in parallel; returns 0 on success */
+static int synthesizeParallel(int jobs, pico_Int32 mode, const char * text, output_t * output)
+{
+    picoos_MemoryManager mm = pico_sysGetCommon(picoSystem)->mm;
+    size_t len = strlen(text), start;
+    jobqueue_t q;
+    worker_t worker[PICO_MAX_NUM_ENGINES];
+    picoos_Thread thread[PICO_MAX_NUM_ENGINES];
+    int i, started, ret = 0;
+
+    memset(&q, 0, sizeof(q));
+    memset(thread, 0, sizeof(thread));
+    q.maxAhead = 2 * jobs;
+    for (start = 0; start < len; start = chunkEnd(text, start, len)) {
+        q.numJobs++;
+    }
+    q.job = (job_t *) calloc(q.numJobs, sizeof(job_t));
+    for (i = 0, start = 0; i < q.numJobs; i++) {
+        q.job[i].text = text + start;
+        start = chunkEnd(text, start, len);
+        q.job[i].len = text + start - q.job[i].text;
+    }
+    q.lock = picoos_newMutex(mm);
+    q.cond = picoos_newCond(mm);
+    if ((NULL == q.job) || (NULL == q.lock) || (NULL == q.cond)) {
+        fprintf(stderr, "Cannot set up parallel synthesis\n");
+        ret = 1;
+        goto cleanup;
+    }
+    for (i = 0; i < jobs; i++) {
+        if (pico_newEngineEx(picoSystem, (const pico_Char *) PICO_VOICE_NAME, mode, &q.engine[i])) {
+            fprintf(stderr, "Cannot create pico engine %i\n", i);
+            ret = 1;
+            goto cleanup;
+        }
+    }
+    /* a thread that cannot be started only shrinks the pool; without any
+       worker, the writer below would wait forever */
+    for (i = 0, started = 0; i < jobs; i++) {
+        worker[i].queue = &q;
+        worker[i].engine = q.engine[i];
+        thread[i] = picoos_startThread(mm, synthesisWorker, &worker[i]);
+        if (NULL != thread[i]) {
+            started++;
+        }
+    }
+    if (0 == started) {
+        fprintf(stderr, "Cannot start synthesis threads\n");
+        ret = 1;
+        goto cleanup;
+    }
+    if (started < jobs) {
+        fprintf(stderr, "Warning: only %i of %i synthesis threads started\n", started, jobs);
+    }
+
+    /* write the chunks in order as they become ready */
+    for (i = 0; i < q.numJobs; i++) {
+        picoos_lockMutex(q.lock);
+        while (JOB_WAITING == q.job[i].state) {
+            picoos_waitCond(q.cond, q.lock);
+        }
+        picoos_unlockMutex(q.lock);
+        if (JOB_FAILED == q.job[i].state) {
+            fprintf(stderr, "Cannot synthesize text chunk %i\n", i);
+            ret = 1;
+        } else if (!ret && outputPutSamples(output, q.job[i].numSamples, q.job[i].samples)) {
+            /* the remaining chunks are still taken from the workers */
+            fprintf(stderr, "Cannot write output wave file\n");
+            ret = 1;
+        }
+        free(q.job[i].samples);
+        q.job[i].samples = NULL;
+        picoos_lockMutex(q.lock);
+        q.written++;
+        picoos_signalCond(q.cond);
+        picoos_unlockMutex(q.lock);
+    }
+
+    for (i = 0; i < jobs; i++) {
+        if (NULL != thread[i]) {
+            picoos_joinThread(mm, &thread[i]);
+        }
+    }
+cleanup:
+    for (i = 0; i < jobs; i++) {
+        if (q.engine[i]) {
+            pico_disposeEngine(picoSystem, &q.engine[i]);
+        }
+    }
+    picoos_disposeCond(mm, &q.cond);
+    picoos_disposeMutex(mm, &q.lock);
+    free(q.job);
+    return ret;
+}
+
+/* client mode (--server): the text is synthesized by picottsd */
+typedef struct {
+    int          fd;
+    const char * text;          /* NULL: read from stdin */
+} sender_t;
+
+/* returns 0 on success */
+static int sendAll(int fd, const char * data, size_t len)
+{
+    ssize_t n;
+
+    while (len > 0) {
+        n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return -1;
+        }
+        data += n;
+        len -= n;
+    }
+    return 0;
+}
+
+/* sends the text while the main thread receives the speech */
+static void sendText(void * arg)
+{
+    sender_t * sender = (sender_t *) arg;
+    char buf[CHUNK_SIZE];
+    ssize_t n;
+
+    if (sender->text) {
+        sendAll(sender->fd, sender->text, strlen(sender->text));
+    } else {
+        /* pass on stdin as it comes in */
+        while (((n = read(STDIN_FILENO, buf, sizeof(buf))) > 0) || ((n < 0) && (EINTR == errno))) {
+            if ((n > 0) && sendAll(sender->fd, buf, n)) {
+                break;
+            }
+        }
+    }
+    shutdown(sender->fd, SHUT_WR);
+}
+
+/* has 'text' (or stdin if NULL) synthesized by the daemon listening on
+   'socketPath' and writes the speech to 'output'; returns 0 on success */
+static int synthesizeRemote(const char * socketPath, const char * lang,
+                            int rate, int pitch, int volume,
+                            const char * text, output_t * output)
+{
+    picoos_MemoryManager mm = pico_sysGetCommon(picoSystem)->mm;
+    struct sockaddr_un addr;
+    char line[PICOTTSD_MAX_LINE_LEN];
+    unsigned char buf[MAX_OUTBUF_SIZE];
+    short samples[MAX_OUTBUF_SIZE/2];
+    sender_t sender;
+    picoos_Thread thread;
+    ssize_t n;
+    size_t len = 0, i;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path) - 1);
+    sender.fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sender.text = text;
+    if ((sender.fd < 0) || connect(sender.fd, (struct sockaddr *) &addr, sizeof(addr))) {
+        perror(socketPath);
+        return 1;
+    }
+    snprintf(line, sizeof(line), "lang=%s\nrate=%d\npitch=%d\nvolume=%d\n\n", lang, rate, pitch, volume);
+    if (sendAll(sender.fd, line, strlen(line))
+        || (NULL == (thread = picoos_startThread(mm, sendText, &sender)))) {
+        fprintf(stderr, "Cannot send request to %s\n", socketPath);
+        close(sender.fd);
+        return 1;
+    }
+
+    /* status line */
+    for (i = 0; i < sizeof(line) - 1; i++) {
+        if ((read(sender.fd, &line[i], 1) != 1) || ('\n' == line[i])) {
+            break;
+        }
+    }
+    line[i] = '\0';
+    if (strcmp(line, "OK")) {
+        /* the sender may still wait for input; it ends with the process */
+        fprintf(stderr, "Synthesis request failed: %s\n", line[0] ? line : "no answer");
+        close(sender.fd);
+        return 1;
+    }
+
+    /* speech, as little endian 16 bit samples */
+    while (((n = read(sender.fd, buf + len, sizeof(buf) - len)) > 0) || ((n < 0) && (EINTR == errno))) {
+        len += (n > 0) ? n : 0;
+        for (i = 0; i < len / 2; i++) {
+            samples[i] = (short) (buf[2 * i] | (buf[2 * i + 1] << 8));
+        }
+        if (outputPutSamples(output, len / 2, samples)) {
+            /* the sender may still wait for input; it ends with the process */
+            fprintf(stderr, "Cannot write output wave file\n");
+            close(sender.fd);
+            return 1;
+        }
+        if (len & 1) {
+            buf[0] = buf[len - 1];
+        }
+        len &= 1;
+    }
+    picoos_joinThread(mm, &thread);
+    close(sender.fd);
+    return (n < 0) ? 1 : 0;
+}
+
 int main(int argc, const char *argv[]) {
     char * wavefile = NULL;
     char * lang = "en-US";
     int langIndex = -1, langIndexTmp = -1;
     char * text = NULL;
-    int8_t * buffer;
-    size_t bufferSize = 256;
+    int jobs = 1;
+    int raw = 0;
+    int rate = 100, pitch = 100, volume = 100;
+    char * server = NULL;
+    int memReport = 0;
+    int lowLatency = 0, latencyReport = 0;
+    int cepLookahead = 0;
+    pico_Int32 timeToFirstSample = -1;
 
     /* Parsing options */
 	poptContext optCon; /* context for parsing command-line options */
@@ -109,9 +614,29 @@ int main(int argc, const char *argv[]) {
 
 	struct poptOption optionsTable[] = {
 		{ "wave", 'w', POPT_ARG_STRING, &wavefile, 0,
-		  "Write output to this WAV file (extension SHOULD be .wav)", "filename.wav" },
+		  "Write output to this WAV file (extension SHOULD be .wav), or stream it to stdout if '-'", "filename.wav" },
+		{ "raw", 0, POPT_ARG_NONE, &raw, 0,
+		  "Write raw 16 kHz 16 bit little endian PCM without header (to stdout unless --wave is given)", NULL },
 		{ "lang", 'l', POPT_ARG_STRING | POPT_ARGFLAG_SHOW_DEFAULT, &lang, 0,
 		  "Language", "lang" },
+		{ "rate", 'r', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT, &rate, 0,
+		  "Speaking rate in percent", "percent" },
+		{ "pitch", 'p', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT, &pitch, 0,
+		  "Pitch in percent", "percent" },
+		{ "volume", 'v', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT, &volume, 0,
+		  "Volume in percent", "percent" },
+		{ "server", 's', POPT_ARG_STRING, &server, 0,
+		  "Have the text synthesized by the picottsd daemon listening on this socket (default of picottsd: " PICOTTSD_SOCKET ")", "path" },
+		{ "jobs", 'j', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT, &jobs, 0,
+		  "Synthesize long texts on this many engines in parallel (sentences are then synthesized independently in chunks)", "n" },
+		{ "mem-report", 0, POPT_ARG_NONE, &memReport, 0,
+		  "Print the memory size Pico needed for this voice and text (its high-water mark) to stderr", NULL },
+		{ "low-latency", 0, POPT_ARG_NONE, &lowLatency, 0,
+		  "Start speaking as early as possible (the first phrase is cut short)", NULL },
+		{ "cep-lookahead", 0, POPT_ARG_INT, &cepLookahead, 0,
+		  "Generate the speech parameters in windows looking this many 4 ms frames ahead instead of per sentence (8..1023, e.g. 25)", "frames" },
+		{ "latency-report", 0, POPT_ARG_NONE, &latencyReport, 0,
+		  "Print the time from feeding the text to the first speech data to stderr", NULL },
 		POPT_AUTOHELP
 		POPT_TABLEEND
 	};
@@ -129,13 +654,20 @@ int main(int argc, const char *argv[]) {
 		}
 	}
 
-    /* Mandatory option: --wave */
+    /* Mandatory option: --wave (defaults to stdout with --raw) */
+	if(!wavefile && raw) {
+		wavefile = "-";
+	}
 	if(!wavefile) {
 		fprintf(stderr, "Mandatory option: %s\n\n",
-			"--wave=filename.wav");
+			"--wave=filename.wav (or --raw)");
 		poptPrintHelp(optCon, stderr, 0);
 		exit(1);
 	}
+	if((cepLookahead < 0) || (cepLookahead > 1023)) {
+		fprintf(stderr, "Invalid option --cep-lookahead: %i (valid: 0..1023)\n", cepLookahead);
+		exit(1);
+	}
 	/* option: --lang */
 	for(langIndexTmp =0; langIndexTmp<picoNumSupportedVocs; langIndexTmp++) {
 	    if(!strcmp(picoSupportedLang[langIndexTmp], lang)) {
@@ -155,49 +687,81 @@ int main(int argc, const char *argv[]) {
 		exit(1);
 	}
 
+	/* option: --jobs */
+	if((jobs < 1) || (jobs > PICO_MAX_NUM_ENGINES)) {
+		fprintf(stderr, "Number of jobs must be between 1 and %i\n", PICO_MAX_NUM_ENGINES);
+		exit(1);
+	}
+	/* the chunks of parallel synthesis are written out when complete, so
+	   speaking early cannot be had there */
+	if((jobs > 1) && lowLatency) {
+		fprintf(stderr, "Option --low-latency cannot be combined with --jobs\n");
+		exit(1);
+	}
+
+	/* options: --rate, --pitch, --volume */
+	if((rate < PICOTTSD_MIN_RATE) || (rate > PICOTTSD_MAX_RATE)
+	   || (pitch < PICOTTSD_MIN_PITCH) || (pitch > PICOTTSD_MAX_PITCH)
+	   || (volume < PICOTTSD_MIN_VOLUME) || (volume > PICOTTSD_MAX_VOLUME)) {
+		fprintf(stderr, "Valid ranges: rate %i-%i, pitch %i-%i, volume %i-%i\n",
+			PICOTTSD_MIN_RATE, PICOTTSD_MAX_RATE, PICOTTSD_MIN_PITCH, PICOTTSD_MAX_PITCH,
+			PICOTTSD_MIN_VOLUME, PICOTTSD_MAX_VOLUME);
+		exit(1);
+	}
+	formatMarkup(rate, pitch, volume, picoMarkupOpen, picoMarkupClose);
+
 	/* Remaining argument is <words> */
 	const char **extra_argv;
 	extra_argv = poptGetArgs(optCon);
     if(extra_argv) {
 		text = (char *) &(*extra_argv)[0];
-    } else {
-        // read from stdin
-        size_t len = myread(stdin, &text);
-        // debug buffered read: make this command a pass-though cat-like command and compare input with output
-        // printf("read %ld characters\n", len);
-        // fwrite(text, 1, len, stdout);
-        // exit(1);
-
-        // TODO: break text in chunks of max size equal to pico_Int16 textSize,
-        // /usr/include/picoapi.h:typedef short pico_Int16;
-        // /usr/include/limits.h:#  define SHRT_MAX        32767
+    } else if ((jobs > 1) && !server) {
+        // parallel synthesis splits the whole document: read all of stdin
+        myread(stdin, &text);
     }
+    // otherwise stdin is streamed through the engine in the synthesis loop
 
     poptFreeContext(optCon);
 
-    buffer = malloc( bufferSize );
-
     int ret, getstatus;
     pico_Char * inp = NULL;
     pico_Char * local_text = NULL;
-    short       outbuf[MAX_OUTBUF_SIZE/2];
-    pico_Int16  bytes_sent, bytes_recv, text_remaining, out_data_type;
+    char *      inbuf = NULL;
+    int         eof = 0;
+    pico_Int32  bytes_sent, bytes_recv, text_remaining;
+    pico_Int16  out_data_type;
     pico_Retstring outMessage;
 
-    picoSynthAbort = 0;
-
-    picoMemArea = malloc( PICO_MEM_SIZE );
-    if((ret = pico_initialize( picoMemArea, PICO_MEM_SIZE, &picoSystem ))) {
+    /* the memory is extended from the heap should it not suffice */
+    size_t memSize = PICO_MEM_SIZE + (jobs - 1) * PICO_ENGINE_MEM_SIZE;
+    picoMemArea = malloc( memSize );
+    if((ret = pico_initializeEx( picoMemArea, memSize, PICO_MEM_FIRST_FIT | PICO_MEM_GROW, &picoSystem ))) {
         pico_getSystemStatusMessage(picoSystem, ret, outMessage);
         fprintf(stderr, "Cannot initialize pico (%i): %s\n", ret, outMessage);
         goto terminate;
     }
 
+    /* Client mode: no resources and engines needed here */
+    if (server) {
+        output_t output;
+        if (outputOpen(&output, pico_sysGetCommon(picoSystem), wavefile, raw)) {
+            fprintf(stderr, "Cannot open output wave file\n");
+            ret = 1;
+            goto terminate;
+        }
+        ret = synthesizeRemote(server, lang, rate, pitch, volume, text, &output);
+        if (outputClose(&output)) {
+            fprintf(stderr, "Cannot close output wave file\n");
+            ret = 1;
+        }
+        goto terminate;
+    }
+
     /* Load the text analysis Lingware resource file.   */
     picoTaFileName      = (pico_Char *) malloc( PICO_MAX_DATAPATH_NAME_SIZE + PICO_MAX_FILE_NAME_SIZE );
     strcpy((char *) picoTaFileName,   PICO_LINGWARE_PATH);
     strcat((char *) picoTaFileName,   (const char *) picoInternalTaLingware[langIndex]);
-    if((ret = pico_loadResource( picoSystem, picoTaFileName, &picoTaResource ))) {
+    if((ret = pico_loadResourceEx( picoSystem, picoTaFileName, PICO_LOAD_MAP, &picoTaResource ))) {
         pico_getSystemStatusMessage(picoSystem, ret, outMessage);
         fprintf(stderr, "Cannot load text analysis resource file (%i): %s\n", ret, outMessage);
         goto unloadTaResource;
@@ -207,7 +771,7 @@ int main(int argc, const char *argv[]) {
     picoSgFileName      = (pico_Char *) malloc( PICO_MAX_DATAPATH_NAME_SIZE + PICO_MAX_FILE_NAME_SIZE );
     strcpy((char *) picoSgFileName,   PICO_LINGWARE_PATH);
     strcat((char *) picoSgFileName,   (const char *) picoInternalSgLingware[langIndex]);
-    if((ret = pico_loadResource( picoSystem, picoSgFileName, &picoSgResource ))) {
+    if((ret = pico_loadResourceEx( picoSystem, picoSgFileName, PICO_LOAD_MAP, &picoSgResource ))) {
         pico_getSystemStatusMessage(picoSystem, ret, outMessage);
         fprintf(stderr, "Cannot load signal generation Lingware resource file (%i): %s\n", ret, outMessage);
         goto unloadSgResource;
@@ -262,83 +826,103 @@ int main(int argc, const char *argv[]) {
         goto unloadUtppResource;
     }
 
-    /* Create a new Pico engine. */
-    if((ret = pico_newEngine( picoSystem, (const pico_Char *) PICO_VOICE_NAME, &picoEngine ))) {
+    /* Create a new Pico engine; text analysis runs in its own thread.
+       With --jobs, the engines are created by synthesizeParallel. */
+    if((jobs == 1) && (ret = pico_newEngineEx( picoSystem, (const pico_Char *) PICO_VOICE_NAME,
+            PICO_ENGINE_PIPELINED | (lowLatency ? PICO_ENGINE_LOW_LATENCY : 0)
+            | PICO_ENGINE_CEP_LOOKAHEAD(cepLookahead), &picoEngine ))) {
         pico_getSystemStatusMessage(picoSystem, ret, outMessage);
         fprintf(stderr, "Cannot create a new pico engine (%i): %s\n", ret, outMessage);
         goto disposeEngine;
     }
 
-    local_text = (pico_Char *) text ;
-    text_remaining = strlen((const char *) local_text) + 1;
-
-    inp = (pico_Char *) local_text;
-
-    size_t bufused = 0;
-
     picoos_Common common = (picoos_Common) pico_sysGetCommon(picoSystem);
 
-    picoos_SDFile sdOutFile = NULL;
+    output_t output;
 
-    picoos_bool done = TRUE;
-    if(TRUE != (done = picoos_sdfOpenOut(common, &sdOutFile,
-        (picoos_char *) wavefile, SAMPLE_FREQ_16KHZ, PICOOS_ENC_LIN)))
+    if(outputOpen(&output, common, wavefile, raw))
     {
         fprintf(stderr, "Cannot open output wave file\n");
         ret = 1;
         goto disposeEngine;
     }
 
-    /* synthesis loop   */
-    while (text_remaining) {
-        /* Feed the text into the engine.   */
-        if((ret = pico_putTextUtf8( picoEngine, inp, text_remaining, &bytes_sent ))) {
-            pico_getSystemStatusMessage(picoSystem, ret, outMessage);
-            fprintf(stderr, "Cannot put Text (%i): %s\n", ret, outMessage);
-            goto disposeEngine;
+    if (jobs > 1) {
+        ret = synthesizeParallel(jobs, PICO_ENGINE_CEP_LOOKAHEAD(cepLookahead), text, &output);
+        eof = 1;
+    } else {
+        /* signal generation passes the samples straight to the output */
+        pico_setSpeechCallback(picoEngine, outputSpeech, &output);
+        if (!text) {
+            inbuf = malloc(CHUNK_SIZE + 1);
         }
+    }
 
-        text_remaining -= bytes_sent;
-        inp += bytes_sent;
+    /* synthesis loop: text from stdin is read line by line (or in pieces of
+       CHUNK_SIZE for longer lines) and synthesized as soon as it is read, so
+       that memory use does not depend on the input size; the engine joins
+       words split between pieces. A terminating zero flushes the engine. */
+    int markupDone = 0, textDone = 0;
+    while (!eof) {
+        if (!markupDone) {
+            /* prosody markup (--rate, --pitch, --volume) before the text */
+            local_text = (pico_Char *) picoMarkupOpen;
+            text_remaining = strlen(picoMarkupOpen);
+            markupDone = 1;
+        } else if (text && !textDone) {
+            local_text = (pico_Char *) text;
+            text_remaining = strlen(text);
+            textDone = 1;
+        } else if (!text && fgets(inbuf, CHUNK_SIZE + 1, stdin)) {
+            local_text = (pico_Char *) inbuf;
+            text_remaining = strlen(inbuf);
+        } else if (!text && ferror(stdin)) {
+            fprintf(stderr, "Cannot read text from stdin\n");
+            ret = 1;
+            goto disposeEngine;
+        } else {
+            /* closing markup and terminating zero */
+            local_text = (pico_Char *) picoMarkupClose;
+            text_remaining = strlen(picoMarkupClose) + 1;
+            eof = 1;
+        }
+        inp = local_text;
 
-        do {
-            if (picoSynthAbort) {
+        while (text_remaining) {
+            /* Feed the text into the engine.   */
+            if((ret = pico_putTextUtf8Ex( picoEngine, inp, text_remaining, &bytes_sent ))) {
+                pico_getSystemStatusMessage(picoSystem, ret, outMessage);
+                fprintf(stderr, "Cannot put Text (%i): %s\n", ret, outMessage);
                 goto disposeEngine;
             }
-            /* Retrieve the samples and add them to the buffer. */
-            getstatus = pico_getData( picoEngine, (void *) outbuf,
-                      MAX_OUTBUF_SIZE, &bytes_recv, &out_data_type );
-            if((getstatus !=PICO_STEP_BUSY) && (getstatus !=PICO_STEP_IDLE)){
-                pico_getSystemStatusMessage(picoSystem, getstatus, outMessage);
-                fprintf(stderr, "Cannot get Data (%i): %s\n", getstatus, outMessage);
-                goto disposeEngine;
-            }
-            if (bytes_recv) {
-                if ((bufused + bytes_recv) <= bufferSize) {
-                    memcpy(buffer+bufused, (int8_t *) outbuf, bytes_recv);
-                    bufused += bytes_recv;
-                } else {
-                    done = picoos_sdfPutSamples(
-                                        sdOutFile,
-                                        bufused / 2,
-                                        (picoos_int16*) (buffer));
-                    bufused = 0;
-                    memcpy(buffer, (int8_t *) outbuf, bytes_recv);
-                    bufused += bytes_recv;
+
+            text_remaining -= bytes_sent;
+            inp += bytes_sent;
+
+            do {
+                /* Synthesize; the samples arrive through outputSpeech. */
+                getstatus = pico_getDataEx( picoEngine, NULL, 0, &bytes_recv, &out_data_type );
+                if((getstatus !=PICO_STEP_BUSY) && (getstatus !=PICO_STEP_IDLE)){
+                    pico_getSystemStatusMessage(picoSystem, getstatus, outMessage);
+                    fprintf(stderr, "Cannot get Data (%i): %s\n", getstatus, outMessage);
+                    goto disposeEngine;
                 }
+            } while (PICO_STEP_BUSY == getstatus);
+            /* the time to first sample of the whole text is that of its first
+               piece producing speech */
+            if (timeToFirstSample < 0) {
+                picoext_getEngineTimeToFirstSample(picoEngine, &timeToFirstSample);
+            }
+            /* This chunk of synthesis is finished; pass the remaining samples. */
+            if (outputFlush(&output)) {
+                fprintf(stderr, "Cannot write output wave file\n");
+                ret = 1;
+                goto disposeEngine;
             }
-        } while (PICO_STEP_BUSY == getstatus);
-        /* This chunk of synthesis is finished; pass the remaining samples. */
-        if (!picoSynthAbort) {
-                    done = picoos_sdfPutSamples(
-                                        sdOutFile,
-                                        bufused / 2,
-                                        (picoos_int16*) (buffer));
         }
-        picoSynthAbort = 0;
     }
 
-    if(TRUE != (done = picoos_sdfCloseOut(common, &sdOutFile)))
+    if(outputClose(&output))
     {
         fprintf(stderr, "Cannot close output wave file\n");
         ret = 1;
@@ -346,6 +930,10 @@ int main(int argc, const char *argv[]) {
     }
 
 disposeEngine:
+    free(inbuf);
+    if (latencyReport && (timeToFirstSample >= 0)) {
+        fprintf(stderr, "Time to first sample: %i us\n", (int) timeToFirstSample);
+    }
     if (picoEngine) {
         pico_disposeEngine( picoSystem, &picoEngine );
         pico_releaseVoiceDefinition( picoSystem, (pico_Char *) PICO_VOICE_NAME );
@@ -368,6 +956,10 @@ unloadTaResource:
     }
 terminate:
     if (picoSystem) {
+        pico_Int32 highWater;
+        if (memReport && (PICO_OK == picoext_getSystemMemHighWater(picoSystem, &highWater))) {
+            fprintf(stderr, "Pico memory high-water mark: %i bytes\n", (int) highWater);
+        }
         pico_terminate(&picoSystem);
         picoSystem = NULL;
     }
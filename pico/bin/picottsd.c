@@ -0,0 +1,468 @@
+/* picottsd.c
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *   Synthesis daemon: loads the voices of all supported languages once and
+ *   synthesizes the requests received on a Unix domain socket, so that
+ *   clients do not pay for system initialization and resource loading
+ *   (see picottsd.h for the protocol). Runs in the foreground until it
+ *   receives SIGINT, SIGTERM or SIGHUP.
+ *
+ */
+
+#include <popt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#include <picoapi.h>
+#include <picoapid.h>
+#include <picoos.h>
+
+#include "picottsd.h"
+
+
+/* memory for the system and the voices, and additionally for each engine */
+#define PICO_MEM_SIZE        2500000
+#define PICO_ENGINE_MEM_SIZE (PICOCTRL_DEFAULT_ENGINE_SIZE + 100000)
+
+#define MAX_OUTBUF_SIZE      4096
+#define MAX_INBUF_SIZE       4096
+
+/* default of --timeout: seconds a client may stay silent (or not read the
+   speech) before its request is dropped */
+#define CLIENT_TIMEOUT       30
+
+#ifdef picolangdir
+const char * PICO_LINGWARE_PATH             = picolangdir "/";
+#else
+const char * PICO_LINGWARE_PATH             = "./lang/";
+#endif
+
+/* supported voices; each voice definition is named after its language */
+const char * picoSupportedLang[]            = { "en-US",            "en-GB",            "de-DE",            "es-ES",            "fr-FR",            "it-IT" };
+const char * picoInternalTaLingware[]       = { "en-US_ta.bin",     "en-GB_ta.bin",     "de-DE_ta.bin",     "es-ES_ta.bin",     "fr-FR_ta.bin",     "it-IT_ta.bin" };
+const char * picoInternalSgLingware[]       = { "en-US_lh0_sg.bin", "en-GB_kh0_sg.bin", "de-DE_gl0_sg.bin", "es-ES_zl0_sg.bin", "fr-FR_nk0_sg.bin", "it-IT_cm0_sg.bin" };
+#define PICO_NUM_SUPPORTED_VOCS 6
+
+void *          picoMemArea         = NULL;
+pico_System     picoSystem          = NULL;
+pico_Resource   picoTaResource[PICO_NUM_SUPPORTED_VOCS];
+pico_Resource   picoSgResource[PICO_NUM_SUPPORTED_VOCS];
+int             picoVoiceLoaded[PICO_NUM_SUPPORTED_VOCS];
+int             listenFd            = -1;
+int             clientTimeout       = CLIENT_TIMEOUT;
+
+
+/* ******************************************************************** */
+/* voices                                                               */
+/* ******************************************************************** */
+
+static void unloadVoice(int lang)
+{
+    if (picoVoiceLoaded[lang]) {
+        pico_releaseVoiceDefinition(picoSystem, (const pico_Char *) picoSupportedLang[lang]);
+        picoVoiceLoaded[lang] = 0;
+    }
+    if (picoSgResource[lang]) {
+        pico_unloadResource(picoSystem, &picoSgResource[lang]);
+    }
+    if (picoTaResource[lang]) {
+        pico_unloadResource(picoSystem, &picoTaResource[lang]);
+    }
+}
+
+/* loads the resources of 'lang' and defines its voice; returns 0 on success */
+static int loadVoice(int lang)
+{
+    char fileName[PICO_MAX_DATAPATH_NAME_SIZE + PICO_MAX_FILE_NAME_SIZE];
+    const pico_Char * voiceName = (const pico_Char *) picoSupportedLang[lang];
+    pico_Retstring name;
+    pico_Retstring outMessage;
+    int ret;
+
+    snprintf(fileName, sizeof(fileName), "%s%s", PICO_LINGWARE_PATH, picoInternalTaLingware[lang]);
+    ret = pico_loadResourceEx(picoSystem, (pico_Char *) fileName, PICO_LOAD_MAP, &picoTaResource[lang]);
+    if (!ret) {
+        snprintf(fileName, sizeof(fileName), "%s%s", PICO_LINGWARE_PATH, picoInternalSgLingware[lang]);
+        ret = pico_loadResourceEx(picoSystem, (pico_Char *) fileName, PICO_LOAD_MAP, &picoSgResource[lang]);
+    }
+    if (!ret && !(ret = pico_createVoiceDefinition(picoSystem, voiceName))) {
+        picoVoiceLoaded[lang] = 1;
+    }
+    if (!ret && !(ret = pico_getResourceName(picoSystem, picoTaResource[lang], name))) {
+        ret = pico_addResourceToVoiceDefinition(picoSystem, voiceName, (pico_Char *) name);
+    }
+    if (!ret && !(ret = pico_getResourceName(picoSystem, picoSgResource[lang], name))) {
+        ret = pico_addResourceToVoiceDefinition(picoSystem, voiceName, (pico_Char *) name);
+    }
+    if (ret) {
+        pico_getSystemStatusMessage(picoSystem, ret, outMessage);
+        fprintf(stderr, "Cannot load voice %s (%i): %s\n", picoSupportedLang[lang], ret, outMessage);
+        unloadVoice(lang);
+    }
+    return ret;
+}
+
+
+/* ******************************************************************** */
+/* clients                                                              */
+/* ******************************************************************** */
+
+typedef struct {
+    int             fd;
+    char            buf[MAX_INBUF_SIZE];
+    int             pos;        /* start of the unread part of 'buf' */
+    int             len;
+    pico_Engine     engine;
+} client_t;
+
+/* refills the input buffer; returns the number of bytes read, 0 at the
+   end of the request, or -1 on error */
+static int clientRead(client_t * c)
+{
+    ssize_t n;
+
+    do {
+        n = read(c->fd, c->buf, sizeof(c->buf));
+    } while ((n < 0) && (EINTR == errno));
+    c->pos = 0;
+    c->len = (n > 0) ? (int) n : 0;
+    return (int) n;
+}
+
+/* reads a header line without its newline; returns 0 on success */
+static int clientReadLine(client_t * c, char line[PICOTTSD_MAX_LINE_LEN])
+{
+    int n = 0;
+    char ch;
+
+    for (;;) {
+        if ((c->pos >= c->len) && (clientRead(c) <= 0)) {
+            return -1;
+        }
+        ch = c->buf[c->pos++];
+        if ('\n' == ch) {
+            line[n] = '\0';
+            return 0;
+        }
+        if (n >= PICOTTSD_MAX_LINE_LEN - 1) {
+            return -1;
+        }
+        line[n++] = ch;
+    }
+}
+
+/* returns 0 on success */
+static int clientWrite(client_t * c, const void * data, size_t len)
+{
+    const char * p = (const char *) data;
+    ssize_t n;
+
+    while (len > 0) {
+        n = send(c->fd, p, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+/* passes 'len' bytes of text to the engine and sends the speech synthesized
+   meanwhile to the client; returns 0 on success */
+static int clientSynthesize(client_t * c, const char * text, pico_Int32 len)
+{
+    short pcm[MAX_OUTBUF_SIZE / 2];
+    unsigned char le[MAX_OUTBUF_SIZE];
+    pico_Int32 bytesPut, bytesReceived, i;
+    pico_Int16 outDataType;
+    int status;
+
+    while (len > 0) {
+        if (pico_putTextUtf8Ex(c->engine, (const pico_Char *) text, len, &bytesPut)) {
+            return -1;
+        }
+        text += bytesPut;
+        len -= bytesPut;
+        do {
+            status = pico_getDataEx(c->engine, pcm, MAX_OUTBUF_SIZE, &bytesReceived, &outDataType);
+            if ((PICO_STEP_BUSY != status) && (PICO_STEP_IDLE != status)) {
+                return -1;
+            }
+            for (i = 0; i < bytesReceived / 2; i++) {
+                le[2 * i] = (unsigned char) (pcm[i] & 0xff);
+                le[2 * i + 1] = (unsigned char) ((pcm[i] >> 8) & 0xff);
+            }
+            if (bytesReceived && clientWrite(c, le, bytesReceived)) {
+                return -1;
+            }
+        } while (PICO_STEP_BUSY == status);
+    }
+    return 0;
+}
+
+/* parses a "key=value" header line into the request parameters; returns
+   an error message, or NULL on success */
+static const char * parseHeaderLine(char * line, int * lang, int * rate, int * pitch, int * volume)
+{
+    char * value = strchr(line, '=');
+    int i;
+
+    if (NULL == value) {
+        return "malformed header line";
+    }
+    *value++ = '\0';
+    if (!strcmp(line, "lang")) {
+        for (i = 0; i < PICO_NUM_SUPPORTED_VOCS; i++) {
+            if (!strcmp(picoSupportedLang[i], value)) {
+                *lang = i;
+                return NULL;
+            }
+        }
+        return "unknown language";
+    } else if (!strcmp(line, "rate")) {
+        *rate = atoi(value);
+        return ((*rate < PICOTTSD_MIN_RATE) || (*rate > PICOTTSD_MAX_RATE)) ? "rate out of range" : NULL;
+    } else if (!strcmp(line, "pitch")) {
+        *pitch = atoi(value);
+        return ((*pitch < PICOTTSD_MIN_PITCH) || (*pitch > PICOTTSD_MAX_PITCH)) ? "pitch out of range" : NULL;
+    } else if (!strcmp(line, "volume")) {
+        *volume = atoi(value);
+        return ((*volume < PICOTTSD_MIN_VOLUME) || (*volume > PICOTTSD_MAX_VOLUME)) ? "volume out of range" : NULL;
+    }
+    return "unknown header key";
+}
+
+/* serves one request on 'fd' and closes it */
+static void serveClient(int fd)
+{
+    client_t c;
+    char line[PICOTTSD_MAX_LINE_LEN];
+    char markupOpen[PICO_MARKUP_SIZE], markupClose[PICO_MARKUP_SIZE];
+    const char * error = NULL;
+    int lang = 0, rate = 100, pitch = 100, volume = 100;
+    int ok, n = 0;
+    struct timeval timeout;
+
+    c.fd = fd;
+    c.pos = c.len = 0;
+    c.engine = NULL;
+
+    /* a client that stops sending or reading must not hold the worker
+       forever: reads and writes fail after the timeout */
+    if (clientTimeout > 0) {
+        timeout.tv_sec = clientTimeout;
+        timeout.tv_usec = 0;
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    }
+
+    /* request header */
+    while (NULL == error) {
+        if (clientReadLine(&c, line)) {
+            error = "incomplete request header";
+        } else if ('\0' == line[0]) {
+            break;
+        } else {
+            error = parseHeaderLine(line, &lang, &rate, &pitch, &volume);
+        }
+    }
+    if ((NULL == error) && !picoVoiceLoaded[lang]) {
+        error = "language not available";
+    }
+    if ((NULL == error) && pico_newEngine(picoSystem, (const pico_Char *) picoSupportedLang[lang], &c.engine)) {
+        error = "cannot create engine";
+    }
+    if (NULL != error) {
+        snprintf(line, sizeof(line), "ERR %s\n", error);
+        clientWrite(&c, line, strlen(line));
+        close(fd);
+        return;
+    }
+
+    ok = !clientWrite(&c, "OK\n", 3);
+    formatMarkup(rate, pitch, volume, markupOpen, markupClose);
+    ok = ok && !clientSynthesize(&c, markupOpen, strlen(markupOpen));
+    /* the text: the rest of the buffer, then everything up to the end of the request */
+    while (ok && ((c.pos < c.len) || ((n = clientRead(&c)) > 0))) {
+        ok = !clientSynthesize(&c, c.buf + c.pos, c.len - c.pos);
+        c.pos = c.len;
+    }
+    /* a read error (e.g. the timeout) drops the request */
+    ok = ok && (n >= 0);
+    /* close the markup; the terminating zero flushes the engine */
+    ok = ok && !clientSynthesize(&c, markupClose, strlen(markupClose) + 1);
+
+    pico_disposeEngine(picoSystem, &c.engine);
+    close(fd);
+}
+
+static void worker(void * arg)
+{
+    int fd;
+
+    for (;;) {
+        fd = accept(listenFd, NULL, NULL);
+        if (fd >= 0) {
+            serveClient(fd);
+        } else if ((EINVAL == errno) || (EBADF == errno)) {
+            /* listening socket was shut down */
+            break;
+        } else if ((EINTR != errno) && (ECONNABORTED != errno)) {
+            perror("accept");
+            sleep(1);
+        }
+    }
+}
+
+
+/* ******************************************************************** */
+/* main                                                                 */
+/* ******************************************************************** */
+
+int main(int argc, const char *argv[]) {
+    char * socketPath = PICOTTSD_SOCKET;
+    int clients = 4;
+    picoos_Thread worker_thread[PICO_MAX_NUM_ENGINES];
+    struct sockaddr_un addr;
+    sigset_t signals;
+    int sig, lang, numVoices = 0, i, ret = 1;
+    size_t memSize;
+    pico_Retstring outMessage;
+
+    /* Parsing options */
+	poptContext optCon; /* context for parsing command-line options */
+	int opt; /* used for argument parsing */
+
+	struct poptOption optionsTable[] = {
+		{ "socket", 's', POPT_ARG_STRING | POPT_ARGFLAG_SHOW_DEFAULT, &socketPath, 0,
+		  "Listen on this Unix domain socket", "path" },
+		{ "clients", 'c', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT, &clients, 0,
+		  "Maximum number of requests served at the same time", "n" },
+		{ "timeout", 't', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT, &clientTimeout, 0,
+		  "Drop requests whose client sends or reads nothing for this long (0: never)", "seconds" },
+		POPT_AUTOHELP
+		POPT_TABLEEND
+	};
+	optCon = poptGetContext(NULL, argc, argv, optionsTable, POPT_CONTEXT_POSIXMEHARDER);
+
+	while ((opt = poptGetNextOpt(optCon)) != -1) {
+		switch (opt) {
+		default:
+			fprintf(stderr, "Invalid option %s: %s\n",
+				poptBadOption(optCon, 0), poptStrerror(opt));
+			poptPrintHelp(optCon, stderr, 0);
+			exit(1);
+		}
+	}
+	if ((clients < 1) || (clients > PICO_MAX_NUM_ENGINES)) {
+		fprintf(stderr, "Number of clients must be between 1 and %i\n", PICO_MAX_NUM_ENGINES);
+		exit(1);
+	}
+	if (clientTimeout < 0) {
+		fprintf(stderr, "Invalid option --timeout: %i\n", clientTimeout);
+		exit(1);
+	}
+	if (strlen(socketPath) >= sizeof(addr.sun_path)) {
+		fprintf(stderr, "Socket path too long: %s\n", socketPath);
+		exit(1);
+	}
+	poptFreeContext(optCon);
+
+    /* the signals that stop the daemon are only taken by sigwait below;
+       clients closing their connection early must not kill it */
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    /* engines are created and disposed for every request, so keep the
+       allocation cost independent of the fragmentation of the memory; the
+       memory is extended from the heap should it not suffice */
+    memSize = PICO_MEM_SIZE + clients * PICO_ENGINE_MEM_SIZE;
+    picoMemArea = malloc(memSize);
+    if ((ret = pico_initializeEx(picoMemArea, memSize, PICO_MEM_SIZE_CLASSES | PICO_MEM_GROW, &picoSystem))) {
+        pico_getSystemStatusMessage(picoSystem, ret, outMessage);
+        fprintf(stderr, "Cannot initialize pico (%i): %s\n", ret, outMessage);
+        picoSystem = NULL;
+        goto terminate;
+    }
+    for (lang = 0; lang < PICO_NUM_SUPPORTED_VOCS; lang++) {
+        numVoices += !loadVoice(lang);
+    }
+    if (0 == numVoices) {
+        ret = 1;
+        goto unloadVoices;
+    }
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socketPath);
+    unlink(socketPath);
+    if ((listenFd < 0) || bind(listenFd, (struct sockaddr *) &addr, sizeof(addr))
+        || listen(listenFd, SOMAXCONN)) {
+        perror(socketPath);
+        ret = 1;
+        goto closeSocket;
+    }
+
+    /* each worker serves one client at a time with an engine of its own */
+    for (i = 0; i < clients; i++) {
+        worker_thread[i] = picoos_startThread(pico_sysGetCommon(picoSystem)->mm, worker, NULL);
+        if (NULL == worker_thread[i]) {
+            fprintf(stderr, "Cannot start worker thread\n");
+            clients = i;
+            break;
+        }
+    }
+    ret = (clients > 0) ? 0 : 1;
+    if (0 == ret) {
+        sigwait(&signals, &sig);
+    }
+
+    /* let the workers finish their current requests */
+    shutdown(listenFd, SHUT_RDWR);
+    for (i = 0; i < clients; i++) {
+        picoos_joinThread(pico_sysGetCommon(picoSystem)->mm, &worker_thread[i]);
+    }
+    unlink(socketPath);
+
+closeSocket:
+    if (listenFd >= 0) {
+        close(listenFd);
+    }
+unloadVoices:
+    for (lang = 0; lang < PICO_NUM_SUPPORTED_VOCS; lang++) {
+        unloadVoice(lang);
+    }
+terminate:
+    if (picoSystem) {
+        pico_terminate(&picoSystem);
+    }
+    free(picoMemArea);
+    exit(ret);
+}
@@ -0,0 +1,86 @@
+/* picottsd.h
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *   Definitions shared by the synthesis daemon picottsd and its client
+ *   mode in pico2wave.
+ *
+ *   Protocol: the client connects to the daemon's Unix domain socket and
+ *   sends a request header of "key=value" lines, terminated by an empty
+ *   line, followed by the UTF-8 text; the end of the text is signalled by
+ *   shutting down the client's sending direction. Keys are "lang" (default
+ *   en-US) and "rate", "pitch" and "volume" (in percent, default 100).
+ *   The daemon answers with one status line, "OK" or "ERR <message>",
+ *   followed on success by the speech as raw 16 kHz 16 bit little endian
+ *   mono PCM, sent as soon as it is synthesized, and closes the connection
+ *   at the end.
+ */
+
+#ifndef PICOTTSD_H_
+#define PICOTTSD_H_
+
+#include <stdio.h>
+#include <string.h>
+
+#define PICOTTSD_SOCKET             "/tmp/picottsd.socket"
+
+/* maximum length of a header or status line, incl. the newline */
+#define PICOTTSD_MAX_LINE_LEN       128
+
+/* valid ranges of the prosody parameters (as in the Android TTS service) */
+#define PICOTTSD_MIN_RATE           20
+#define PICOTTSD_MAX_RATE           500
+#define PICOTTSD_MIN_PITCH          50
+#define PICOTTSD_MAX_PITCH          200
+#define PICOTTSD_MIN_VOLUME         0
+#define PICOTTSD_MAX_VOLUME         500
+
+/* Pico markup for the prosody parameters */
+#define PICO_SPEED_OPEN_TAG         "<speed level='%d'>"
+#define PICO_SPEED_CLOSE_TAG        "</speed>"
+#define PICO_PITCH_OPEN_TAG         "<pitch level='%d'>"
+#define PICO_PITCH_CLOSE_TAG        "</pitch>"
+#define PICO_VOLUME_OPEN_TAG        "<volume level='%d'>"
+#define PICO_VOLUME_CLOSE_TAG       "</volume>"
+
+/* size of the buffers for formatMarkup */
+#define PICO_MARKUP_SIZE            80
+
+/* writes the markup to be put before ('open') and after ('close') a text
+   to apply the given rate, pitch and volume; parameters at their default
+   of 100 percent need no markup */
+static void formatMarkup(int rate, int pitch, int volume,
+                         char open[PICO_MARKUP_SIZE], char close[PICO_MARKUP_SIZE])
+{
+    size_t len = 0;
+
+    open[0] = close[0] = '\0';
+    if (rate != 100) {
+        len += snprintf(open + len, PICO_MARKUP_SIZE - len, PICO_SPEED_OPEN_TAG, rate);
+    }
+    if (pitch != 100) {
+        len += snprintf(open + len, PICO_MARKUP_SIZE - len, PICO_PITCH_OPEN_TAG, pitch);
+    }
+    if (volume != 100) {
+        snprintf(open + len, PICO_MARKUP_SIZE - len, PICO_VOLUME_OPEN_TAG, volume);
+        strcat(close, PICO_VOLUME_CLOSE_TAG);
+    }
+    if (pitch != 100) {
+        strcat(close, PICO_PITCH_CLOSE_TAG);
+    }
+    if (rate != 100) {
+        strcat(close, PICO_SPEED_CLOSE_TAG);
+    }
+}
+
+#endif /* PICOTTSD_H_ */
@@ -253,16 +253,22 @@ static pico_status_t acphInitialize(register picodata_ProcessingUnit this, picoo
 #endif
 
 
-    /* kb dtphr */
-    acph->dtphr = picokdt_getDtPHR(this->voice->kbArray[PICOKNOW_KBID_DT_PHR]);
+    /* kb dtphr (private copy, the kb may be shared with other engines) */
+    if (acph->dtphr == NULL) {
+        acph->dtphr = picokdt_newDtPHR(this->common->mm,
+                this->voice->kbArray[PICOKNOW_KBID_DT_PHR]);
+    }
     if (acph->dtphr == NULL) {
         return picoos_emRaiseException(this->common->em, PICO_EXC_KB_MISSING,
                                        NULL, NULL);
     }
     PICODBG_DEBUG(("got dtphr"));
 
-    /* kb dtacc */
-    acph->dtacc = picokdt_getDtACC(this->voice->kbArray[PICOKNOW_KBID_DT_ACC]);
+    /* kb dtacc (private copy) */
+    if (acph->dtacc == NULL) {
+        acph->dtacc = picokdt_newDtACC(this->common->mm,
+                this->voice->kbArray[PICOKNOW_KBID_DT_ACC]);
+    }
     if (acph->dtacc == NULL) {
         return picoos_emRaiseException(this->common->em, PICO_EXC_KB_MISSING,
                                        NULL, NULL);
@@ -285,6 +291,9 @@ static pico_status_t acphSubObjDeallocate(register picodata_ProcessingUnit this,
                                         picoos_MemoryManager mm) {
     mm = mm;        /* avoid warning "var not used in this function"*/
     if (NULL != this) {
+        acph_subobj_t * acph = (acph_subobj_t *) this->subObj;
+        picokdt_disposeDt(this->common->mm, (void *) &acph->dtphr);
+        picokdt_disposeDt(this->common->mm, (void *) &acph->dtacc);
         picoos_deallocate(this->common->mm, (void *) &this->subObj);
     }
     return PICO_OK;
@@ -314,6 +323,8 @@ picodata_ProcessingUnit picoacph_newAccPhrUnit(picoos_MemoryManager mm,
         picoos_emRaiseException(common->em, PICO_EXC_OUT_OF_MEM, NULL, NULL);
         return NULL;
     }
+    ((acph_subobj_t *) this->subObj)->dtphr = NULL;
+    ((acph_subobj_t *) this->subObj)->dtacc = NULL;
 
     acphInitialize(this, PICO_RESET_FULL);
     return this;
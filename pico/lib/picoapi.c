@@ -73,6 +73,7 @@ pico_Status pico_initialize_priv(
         void *memory,
         const pico_Uint32 size,
         pico_Int16 enableMemProt,
+        pico_Int32 memMode,
         pico_System *system
         )
 {
@@ -86,6 +87,9 @@ pico_Status pico_initialize_priv(
         status = PICO_ERR_NULLPTR_ACCESS;
     } else if (size == 0) {
         status = PICO_ERR_INVALID_ARGUMENT;
+    } else if (((memMode & ~PICO_MEM_GROW) != PICO_MEM_FIRST_FIT)
+            && ((memMode & ~PICO_MEM_GROW) != PICO_MEM_SIZE_CLASSES)) {
+        status = PICO_ERR_INVALID_ARGUMENT;
     } else if (system == NULL) {
         status = PICO_ERR_NULLPTR_ACCESS;
     } else {
@@ -98,15 +102,21 @@ pico_Status pico_initialize_priv(
         sys = (pico_System) picoos_raw_malloc(memory, size, sizeof(pico_system_t),
                 &rest_mem, &rest_mem_size);
         if (sys != NULL) {
-            sysMM = picoos_newMemoryManager(rest_mem, rest_mem_size, enableMemProt ? TRUE : FALSE);
+            sysMM = picoos_newMemoryManagerEx(rest_mem, rest_mem_size, enableMemProt ? TRUE : FALSE,
+                    (((memMode & ~PICO_MEM_GROW) == PICO_MEM_SIZE_CLASSES) ? PICOOS_MEM_SIZE_CLASSES : PICOOS_MEM_FIRST_FIT)
+                    | ((memMode & PICO_MEM_GROW) ? PICOOS_MEM_GROW : 0));
             if (sysMM != NULL) {
+                /* engines may be created and disposed from different threads */
+                picoos_enableMemLock(sysMM);
                 sysEM = picoos_newExceptionManager(sysMM);
                 sys->common = picoos_newCommon(sysMM);
                 sys->rm = picorsrc_newResourceManager(sysMM, sys->common);
                 if ((sysEM != NULL) && (sys->common != NULL) && (sys->rm != NULL)) {
                     sys->common->em = sysEM;
                     sys->common->mm = sysMM;
-                    sys->engine = NULL;
+                    sys->numEngines = 0;
+                    sys->lock = picoos_newMutex(sysMM);
+                    picoos_emEnableLock(sysEM, sysMM);
 
                     picorsrc_createDefaultResource(sys->rm /*,&defaultResource */);
 
@@ -148,7 +158,28 @@ PICO_FUNC pico_initialize(
         pico_System *system
         )
 {
-    return pico_initialize_priv(memory, size, /*enableMemProt*/ FALSE, system);
+    return pico_initialize_priv(memory, size, /*enableMemProt*/ FALSE, PICO_MEM_FIRST_FIT, system);
+}
+
+/**
+ * pico_initializeEx : initializes the pico system private memory with the given memory management
+ * @param    memory : pointer to a free and already allocated memory area
+ * @param    size : size of the memory area
+ * @param    memMode : PICO_MEM_FIRST_FIT or PICO_MEM_SIZE_CLASSES, optionally combined with PICO_MEM_GROW
+ * @param    system : pointer to a pico_System struct
+ * @return  PICO_OK : successful init, !PICO_OK : error on allocating private memory
+ * @return  PICO_ERR_INVALID_ARGUMENT : unknown memory mode
+ * @callgraph
+ * @callergraph
+*/
+PICO_FUNC pico_initializeEx(
+        void *memory,
+        const pico_Uint32 size,
+        const pico_Int32 memMode,
+        pico_System *system
+        )
+{
+    return pico_initialize_priv(memory, size, /*enableMemProt*/ FALSE, memMode, system);
 }
 
 /**
@@ -168,15 +199,23 @@ PICO_FUNC pico_terminate(
         status = PICO_ERR_INVALID_HANDLE;
     } else {
         pico_System sys = *system;
+        picoos_MemoryManager sysMM = sys->common->mm;
 
         /* close engine(s) */
-        picoctrl_disposeEngine(sys->common->mm, sys->rm, &sys->engine);
+        while (sys->numEngines > 0) {
+            sys->numEngines--;
+            picoctrl_disposeEngine(sysMM, sys->rm, &sys->engine[sys->numEngines]);
+        }
 
         /* close all resources */
-        picorsrc_disposeResourceManager(sys->common->mm, &sys->rm);
+        picorsrc_disposeResourceManager(sysMM, &sys->rm);
 
+        picoos_disposeMutex(sysMM, &sys->lock);
+        picoos_disposeExceptionManager(sysMM, &sys->common->em);
         sys->magic ^= 0xFFFEFDFC;
         *system = NULL;
+        /* last: releases the memory blocks added by PICO_MEM_GROW */
+        picoos_disposeMemoryManager(&sysMM);
     }
 
     PICODBG_TERMINATE();
@@ -315,6 +354,27 @@ PICO_FUNC pico_loadResource(
         const pico_Char *lingwareFileName,
         pico_Resource *outLingware
         )
+{
+    return pico_loadResourceEx(system, lingwareFileName, PICO_LOAD_COPY, outLingware);
+}
+
+/**
+ * pico_loadResourceEx : Loads a resource file into the Pico system, either by copying or by mapping it
+ * @param    system : pointer to a pico_System struct
+ * @param    *lingwareFileName : lingware resource file name
+ * @param    loadMode : PICO_LOAD_COPY or PICO_LOAD_MAP
+ * @param    *outLingware : pointer to receive the loaded lingware resource memory area address
+ * @return  PICO_OK : successful
+ * @return     PICO_ERR_INVALID_HANDLE, PICO_ERR_NULLPTR_ACCESS, PICO_ERR_INVALID_ARGUMENT : errors
+ * @callgraph
+ * @callergraph
+*/
+PICO_FUNC pico_loadResourceEx(
+        pico_System system,
+        const pico_Char *lingwareFileName,
+        const pico_Int32 loadMode,
+        pico_Resource *outLingware
+        )
 {
     pico_Status status = PICO_OK;
 
@@ -322,11 +382,13 @@ PICO_FUNC pico_loadResource(
         status = PICO_ERR_INVALID_HANDLE;
     } else if ((lingwareFileName == NULL) || (outLingware == NULL)) {
         status = PICO_ERR_NULLPTR_ACCESS;
+    } else if ((loadMode != PICO_LOAD_COPY) && (loadMode != PICO_LOAD_MAP)) {
+        status = PICO_ERR_INVALID_ARGUMENT;
     } else {
         PICODBG_DEBUG(("memory usage before resource loading"));
         picoos_showMemUsage(system->common->mm, FALSE, TRUE);
         picoos_emReset(system->common->em);
-        status = picorsrc_loadResource(system->rm, (picoos_char *) lingwareFileName, (picorsrc_Resource *) outLingware);
+        status = picorsrc_loadResource(system->rm, (picoos_char *) lingwareFileName, loadMode, (picorsrc_Resource *) outLingware);
         PICODBG_DEBUG(("memory used to load resource %s", lingwareFileName));
         picoos_showMemUsage(system->common->mm, TRUE, FALSE);
     }
@@ -510,6 +572,28 @@ PICO_FUNC pico_newEngine(
         const pico_Char *voiceName,
         pico_Engine *outEngine
         )
+{
+    return pico_newEngineEx(system, voiceName, PICO_ENGINE_SERIAL, outEngine);
+}
+
+/**
+ * pico_newEngineEx : Creates and initializes a new Pico engine, optionally pipelined
+ * @param    system : pointer to a pico_System struct
+ * @param    *voiceName : pointer to the area containing the voice definition
+ * @param    engineMode : PICO_ENGINE_SERIAL or PICO_ENGINE_PIPELINED,
+ *             possibly or'ed with PICO_ENGINE_LOW_LATENCY and PICO_ENGINE_CEP_LOOKAHEAD
+ * @param    *outEngine : pointer to the Pico engine handle
+ * @return  PICO_OK : successful
+ * @return     PICO_ERR_INVALID_HANDLE, PICO_ERR_NULLPTR_ACCESS, PICO_ERR_INVALID_ARGUMENT : errors
+ * @callgraph
+ * @callergraph
+*/
+PICO_FUNC pico_newEngineEx(
+        pico_System system,
+        const pico_Char *voiceName,
+        const pico_Int32 engineMode,
+        pico_Engine *outEngine
+        )
 {
     pico_Status status = PICO_OK;
 
@@ -521,21 +605,42 @@ PICO_FUNC pico_newEngine(
         status = PICO_ERR_NULLPTR_ACCESS;
     } else if (picoos_strlen((picoos_char *) voiceName) == 0) {
         status = PICO_ERR_INVALID_ARGUMENT;
+    } else if (((engineMode & ~(PICO_ENGINE_LOW_LATENCY | PICO_ENGINE_CEP_LOOKAHEAD_MASK)) != PICO_ENGINE_SERIAL)
+            && ((engineMode & ~(PICO_ENGINE_LOW_LATENCY | PICO_ENGINE_CEP_LOOKAHEAD_MASK)) != PICO_ENGINE_PIPELINED)) {
+        status = PICO_ERR_INVALID_ARGUMENT;
     } else if (outEngine == NULL) {
         status = PICO_ERR_NULLPTR_ACCESS;
     } else {
         picoos_emReset(system->common->em);
-        if (system->engine == NULL) {
-            *outEngine = (pico_Engine) picoctrl_newEngine(system->common->mm, system->rm, voiceName);
+        /* the engine is created outside the lock, so that several threads
+           may create engines concurrently; the table is checked again when
+           the engine is entered */
+        picoos_lockMutex(system->lock);
+        if (system->numEngines >= PICO_MAX_NUM_ENGINES) {
+            status = PICO_EXC_MAX_NUM_EXCEED;
+        }
+        picoos_unlockMutex(system->lock);
+        if (status == PICO_OK) {
+            *outEngine = (pico_Engine) picoctrl_newEngine(system->common->mm, system->rm, voiceName, engineMode);
             if (*outEngine != NULL) {
-                system->engine = (picoctrl_Engine) *outEngine;
+                picoos_lockMutex(system->lock);
+                if (system->numEngines < PICO_MAX_NUM_ENGINES) {
+                    system->engine[system->numEngines++] = (picoctrl_Engine) *outEngine;
+                } else {
+                    status = PICO_EXC_MAX_NUM_EXCEED;
+                }
+                picoos_unlockMutex(system->lock);
+                if (status != PICO_OK) {
+                    picoctrl_disposeEngine(system->common->mm, system->rm, (picoctrl_Engine *) outEngine);
+                }
             } else {
                 status = picoos_emRaiseException(system->common->em, PICO_EXC_OUT_OF_MEM,
                             (picoos_char *) "out of memory creating new engine", NULL);
             }
-        } else {
+        }
+        if (status == PICO_EXC_MAX_NUM_EXCEED) {
             status = picoos_emRaiseException(system->common->em, PICO_EXC_MAX_NUM_EXCEED,
-                        NULL, (picoos_char *) "no more than %i engines", 1);
+                        NULL, (picoos_char *) "no more than %i engines", PICO_MAX_NUM_ENGINES);
         }
     }
 
@@ -557,6 +662,7 @@ PICO_FUNC pico_disposeEngine(
         )
 {
     pico_Status status = PICO_OK;
+    picoos_uint16 i = 0;
 
     if (!is_valid_system_handle(system)) {
         status = PICO_ERR_INVALID_HANDLE;
@@ -565,9 +671,23 @@ PICO_FUNC pico_disposeEngine(
     } else if (!picoctrl_isValidEngineHandle(*((picoctrl_Engine *) inoutEngine))) {
         status = PICO_ERR_INVALID_HANDLE;
     } else {
+        /* the engine must belong to this system */
+        picoos_lockMutex(system->lock);
+        while ((i < system->numEngines) && (system->engine[i] != (picoctrl_Engine) *inoutEngine)) {
+            i++;
+        }
+        if (i < system->numEngines) {
+            system->numEngines--;
+            system->engine[i] = system->engine[system->numEngines];
+            system->engine[system->numEngines] = NULL;
+        } else {
+            status = PICO_ERR_INVALID_HANDLE;
+        }
+        picoos_unlockMutex(system->lock);
+    }
+    if (status == PICO_OK) {
         picoos_emReset(system->common->em);
         picoctrl_disposeEngine(system->common->mm, system->rm, (picoctrl_Engine *) inoutEngine);
-        system->engine = NULL;
         status = picoos_emGetExceptionCode(system->common->em);
     }
 
@@ -596,6 +716,35 @@ PICO_FUNC pico_putTextUtf8(
         const pico_Char *text,
         const pico_Int16 textSize,
         pico_Int16 *bytesPut)
+{
+    pico_Status status;
+    pico_Int32 put = 0;
+
+    if (bytesPut == NULL) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+    status = pico_putTextUtf8Ex(engine, text, textSize, &put);
+    *bytesPut = (pico_Int16) put;
+
+    return status;
+}
+
+/**
+ * pico_putTextUtf8Ex : Puts UTF8 text into Pico text input buffer (32 bit sizes)
+ * @param    engine : pointer to a Pico engine handle
+ * @param    *text : pointer to the text buffer
+ * @param    textSize : text buffer size
+ * @param    *bytesPut : pointer to variable to receive the number of bytes put
+ * @return  PICO_OK : successful
+ * @return     PICO_ERR_INVALID_HANDLE, PICO_ERR_NULLPTR_ACCESS : errors
+ * @callgraph
+ * @callergraph
+ */
+PICO_FUNC pico_putTextUtf8Ex(
+        pico_Engine engine,
+        const pico_Char *text,
+        const pico_Int32 textSize,
+        pico_Int32 *bytesPut)
 {
     pico_Status status = PICO_OK;
 
@@ -634,12 +783,44 @@ PICO_FUNC pico_getData(
         pico_Int16 *bytesReceived,
         pico_Int16 *outDataType
         )
+{
+    pico_Status status;
+    pico_Int32 received = 0;
+
+    if (bytesReceived == NULL) {
+        return PICO_STEP_ERROR;
+    }
+    status = pico_getDataEx(engine, buffer, bufferSize, &received, outDataType);
+    *bytesReceived = (pico_Int16) received;
+
+    return status;
+}
+
+/**
+ * pico_getDataEx : Gets speech data from the engine (32 bit sizes).
+ * @param    engine : pointer to a Pico engine handle
+ * @param    *buffer : pointer to output buffer
+ * @param    bufferSize : out buffer size
+ * @param    *bytesReceived : pointer to a variable to receive the number of bytes received
+ * @param    *outDataType : pointer to a variable to receive the type of buffer received
+ * @return  PICO_OK : successful
+ * @return     PICO_ERR_INVALID_HANDLE, PICO_ERR_NULLPTR_ACCESS : errors
+ * @callgraph
+ * @callergraph
+*/
+PICO_FUNC pico_getDataEx(
+        pico_Engine engine,
+        void *buffer,
+        const pico_Int32 bufferSize,
+        pico_Int32 *bytesReceived,
+        pico_Int16 *outDataType
+        )
 {
     pico_Status status = PICO_OK;
 
     if (!picoctrl_isValidEngineHandle((picoctrl_Engine) engine)) {
         status = PICO_STEP_ERROR;
-    } else if (buffer == NULL) {
+    } else if ((buffer == NULL) && (bufferSize != 0)) {
         status = PICO_STEP_ERROR;
     } else if (bufferSize < 0) {
         status = PICO_STEP_ERROR;
@@ -648,7 +829,10 @@ PICO_FUNC pico_getData(
     } else {
         picoctrl_engResetExceptionManager((picoctrl_Engine) engine);
         status = picoctrl_engFetchOutputItemBytes((picoctrl_Engine) engine, (picoos_char *)buffer, bufferSize, bytesReceived);
-        if ((status != PICO_STEP_IDLE) && (status != PICO_STEP_BUSY)) {
+        if (status == PICO_WARN_CANCELLED) {
+            /* all input discarded */
+            status = PICO_STEP_IDLE;
+        } else if ((status != PICO_STEP_IDLE) && (status != PICO_STEP_BUSY)) {
             status = PICO_STEP_ERROR;
         }
     }
@@ -657,6 +841,189 @@ PICO_FUNC pico_getData(
     return status;
 }
 
+/**
+ * pico_setSpeechCallback : Sets a callback receiving the speech data directly
+ * @param    engine : pointer to a Pico engine handle
+ * @param    callback : the callback, or NULL to get speech data with pico_getData again
+ * @param    userData : passed on to the callback
+ * @return  PICO_OK : successful
+ * @return     PICO_ERR_INVALID_HANDLE : errors
+ * @callgraph
+ * @callergraph
+*/
+PICO_FUNC pico_setSpeechCallback(
+        pico_Engine engine,
+        pico_SpeechCallback callback,
+        void *userData)
+{
+    if (!picoctrl_isValidEngineHandle((picoctrl_Engine) engine)) {
+        return PICO_ERR_INVALID_HANDLE;
+    }
+    /* pico_Int16/pico_Uint16 are the same types as picoos_int16/picoos_uint16 */
+    return picoctrl_engSetSpeechSink((picoctrl_Engine) engine,
+            (picoctrl_SpeechSink) callback, userData);
+}
+
+/* number of samples passed to a pico_SynthesisCallback at once */
+#define PICO_SYNTH_BLOCK_SAMPLES 2048
+
+/* state of pico_synthesize, shared with its engine sinks */
+typedef struct {
+    pico_SynthesisCallback callback;
+    void *userData;
+    pico_Status status;             /* first status other than PICO_OK returned by callback */
+    picoos_int16 *block;            /* samples not yet passed to callback */
+    picoos_uint16 numSamples;
+} synth_state_t;
+
+static void synthFlush(synth_state_t *s)
+{
+    if ((s->numSamples > 0) && (PICO_OK == s->status)) {
+        s->status = s->callback(s->userData, PICO_EVENT_AUDIO, s->block, s->numSamples, NULL);
+    }
+    s->numSamples = 0;
+}
+
+static void synthSpeech(void *userData, const picoos_int16 *samples, picoos_uint16 numSamples)
+{
+    synth_state_t *s = (synth_state_t *) userData;
+    picoos_uint16 n;
+
+    while ((numSamples > 0) && (PICO_OK == s->status)) {
+        n = PICO_SYNTH_BLOCK_SAMPLES - s->numSamples;
+        if (n > numSamples) {
+            n = numSamples;
+        }
+        picoos_mem_copy(samples, s->block + s->numSamples, n * sizeof(picoos_int16));
+        s->numSamples += n;
+        samples += n;
+        numSamples -= n;
+        if (PICO_SYNTH_BLOCK_SAMPLES == s->numSamples) {
+            synthFlush(s);
+        }
+    }
+}
+
+static void synthEvent(void *userData, picoos_uint8 event, const picoos_char *name)
+{
+    synth_state_t *s = (synth_state_t *) userData;
+
+    /* the speech before the event first */
+    synthFlush(s);
+    if (PICO_OK == s->status) {
+        s->status = s->callback(s->userData,
+                (PICOCTRL_EVENT_MARK == event) ? PICO_EVENT_MARK : PICO_EVENT_SENTENCE,
+                NULL, 0, (const pico_Char *) name);
+    }
+}
+
+/**
+ * pico_synthesize : Synthesizes a text, passing the speech to a callback
+ * @param    engine : pointer to a Pico engine handle
+ * @param    text : the text
+ * @param    textSize : size of the text in bytes
+ * @param    callback : receives the speech and the events
+ * @param    userData : passed on to the callback
+ * @return  PICO_OK : successful
+ * @return  status returned by the callback, if other than PICO_OK
+ * @return  PICO_WARN_CANCELLED : cancelled by pico_cancelEngine
+ * @return     PICO_ERR_INVALID_HANDLE, PICO_ERR_NULLPTR_ACCESS, PICO_ERR_INVALID_ARGUMENT : errors
+ * @callgraph
+ * @callergraph
+*/
+PICO_FUNC pico_synthesize(
+        pico_Engine engine,
+        const pico_Char *text,
+        const pico_Int32 textSize,
+        pico_SynthesisCallback callback,
+        void *userData)
+{
+    picoctrl_Engine eng = (picoctrl_Engine) engine;
+    picoos_Common common;
+    synth_state_t s;
+    picoctrl_SpeechSink prevSpeechSink;
+    picoctrl_EventSink prevEventSink;
+    void *prevSpeechSinkData, *prevEventSinkData;
+    /* on the stack: the engine memory is sized for the PUs only */
+    picoos_int16 block[PICO_SYNTH_BLOCK_SAMPLES];
+    picoos_char terminator = '\0';
+    picoos_int32 pos, bytesPut, received;
+    pico_Status status = PICO_OK;
+    picodata_step_result_t stepResult;
+
+    if (!picoctrl_isValidEngineHandle(eng)) {
+        return PICO_ERR_INVALID_HANDLE;
+    } else if (((text == NULL) && (textSize > 0)) || (callback == NULL)) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    } else if (textSize < 0) {
+        return PICO_ERR_INVALID_ARGUMENT;
+    }
+    picoctrl_engResetExceptionManager(eng);
+    common = picoctrl_engGetCommon(eng);
+
+    s.callback = callback;
+    s.userData = userData;
+    s.status = PICO_OK;
+    s.numSamples = 0;
+    s.block = block;
+    /* the sinks of pico_setSpeechCallback are restored at the end */
+    picoctrl_engGetSpeechSink(eng, &prevSpeechSink, &prevSpeechSinkData);
+    picoctrl_engGetEventSink(eng, &prevEventSink, &prevEventSinkData);
+    picoctrl_engSetSpeechSink(eng, synthSpeech, &s);
+    picoctrl_engSetEventSink(eng, synthEvent, &s);
+
+    /* the text, followed by a terminating zero that flushes the engine */
+    pos = 0;
+    while ((PICO_OK == status) && (PICO_OK == s.status) && (pos <= textSize)) {
+        if (pos < textSize) {
+            picoctrl_engFeedText(eng, (picoos_char *) text + pos, textSize - pos, &bytesPut);
+        } else {
+            picoctrl_engFeedText(eng, &terminator, 1, &bytesPut);
+        }
+        pos += bytesPut;
+        do {
+            stepResult = picoctrl_engFetchOutputItemBytes(eng, NULL, 0, &received);
+        } while ((PICO_STEP_BUSY == stepResult) && (PICO_OK == s.status));
+        if (PICO_STEP_ERROR == stepResult) {
+            status = picoos_emGetExceptionCode(common->em);
+            if (PICO_OK == status) {
+                status = PICO_ERR_OTHER;
+            }
+        } else if (PICO_WARN_CANCELLED == stepResult) {
+            /* everything discarded, including the samples not yet passed on */
+            status = PICO_WARN_CANCELLED;
+            s.numSamples = 0;
+        }
+    }
+    synthFlush(&s);
+    if ((PICO_OK == status) && (PICO_OK != s.status)) {
+        /* stopped by the callback: discard the rest */
+        picoctrl_engReset(eng, PICO_RESET_SOFT);
+        status = s.status;
+    }
+
+    picoctrl_engSetEventSink(eng, prevEventSink, prevEventSinkData);
+    picoctrl_engSetSpeechSink(eng, prevSpeechSink, prevSpeechSinkData);
+    return status;
+}
+
+/**
+ * pico_cancelEngine : Cancels the synthesis of the current text
+ * @param    engine : pointer to a Pico engine handle
+ * @return  PICO_OK : successful
+ * @return     PICO_ERR_INVALID_HANDLE : errors
+ * @callgraph
+ * @callergraph
+*/
+PICO_FUNC pico_cancelEngine(
+        pico_Engine engine)
+{
+    if (!picoctrl_isValidEngineHandle((picoctrl_Engine) engine)) {
+        return PICO_ERR_INVALID_HANDLE;
+    }
+    return picoctrl_engCancel((picoctrl_Engine) engine);
+}
+
 /**
  * pico_resetEngine : Resets the engine
  * @param    engine : pointer to a Pico engine handle
@@ -38,13 +38,19 @@ The SVOX Pico 'system' is the entity that manages data common to all
 SVOX Pico engines, e.g. linguistic data needed to do text-to-speech
 (TTS) synthesis, license key, etc.  All API functions on the Pico
 system level take a 'pico_System' handle as the first parameter.
+Resource loading and unloading, voice definition and engine creation
+and disposal may be called from several threads concurrently; the
+system status and warning messages are then only meaningful if these
+calls do not overlap.
 
 @e SVOX_Pico_Engine
 
 A SVOX Pico 'engine' provides the functions needed to perform actual
-synthesis. Currently there can be only one engine instance at a time
-(concurrent engines will be possible in the future). All API functions
-at the engine level take a 'pico_Engine' handle as the first
+synthesis. A system may host up to PICO_MAX_NUM_ENGINES engines at a
+time, each with its own processing state and working memory, while
+the loaded resources are shared read-only between them. Different
+engines may be used concurrently from different threads. All API
+functions at the engine level take a 'pico_Engine' handle as the first
 parameter.
 
 @e SVOX_Pico_Resource
@@ -212,6 +218,27 @@ PICO_FUNC pico_initialize(
         pico_System *outSystem
         );
 
+/**
+   Same as pico_initialize, but with an explicit 'memMode' selecting how
+   the memory area is managed. PICO_MEM_FIRST_FIT is the default.
+   PICO_MEM_SIZE_CLASSES keeps free memory sorted by size, so that
+   allocations and releases take constant time however fragmented the
+   area is; it is meant for applications that create and dispose
+   engines frequently. Each engine always occupies a single block of
+   the memory area, within which its own objects are allocated stack-wise.
+   With PICO_MEM_GROW added to either mode, Pico allocates further memory
+   blocks from the heap when 'memory' is exhausted, instead of failing
+   with PICO_EXC_OUT_OF_MEM; they are released by pico_terminate. This
+   allows starting with a small memory area, see also
+   picoext_getSystemMemHighWater.
+*/
+PICO_FUNC pico_initializeEx(
+        void *memory,
+        const pico_Uint32 size,
+        const pico_Int32 memMode,
+        pico_System *outSystem
+        );
+
 /**
    Terminates the Pico system. Lingware resources still being loaded
    are unloaded automatically. The memory area provided to Pico in
@@ -269,9 +296,8 @@ PICO_FUNC pico_getSystemWarning(
    Loads a resource file into the Pico system. The number of resource
    files loaded in parallel is limited by PICO_MAX_NUM_RESOURCES.
    Loading of a resource file may be done at any time (even in
-   parallel to a running engine doing TTS synthesis), but with the
-   general restriction that functions taking a system handle as their
-   first argument must be called in a mutually exclusive fashion. The
+   parallel to a running engine doing TTS synthesis, and in parallel
+   to the creation of engines in other threads). The
    loaded resource will be available only to engines started after the
    resource is fully loaded, i.e., not to engines currently
    running.
@@ -282,6 +308,24 @@ PICO_FUNC pico_loadResource(
         pico_Resource *outResource
         );
 
+/**
+   Same as pico_loadResource, but with an explicit 'loadMode'. With
+   PICO_LOAD_COPY the resource content is read into the memory area
+   passed to pico_initialize. With PICO_LOAD_MAP the knowledge bases
+   are used directly from a read-only, shared mapping of the file; the
+   content then does not count against the Pico memory area, and
+   several processes loading the same file share its physical pages.
+   If the file cannot be mapped, the resource is loaded as with
+   PICO_LOAD_COPY and PICO_WARN_FALLBACK is added to the system
+   warnings.
+*/
+PICO_FUNC pico_loadResourceEx(
+        pico_System system,
+        const pico_Char *resourceFileName,
+        const pico_Int32 loadMode,
+        pico_Resource *outResource
+        );
+
 /**
    Unloads a resource file from the Pico system. If no engine uses the
    resource file, the resource is removed immediately and its
@@ -345,8 +389,10 @@ PICO_FUNC pico_releaseVoiceDefinition(
 
 /**
    Creates and initializes a new Pico engine instance and returns its
-   handle in 'outEngine'. Only one instance per system is currently
-   possible.
+   handle in 'outEngine'. Up to PICO_MAX_NUM_ENGINES instances per
+   system are possible; engines created for the same voice share its
+   knowledge bases. Each engine allocates its working memory from the
+   memory area passed to pico_initialize.
 */
 PICO_FUNC pico_newEngine(
         pico_System system,
@@ -354,6 +400,40 @@ PICO_FUNC pico_newEngine(
         pico_Engine *outEngine
         );
 
+/**
+   Same as pico_newEngine, but with an explicit 'engineMode'. With
+   PICO_ENGINE_SERIAL all processing is done by pico_getData in the
+   caller's thread. With PICO_ENGINE_PIPELINED the engine runs text
+   analysis in a thread of its own, while pico_getData performs signal
+   generation; on multi-core machines this reduces the time needed for
+   long texts. In this mode pico_getData may block until text analysis
+   has produced data, and pico_putTextUtf8 and pico_getData must not be
+   called concurrently for the same engine (as with serial engines).
+   The synthesized output is identical in both modes. If the platform
+   does not support threads, or the compiler offers no atomic memory
+   access (see PICOPAL_HAVE_ATOMICS in picopal.h), the engine falls back
+   to PICO_ENGINE_SERIAL.
+   Either mode may be or'ed with PICO_ENGINE_LOW_LATENCY, which minimizes
+   the time from feeding the text of an utterance to the first speech
+   data: the first phrase is cut after a few words, and it is processed
+   through to the signal generation before the rest of the text is
+   analyzed. The output then differs slightly in prosody. The time to
+   first sample is reported by picoext_getEngineTimeToFirstSample in
+   every mode.
+   PICO_ENGINE_CEP_LOOKAHEAD(frames) may be or'ed as well: parameter
+   generation then smoothes each sentence in overlapping windows that look
+   'frames' frames ahead, so that long sentences start speaking earlier.
+   With 25 frames (100 ms) the pitch deviates from the default by a few
+   cents on average; the parameter generation then needs about three times
+   the computation of the default.
+*/
+PICO_FUNC pico_newEngineEx(
+        pico_System system,
+        const pico_Char *voiceName,
+        const pico_Int32 engineMode,
+        pico_Engine *outEngine
+        );
+
 
 /**
  Disposes a Pico engine and releases all memory it occupied. The
@@ -392,16 +472,31 @@ PICO_FUNC pico_putTextUtf8(
         pico_Int16 *outBytesPut
         );
 
+/**
+   Same as pico_putTextUtf8, but with 32 bit sizes, so that texts of
+   any length can be passed in one call. The engine still only takes
+   as much text as fits into its input buffer; 'outBytesPut' tells how
+   much that was.
+*/
+PICO_FUNC pico_putTextUtf8Ex(
+        pico_Engine engine,
+        const pico_Char *text,
+        const pico_Int32 textSize,
+        pico_Int32 *outBytesPut
+        );
+
 /**
    Gets speech data from the engine. Every time this function is
-   called, the engine performs, within a short time slot, a small
-   amount of processing its input text, and then gives control back to
-   the calling application. Ie. after calling 'pico_putTextUtf8'
-   (incl. a final embedded '\0'), this function needs to be called
-   repeatedly till 'outBytesReceived' bytes are returned in
-   'outBuffer'. The type of data returned in 'outBuffer' (e.g. 8 or 16
-   bit PCM samples) is returned in 'outDataType' and depends on the
-   lingware resources. Possible 'outDataType' values are listed in
+   called, the engine processes its input text until 'outBuffer' is
+   filled with as many complete output frames as fit into it, or until
+   all input is processed, and then gives control back to the calling
+   application. Larger buffers therefore mean fewer calls; small
+   buffers (e.g. a single frame) give the application control more
+   often. Ie. after calling 'pico_putTextUtf8' (incl. a final embedded
+   '\0'), this function needs to be called repeatedly till
+   'outBytesReceived' bytes are returned in 'outBuffer'. The type of
+   data returned in 'outBuffer' (e.g. 8 or 16 bit PCM samples) is
+   returned in 'outDataType' and depends on the lingware resources. Possible 'outDataType' values are listed in
    picodefs.h (PICO_DATA_*).
    This function returns PICO_STEP_BUSY while processing input and
    producing speech output. Once all data is returned and there is no
@@ -417,6 +512,108 @@ PICO_FUNC pico_getData(
         pico_Int16 *outDataType
         );
 
+/**
+   Same as pico_getData, but with 32 bit sizes. 'outBuffer' is filled
+   with as many output frames as fit into 'bufferSize' bytes (e.g. 20
+   to 100 ms of audio for a streaming server), so fewer calls are
+   needed than with the 16 bit pico_getData.
+*/
+PICO_FUNC pico_getDataEx(
+        pico_Engine engine,
+        void *outBuffer,
+        const pico_Int32 bufferSize,
+        pico_Int32 *outBytesReceived,
+        pico_Int16 *outDataType
+        );
+
+/**
+   Type of the callback set with pico_setSpeechCallback. It receives
+   'numSamples' 16 bit PCM samples, which are only valid during the
+   call, and the 'userData' given to pico_setSpeechCallback.
+*/
+typedef void (* pico_SpeechCallback)(
+        void *userData,
+        const pico_Int16 *samples,
+        pico_Uint16 numSamples
+        );
+
+/**
+   Sets a callback to which signal generation passes the speech data
+   directly, as soon as it is produced, instead of returning it in the
+   'outBuffer' of pico_getData/pico_getDataEx; this saves copying the
+   samples through the engine's output buffer and the application's
+   buffers. The callback is called from within pico_getData and
+   pico_getDataEx, which then return PICO_STEP_BUSY after each piece
+   of speech passed on (with 'outBytesReceived' 0) and PICO_STEP_IDLE
+   when all input is processed; their 'outBuffer' may be NULL if
+   'bufferSize' is 0. Passing NULL as 'callback' returns speech data
+   in 'outBuffer' again. The callback stays set when the engine is
+   reset.
+*/
+PICO_FUNC pico_setSpeechCallback(
+        pico_Engine engine,
+        pico_SpeechCallback callback,
+        void *userData
+        );
+
+/**
+   Type of the callback of pico_synthesize. 'event' is one of the
+   PICO_EVENT_* values in picodefs.h. For PICO_EVENT_AUDIO, 'samples'
+   holds 'numSamples' 16 bit PCM samples; for PICO_EVENT_MARK,
+   'markName' is the zero terminated name of the mark; other
+   parameters are NULL or 0. The data is only valid during the call.
+   Returning anything but PICO_OK stops synthesis.
+*/
+typedef pico_Status (* pico_SynthesisCallback)(
+        void *userData,
+        pico_Int16 event,
+        const pico_Int16 *samples,
+        pico_Int32 numSamples,
+        const pico_Char *markName
+        );
+
+/**
+   Synthesizes the complete text 'text' of 'textSize' bytes (UTF8, with
+   markup as for pico_putTextUtf8) and passes the speech to 'callback'
+   in blocks of up to some thousand samples, together with events for
+   marks and sentence ends in the order in which they occur in the
+   speech. This replaces the loop of pico_putTextUtf8 and pico_getData
+   calls; pico_synthesize returns when all of the text is spoken, or
+   when the callback returns a status other than PICO_OK, in which case
+   the rest of the text is discarded (as with PICO_RESET_SOFT) and that
+   status is returned, or when pico_cancelEngine is called, in which case
+   PICO_WARN_CANCELLED is returned. A callback set with
+   pico_setSpeechCallback does not receive the speech of this text; it
+   is set again when pico_synthesize returns.
+*/
+PICO_FUNC pico_synthesize(
+        pico_Engine engine,
+        const pico_Char *text,
+        const pico_Int32 textSize,
+        pico_SynthesisCallback callback,
+        void *userData
+        );
+
+/**
+   Cancels the synthesis of the text put into the engine so far. Unlike
+   the other engine functions, pico_cancelEngine may be called from
+   another thread while pico_getData or pico_synthesize is running for
+   the engine; these return as soon as the processing step in progress
+   (of either thread of a pipelined engine) has ended, pico_getData with
+   PICO_STEP_IDLE and pico_synthesize with PICO_WARN_CANCELLED. Steps
+   are short, and the parameter generation of long sentences also stops
+   early; on a desktop processor this takes a few milliseconds at most.
+   The text and all data in the engine's internal buffers are discarded,
+   as with PICO_RESET_SOFT, but the text analysis thread of a pipelined
+   engine keeps running; if neither function is running, this is done
+   when pico_getData is called next. A cancellation requested while all text has been
+   synthesized has no effect on the text put next. Other engines are not
+   affected.
+*/
+PICO_FUNC pico_cancelEngine(
+        pico_Engine engine
+        );
+
 /**
    Resets the engine and clears all engine-internal buffers, in
    particular text input and signal data output buffers.
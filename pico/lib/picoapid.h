@@ -51,7 +51,9 @@ typedef struct pico_system {
     picoos_uint32 magic;        /* magic number used to validate handles */
     picoos_Common common;
     picorsrc_ResourceManager rm;
-    picoctrl_Engine engine;
+    picoos_uint16 numEngines;
+    picoctrl_Engine engine[PICO_MAX_NUM_ENGINES]; /* engines sharing the resources of rm */
+    picoos_Mutex lock;          /* protects the engine table */
 } pico_system_t;
 
 
@@ -60,7 +60,9 @@
 #include "picodbg.h"
 #include "picodata.h"
 #include "picokpdf.h"
+#include "picoktab.h"
 #include "picodsp.h"
+#include "picodspv.h"
 #include "picocep.h"
 
 #ifdef __cplusplus
@@ -87,6 +89,10 @@ extern "C" {
 #define PICOCEP_LFZDOUBLEDEC 1
 #define PICOCEP_MGCDOUBLEDEC 0
 
+#if defined(PICODSP_FLOAT)
+#define PICOCEP_LANES 4  /* maximum number of cepstral dimensions smoothed together by smoothBlock */
+#endif
+
 typedef enum picocep_WantMeanOrIvar
 {
     PICOCEP_WANTMEAN, PICOCEP_WANTIVAR
@@ -97,6 +103,15 @@ typedef enum picocep_WantStaticOrDeltax
     PICOCEP_WANTSTATIC, PICOCEP_WANTDELTA, PICOCEP_WANTDELTA2
 } picocep_WantStaticOrDelta_t;
 
+#if defined(PICODSP_FLOAT)
+/* means (U*m) and inverse variances of one pdf vector for PICOCEP_LANES cepstral dimensions */
+typedef struct cep_pdfblock
+{
+    picoos_single ms[PICOCEP_LANES], md[PICOCEP_LANES], mdd[PICOCEP_LANES]; /* static, delta, delta delta */
+    picoos_single ivs[PICOCEP_LANES], ivd[PICOCEP_LANES], ivdd[PICOCEP_LANES];
+} cep_pdfblock_t;
+#endif
+
 /*
  *   Fixedpoint arithmetic (might go into a separate module if general enough and needed by other modules)
  */
@@ -141,6 +156,8 @@ int numlongmult = 0, numshortmult = 0;
 #define PICOCEP_MAXNR_HEADX    60
 /* item num restriction: maximum size of all item contents together in cont */
 #define PICOCEP_MAXSIZE_CBUF 7680 /* (128 * PICOCEP_MAXNR_HEADX) */
+/* windowed smoothing: minimum number of frames of context */
+#define PICOCEP_MIN_LOOKAHEAD 8
 
 typedef struct
 {
@@ -165,6 +182,16 @@ typedef struct cep_subobj
     picoos_uint8 sentenceEnd;
     picoos_uint8 feedFollowState;
     picoos_bool inIgnoreState;
+    /* low latency: smooth the first phrase of an utterance on its own */
+    picoos_bool smoothFirstPhrase;
+    picoos_bool inFirstPhrase; /* parsing the first phrase of an utterance */
+    picoos_bool firstPhraseSpoken; /* first phrase has had phones other than pauses */
+    /* windowed smoothing: frames of right (and left) context of each window,
+       0 if whole sentences are smoothed */
+    picoos_uint16 lookahead;
+    picoos_uint8 pauseId; /* phone id of the pause */
+    /* set by the engine on cancellation, possibly from another thread */
+    picoos_uint32 * cancel;
     /*----------------------PU input management------------------------------*/
     picoos_uint8 inBuf[PICODATA_MAX_ITEMSIZE]; /* internal input buffer */
     picoos_uint16 inBufSize; /* actually allocated size */
@@ -188,9 +215,17 @@ typedef struct cep_subobj
     picoos_uint32 nNumFrames;
     /*---------------------- other working variables ---------------------------*/
 
+#if defined(PICODSP_FLOAT)
+    /* band of the factor L of the float32 LDL factorization and solution of
+       smoothBlock: three values per frame and cepstral dimension smoothed
+       together, so that for N frames PICOCEP_MAXWINLEN / N dimensions (at
+       most PICOCEP_LANES) are smoothed at once */
+    picoos_single lf[3 * PICOCEP_MAXWINLEN];
+#else
     picoos_int32 diag0[PICOCEP_MAXWINLEN], diag1[PICOCEP_MAXWINLEN],
             diag2[PICOCEP_MAXWINLEN], WUm[PICOCEP_MAXWINLEN],
             invdiag0[PICOCEP_MAXWINLEN];
+#endif
 
     /*---------------------- constants --------------------------------------*/
     picoos_int32 xi[5], x1[2], x2[3], xm[3], xn[2];
@@ -237,6 +272,9 @@ typedef struct cep_subobj
 #define picocep_highestBitU(x) (x==0?0:picocep_highestBitNZ(x))
 #define picocep_highestBitS(x,zz) (x==0?0:(x<0?((zz)=(-x),picocep_highestBitNZ(zz)):picocep_highestBitNZ(x)))
 
+/* TRUE if the utterance being smoothed has been cancelled */
+#define CEP_CANCELLED(cep) ((NULL != (cep)->cancel) && picopal_atomic_load((cep)->cancel))
+
 /* ------------------------------------------------------------------------------
  Internal function definitions
  ---------------------------------------------------------------------------------*/
@@ -247,6 +285,14 @@ static picoos_int32 getFromPdf(picokpdf_PdfMUL pdf, picoos_uint32 vecstart,
         picoos_uint8 cepnum, picocep_WantMeanOrIvar_t wantMeanOrIvar,
         picocep_WantStaticOrDelta_t wantStaticOrDeltax);
 
+#if defined(PICODSP_FLOAT)
+static void getBlockFromPdf(picokpdf_PdfMUL pdf, picoos_uint32 vecstart,
+        picoos_uint8 cepnum, cep_pdfblock_t *blk);
+
+static void smoothBlock(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
+        picoos_uint16 *indices, picoos_uint16 N, picoos_uint8 cepnum,
+        picoos_uint8 lanes, picoos_int16 *smoothcep);
+#else
 static void invMatrix(cep_subobj_t * cep, picoos_uint16 N,
         picoos_int16 *smoothcep, picoos_uint8 cepnum,
         picokpdf_PdfMUL pdf, picoos_uint8 invpow, picoos_uint8 invDoubleDec);
@@ -254,6 +300,7 @@ static void invMatrix(cep_subobj_t * cep, picoos_uint16 N,
 static picoos_uint8 makeWUWandWUm(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
         picoos_uint16 *indices, picoos_uint16 b, picoos_uint16 N,
         picoos_uint8 cepnum);
+#endif
 
 static void getDirect(picokpdf_PdfMUL pdf, picoos_uint16 *indices,
         picoos_uint16 activeEndPos,
@@ -267,6 +314,8 @@ static picoos_uint16 get_pi_uint16(picoos_uint8 * buf, picoos_uint16 *pos);
 
 static void treat_phone(cep_subobj_t * cep, picodata_itemhead_t * ihead);
 
+static void shiftWindow(cep_subobj_t * cep);
+
 static picoos_uint8 forwardingItem(picodata_itemhead_t * ihead);
 
 static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
@@ -319,6 +368,8 @@ static pico_status_t cepInitialize(register picodata_ProcessingUnit this, picoos
     cep->needMoreInput = 0;
     cep->inIgnoreState = 0;
     cep->sentenceEnd = FALSE;
+    cep->inFirstPhrase = TRUE;
+    cep->firstPhraseSpoken = FALSE;
     cep->procState = PICOCEP_STEPSTATE_COLLECT;
 
     cep->nNumFrames = 0;
@@ -340,6 +391,8 @@ static pico_status_t cepInitialize(register picodata_ProcessingUnit this, picoos
         /* kb tab phones */
         /* cep->phones =
          picoktab_getPhones(this->voice->kbArray[PICOKNOW_KBID_TAB_PHONES]); */
+        cep->pauseId = picoktab_getPauseID(
+                picoktab_getPhones(this->voice->kbArray[PICOKNOW_KBID_TAB_PHONES]));
 
         /*---------------------- other working variables ---------------------------*/
         /* define the (constant) FRAME_PAR item header */
@@ -443,6 +496,9 @@ picodata_ProcessingUnit picocep_newCepUnit(picoos_MemoryManager mm,
         picoos_deallocate(mm, (void*) &this);
         return NULL;
     };
+    cep->smoothFirstPhrase = FALSE;
+    cep->lookahead = 0;
+    cep->cancel = NULL;
 
     /* allocate output coeeficient buffers */
     cep->outF0 = (picoos_int16 *) picoos_allocate(this->common->mm,
@@ -468,11 +524,71 @@ picodata_ProcessingUnit picocep_newCepUnit(picoos_MemoryManager mm,
     return this;
 }/*picocep_newCepUnit*/
 
+/**
+ * enables smoothing the first phrase of each utterance (i.e. after a flush)
+ * on its own, as soon as its phrase boundary is reached, instead of
+ * together with the rest of the sentence (low latency mode)
+ * @param    this : the CEP PU
+ * @param    enable : TRUE to enable
+ * @callgraph
+ * @callergraph
+ */
+void picocep_setSmoothFirstPhrase(picodata_ProcessingUnit this,
+        picoos_bool enable)
+{
+    if ((NULL != this) && (NULL != this->subObj)) {
+        ((cep_subobj_t *) this->subObj)->smoothFirstPhrase = enable;
+    }
+}/*picocep_setSmoothFirstPhrase*/
+
+/**
+ * enables windowed smoothing: instead of waiting for the end of the sentence,
+ * the frames are smoothed and output in windows, each as soon as 'lookahead'
+ * frames following it are known. The already output frames preceding a window
+ * are smoothed again (up to 'lookahead' of them) so that the trajectories join
+ * smoothly.
+ * @param    this : the CEP PU
+ * @param    lookahead : number of frames of context (at least
+ *                       PICOCEP_MIN_LOOKAHEAD); 0 smooths whole sentences
+ * @callgraph
+ * @callergraph
+ */
+void picocep_setLookahead(picodata_ProcessingUnit this,
+        picoos_uint16 lookahead)
+{
+    if ((NULL != this) && (NULL != this->subObj)) {
+        if ((lookahead > 0) && (lookahead < PICOCEP_MIN_LOOKAHEAD)) {
+            lookahead = PICOCEP_MIN_LOOKAHEAD;
+        } else if (lookahead > PICOCEP_MAXWINLEN / 4) {
+            lookahead = PICOCEP_MAXWINLEN / 4;
+        }
+        ((cep_subobj_t *) this->subObj)->lookahead = lookahead;
+    }
+}/*picocep_setLookahead*/
+
+/**
+ * sets the flag telling the CEP PU that the current utterance is cancelled:
+ * smoothing a long sentence then stops between two cepstral dimensions,
+ * leaving the PU to be reset by the engine
+ * @param    this : the CEP PU
+ * @param    cancel : the engine's cancellation flag, or NULL
+ * @callgraph
+ * @callergraph
+ */
+void picocep_setCancelFlag(picodata_ProcessingUnit this,
+        picoos_uint32 * cancel)
+{
+    if ((NULL != this) && (NULL != this->subObj)) {
+        ((cep_subobj_t *) this->subObj)->cancel = cancel;
+    }
+}/*picocep_setCancelFlag*/
+
 /* --------------------------------------------
  *   processing and internal functions
  * --------------------------------------------
  */
 
+#if !defined(PICODSP_FLOAT)
 /**
  * multiply by 1<<pow and check overflow
  * @param    a : input value
@@ -651,6 +767,7 @@ static picoos_int32 picocep_fixptmult(picoos_int32 x, picoos_int32 y,
     }
     return z;
 }/* picocep_fixptmult */
+#endif
 
 /**
  * fixed point ^division of a vs b
@@ -715,6 +832,7 @@ static picoos_int32 picocep_fixptdiv(picoos_int32 a, picoos_int32 b,
     return c;
 }/* picocep_fixptdiv */
 
+#if !defined(PICODSP_FLOAT)
 /**
  * perform inversion of diagonal element of WUW matrix
  * @param    d : diagonal element to be inverted
@@ -819,6 +937,7 @@ static picoos_int32 picocep_fixptinv(picoos_int32 a, picoos_uint32 invb,
     }
     return c;
 }
+#endif
 
 /**
  * initializes the coefficients to calculate delta and delta-delta values and the squares of the coefficients
@@ -864,6 +983,270 @@ static void initSmoothing(cep_subobj_t * cep)
     cep->xsqn[1] = 4;
 }
 
+#if defined(PICODSP_FLOAT)
+/**
+ * Retrieve means and inverse variances of PICOCEP_LANES cepstral dimensions from PDF resource
+ * @param    pdf :  pdf resource
+ * @param    vecstart : start of the pdf vector
+ * @param    cepnum :  first cepstral dimension to be retrieved
+ * @param    blk :  the values retrieved; dimensions beyond ceporder get a static inverse variance of 1, everything else 0
+ * @return  void
+ * @callgraph
+ * @callergraph
+ */
+static void getBlockFromPdf(picokpdf_PdfMUL pdf, picoos_uint32 vecstart,
+        picoos_uint8 cepnum, cep_pdfblock_t *blk)
+{
+    picoos_uint8 l, c;
+
+    for (l = 0; l < PICOCEP_LANES; l++) {
+        c = cepnum + l;
+        if (c < pdf->ceporder) {
+            blk->ms[l] = (picoos_single) getFromPdf(pdf, vecstart, c,
+                    PICOCEP_WANTMEAN, PICOCEP_WANTSTATIC);
+            blk->md[l] = (picoos_single) getFromPdf(pdf, vecstart, c,
+                    PICOCEP_WANTMEAN, PICOCEP_WANTDELTA);
+            blk->mdd[l] = (picoos_single) getFromPdf(pdf, vecstart, c,
+                    PICOCEP_WANTMEAN, PICOCEP_WANTDELTA2);
+            blk->ivs[l] = (picoos_single) getFromPdf(pdf, vecstart, c,
+                    PICOCEP_WANTIVAR, PICOCEP_WANTSTATIC);
+            blk->ivd[l] = (picoos_single) getFromPdf(pdf, vecstart, c,
+                    PICOCEP_WANTIVAR, PICOCEP_WANTDELTA);
+            blk->ivdd[l] = (picoos_single) getFromPdf(pdf, vecstart, c,
+                    PICOCEP_WANTIVAR, PICOCEP_WANTDELTA2);
+        } else {
+            blk->ms[l] = blk->md[l] = blk->mdd[l] = 0;
+            blk->ivs[l] = 1;
+            blk->ivd[l] = blk->ivdd[l] = 0;
+        }
+    }
+}
+
+/**
+ * smoothing of up to PICOCEP_LANES cepstral dimensions at once; float32 counterpart of makeWUWandWUm and invMatrix
+ * @param    cep : PU sub object pointer
+ * @param    pdf :  pdf resource
+ * @param    indices : indices of pdf vectors for all frames in current sentence
+ * @param    N : number of frames to be smoothed (more than 3)
+ * @param    cepnum :  first cepstral dimension to be treated
+ * @param    lanes :  number of cepstral dimensions to be treated, 1..PICOCEP_LANES, with N * lanes <= PICOCEP_MAXWINLEN
+ * @param    smoothcep : pointer to picoos_int16, sequence of smoothed cepstral vectors
+ * @return  void
+ * @remarks WUW is pentadiagonal: row j of its band (a0 on the diagonal, a1 and a2 right of it) and of WUm (y)
+ *          only depend on the pdf vectors of frames j-1..j+1. Each row is eliminated as soon as it is built
+ *          (LDL factorization, L in l1 and l2), so that the pdf is read once per frame and only L and the
+ *          solution are stored. The lanes of the rows hold consecutive cepstral dimensions; the lanes are
+ *          independent, so a dimension gets the same result whatever the number of lanes
+ * @callgraph
+ * @callergraph
+ */
+static void smoothBlock(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
+        picoos_uint16 *indices, picoos_uint16 N, picoos_uint8 cepnum,
+        picoos_uint8 lanes, picoos_int16 *smoothcep)
+{
+    cep_pdfblock_t blk[3], *pm, *p0, *pp, *ph; /* pdf vectors of frames i-1, i, i+1 */
+    picoos_single a0[PICOCEP_LANES], a1[PICOCEP_LANES], a2[PICOCEP_LANES],
+            y[PICOCEP_LANES];
+    picoos_single qd[3], qdd[3], wd[3], wdd[3], s0, s1, t; /* weights of frames i-1, i, i+1 in the rows */
+    picoos_int32 *x = NULL, *xsq = NULL;
+    picoos_uint16 Id[2], Idd[3];
+    picoos_uint16 numd = 0, numdd = 0;
+    picoos_int32 i, j, l;
+    picoos_uint32 k;
+    picoos_single scale;
+    picoos_single *l1, *l2, *xf;
+    picoos_uint8 ceporder = pdf->ceporder;
+    picoos_uint8 vecsize = pdf->vecsize;
+    picoos_single d, r, yy, p1, p2, q1;
+    picoos_single d1[PICOCEP_LANES], d2[PICOCEP_LANES], y1[PICOCEP_LANES],
+            y2[PICOCEP_LANES];
+#if defined(PICODSP_SIMD)
+    picodsp_fvec_t vd, vr, vy, vl1, vl2, vd1, vd2, vy1, vy2, vp1, vp2, vq1,
+            vx, vx1, vx2;
+#endif
+
+    l1 = cep->lf;
+    l2 = l1 + N * lanes;
+    xf = l2 + N * lanes;
+    pm = &blk[0];
+    p0 = &blk[1];
+    pp = &blk[2];
+    picoos_mem_set(p0, 0, sizeof(cep_pdfblock_t));
+    getBlockFromPdf(pdf, indices[0] * vecsize, cepnum, pp);
+#if defined(PICODSP_SIMD)
+    vp1 = vp2 = vq1 = vd1 = vd2 = vy1 = vy2 = picodsp_fvdup(0.0f);
+#endif
+    for (l = 0; l < PICOCEP_LANES; l++) {
+        d1[l] = d2[l] = y1[l] = y2[l] = 0;
+    }
+
+    /* LDL factorization with forward substitution and division by D:
+       D[j] = a0[j] - l1[j-1]^2*D[j-1] - l2[j-2]^2*D[j-2],
+       l1[j] = (a1[j] - l2[j-1]*l1[j-1]*D[j-1])/D[j], l2[j] = a2[j]/D[j];
+       the fixed point scale of the pdf cancels out in the solution */
+    for (i = 0, k = 0; i < N; i++, k += lanes) {
+        ph = pm;
+        pm = p0;
+        p0 = pp;
+        pp = ph;
+        if (i + 1 >= N) {
+            picoos_mem_set(pp, 0, sizeof(cep_pdfblock_t));
+        } else if (indices[i + 1] == indices[i]) {
+            *pp = *p0;
+        } else {
+            getBlockFromPdf(pdf, indices[i + 1] * vecsize, cepnum, pp);
+        }
+
+        /* windows of row i, as in makeWUWandWUm */
+        if ((1 < i) && (i < N - 2)) {
+            x = cep->xi;
+            xsq = cep->xsqi;
+            numd = 2;
+            numdd = 3;
+            Id[0] = Idd[0] = i - 1;
+            Id[1] = Idd[2] = i + 1;
+            Idd[1] = i;
+        } else if (i == 0) {
+            x = cep->x1;
+            xsq = cep->xsq1;
+            numd = numdd = 1;
+            Id[0] = Idd[0] = 1;
+        } else if (i == 1) {
+            x = cep->x2;
+            xsq = cep->xsq2;
+            numd = 1;
+            numdd = 2;
+            Id[0] = Idd[1] = 2;
+            Idd[0] = 1;
+        } else if (i == N - 2) {
+            x = cep->xm;
+            xsq = cep->xsqm;
+            numd = 1;
+            numdd = 2;
+            Id[0] = Idd[0] = N - 3;
+            Idd[1] = N - 2;
+        } else if (i == N - 1) {
+            x = cep->xn;
+            xsq = cep->xsqn;
+            numd = numdd = 1;
+            Id[0] = Idd[0] = N - 2;
+        }
+        for (j = 0; j < 3; j++) {
+            qd[j] = qdd[j] = wd[j] = wdd[j] = 0;
+        }
+        for (j = 0; j < numd; j++) {
+            qd[Id[j] - i + 1] = 0.25f * (picoos_single) xsq[j];
+            wd[Id[j] - i + 1] = 0.5f * (picoos_single) x[j];
+        }
+        for (j = 0; j < numdd; j++) {
+            qdd[Idd[j] - i + 1] = 0.25f * (picoos_single) xsq[numd + j];
+            wdd[Idd[j] - i + 1] = 0.5f * (picoos_single) x[numd + j];
+        }
+        s0 = (i > 0 && i < N - 1) ? -2.0f : 0.0f;
+        s1 = (i < N - 2) ? -2.0f : 0.0f;
+        t = (i < N - 2) ? 1.0f : 0.0f;
+
+        /* build row i */
+        for (l = 0; l < PICOCEP_LANES; l++) {
+            a0[l] = p0->ivs[l] + qd[0] * pm->ivd[l] + qd[1] * p0->ivd[l]
+                    + qd[2] * pp->ivd[l] + qdd[0] * pm->ivdd[l]
+                    + qdd[1] * p0->ivdd[l] + qdd[2] * pp->ivdd[l];
+            y[l] = p0->ms[l] + wd[0] * pm->md[l] + wd[1] * p0->md[l]
+                    + wd[2] * pp->md[l] + wdd[0] * pm->mdd[l]
+                    + wdd[1] * p0->mdd[l] + wdd[2] * pp->mdd[l];
+            a1[l] = s0 * p0->ivdd[l] + s1 * pp->ivdd[l];
+            a2[l] = t * (pp->ivdd[l] - 0.25f * pp->ivd[l]);
+        }
+
+        /* eliminate it */
+#if defined(PICODSP_SIMD)
+        if (PICOCEP_LANES == lanes) {
+            vd = picodsp_fvsub(picodsp_fvload(a0), picodsp_fvadd(
+                    picodsp_fvmul(picodsp_fvmul(vp1, vp1), vd1),
+                    picodsp_fvmul(picodsp_fvmul(vp2, vp2), vd2)));
+            vy = picodsp_fvsub(picodsp_fvload(y), picodsp_fvadd(
+                    picodsp_fvmul(vp1, vy1), picodsp_fvmul(vp2, vy2)));
+            vr = picodsp_fvrecip(vd);
+            vl1 = picodsp_fvmul(picodsp_fvsub(picodsp_fvload(a1),
+                    picodsp_fvmul(picodsp_fvmul(vq1, vp1), vd1)), vr);
+            vl2 = picodsp_fvmul(picodsp_fvload(a2), vr);
+            picodsp_fvstore(l1 + k, vl1);
+            picodsp_fvstore(l2 + k, vl2);
+            picodsp_fvstore(xf + k, picodsp_fvmul(vy, vr));
+            vp2 = vq1;
+            vq1 = vl2;
+            vp1 = vl1;
+            vd2 = vd1;
+            vd1 = vd;
+            vy2 = vy1;
+            vy1 = vy;
+            continue;
+        }
+#endif
+        for (l = 0; l < lanes; l++) {
+            p1 = q1 = p2 = 0;
+            if (i > 0) {
+                p1 = l1[k - lanes + l];
+                q1 = l2[k - lanes + l];
+            }
+            if (i > 1) {
+                p2 = l2[k - 2 * lanes + l];
+            }
+            d = a0[l] - (p1 * p1 * d1[l] + p2 * p2 * d2[l]);
+            yy = y[l] - (p1 * y1[l] + p2 * y2[l]);
+            r = 1.0f / d;
+            l1[k + l] = (a1[l] - q1 * p1 * d1[l]) * r;
+            l2[k + l] = a2[l] * r;
+            xf[k + l] = yy * r;
+            d2[l] = d1[l];
+            d1[l] = d;
+            y2[l] = y1[l];
+            y1[l] = yy;
+        }
+    }
+
+    /* backward substitution */
+    k = (N - 1) * lanes;
+#if defined(PICODSP_SIMD)
+    if (PICOCEP_LANES == lanes) {
+        vx1 = picodsp_fvload(xf + k);
+        vx2 = picodsp_fvdup(0.0f);
+        for (j = N - 2; j >= 0; j--) {
+            k -= PICOCEP_LANES;
+            vx = picodsp_fvsub(picodsp_fvload(xf + k), picodsp_fvadd(
+                    picodsp_fvmul(picodsp_fvload(l1 + k), vx1),
+                    picodsp_fvmul(picodsp_fvload(l2 + k), vx2)));
+            picodsp_fvstore(xf + k, vx);
+            vx2 = vx1;
+            vx1 = vx;
+        }
+    }
+    else
+#endif
+    for (j = N - 2; j >= 0; j--) {
+        k -= lanes;
+        for (l = 0; l < lanes; l++) {
+            if (j < N - 2) {
+                xf[k + l] -= l1[k + l] * xf[k + lanes + l]
+                        + l2[k + l] * xf[k + 2 * lanes + l];
+            } else {
+                xf[k + l] -= l1[k + l] * xf[k + lanes + l];
+            }
+        }
+    }
+
+    /* copy N frames into smoothcep, in the fixed point base of the integer version */
+    scale = (picoos_single) (1 << (pdf->bigpow - pdf->meanpow));
+    for (l = 0; (l < lanes) && (cepnum + l < ceporder); l++) {
+        k = cepnum + l;
+        for (j = 0; j < N; j++) {
+            smoothcep[k] = (picoos_int16) (xf[j * lanes + l] * scale);
+            k += ceporder;
+        }
+    }
+}/* smoothBlock */
+#else
+
 /**
  * matrix inversion
  * @param    cep : PU sub object pointer
@@ -1161,6 +1544,7 @@ static picoos_uint8 makeWUWandWUm(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
 
     return 0;
 }/* makeWUWandWUm */
+#endif
 
 /**
  * Retrieve actual values for MGC from PDF resource
@@ -1506,6 +1890,58 @@ static void treat_phone(cep_subobj_t * cep, picodata_itemhead_t * ihead)
     PICODBG_DEBUG(("finished phone, advancing inReadPos to %i",cep->inReadPos));
 }
 
+/**
+ * Windowed smoothing: drops the frames that were output and are no longer
+ * needed as left context of the next window, i.e. moves the frames from
+ * 'lookahead' before indexReadPos onwards, together with the items stored
+ * for later output, to the beginning of the buffers
+ * @param    cep :  the CEP PU sub object pointer
+ * @callgraph
+ * @callergraph
+ */
+static void shiftWindow(cep_subobj_t * cep)
+{
+    picoos_uint16 shift, n, i, cstart;
+
+    shift = (cep->indexReadPos > cep->lookahead) ? cep->indexReadPos
+            - cep->lookahead : 0;
+    if (shift > 0) {
+        n = cep->indexWritePos - shift;
+        for (i = 0; i < n; i++) {
+            cep->indicesLFZ[i] = cep->indicesLFZ[shift + i];
+            cep->indicesMGC[i] = cep->indicesMGC[shift + i];
+            cep->phoneId[i] = cep->phoneId[shift + i];
+        }
+        cep->indexReadPos -= shift;
+        cep->indexWritePos = n;
+    }
+    cep->activeEndPos = PICOCEP_MAXWINLEN;
+
+    /* the remaining items are synchronised with frames after indexReadPos */
+    cstart = cep->cbufWritePos;
+    n = cep->headxWritePos - cep->headxBottom;
+    for (i = 0; i < n; i++) {
+        cep->headx[i] = cep->headx[cep->headxBottom + i];
+        cep->headx[i].frame -= shift;
+        if ((cep->headx[i].head.len > 0) && (cep->headx[i].cind < cstart)) {
+            cstart = cep->headx[i].cind;
+        }
+    }
+    cep->headxBottom = 0;
+    cep->headxWritePos = n;
+    if (cstart > 0) {
+        for (i = 0; i < n; i++) {
+            if (cep->headx[i].head.len > 0) {
+                cep->headx[i].cind -= cstart;
+            }
+        }
+        for (i = cstart; i < cep->cbufWritePos; i++) {
+            cep->cbuf[i - cstart] = cep->cbuf[i];
+        }
+        cep->cbufWritePos -= cstart;
+    }
+}
+
 /**
  * Returns true if an Item has to be forwarded to next PU
  * @param   ihead : pointer to item head structure
@@ -1657,6 +2093,14 @@ static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
                     break;
                 }
 
+                /* a sentence end ends the first phrase, a flush starts a new utterance */
+                if ((PICODATA_ITEM_BOUND == ihead.type)
+                        && ((PICODATA_ITEMINFO1_BOUND_SEND == ihead.info1)
+                                || (PICODATA_ITEMINFO1_BOUND_TERM == ihead.info1))) {
+                    cep->inFirstPhrase = (PICODATA_ITEMINFO1_BOUND_TERM == ihead.info1);
+                    cep->firstPhraseSpoken = FALSE;
+                }
+
                 /* see if it is a sentence end boundary or termination boundary (flush) and there are indices to smooth -> smooth */
                 if ((PICODATA_ITEM_BOUND == ihead.type)
                         && ((PICODATA_ITEMINFO1_BOUND_SEND == ihead.info1)
@@ -1673,6 +2117,32 @@ static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
                     /* it is a phone */
                     PICODBG_DEBUG(("cep: PARSE treating PHONE"));
                     treat_phone(cep, &ihead);
+                    /* low latency: the first phrase of an utterance ends with the first
+                       pause after speech; it is smoothed as if it were a sentence */
+                    if (!cep->inFirstPhrase) {
+                        /* nothing to do */
+                    } else if (ihead.info1 != cep->pauseId) {
+                        cep->firstPhraseSpoken = TRUE;
+                    } else if (cep->firstPhraseSpoken) {
+                        cep->inFirstPhrase = FALSE;
+                        if (cep->smoothFirstPhrase) {
+                            cep->activeEndPos = cep->indexWritePos;
+                            cep->sentenceEnd = TRUE;
+                            PICODBG_DEBUG(("cep: PARSE found end of first phrase; setting activeEndPos to %i",cep->activeEndPos));
+                            cep->procState = PICOCEP_STEPSTATE_PROCESS_SMOOTH;
+                        }
+                    }
+                    /* windowed smoothing: smooth and output the frames that
+                       have 'lookahead' frames of right context, once there
+                       are at least 'lookahead' of them */
+                    if ((cep->lookahead > 0)
+                            && (PICOCEP_STEPSTATE_PROCESS_PARSE == cep->procState)
+                            && (cep->indexWritePos >= cep->indexReadPos + 2
+                                    * cep->lookahead)) {
+                        cep->activeEndPos = cep->indexWritePos - cep->lookahead;
+                        PICODBG_DEBUG(("cep: PARSE window complete; setting activeEndPos to %i",cep->activeEndPos));
+                        cep->procState = PICOCEP_STEPSTATE_PROCESS_SMOOTH;
+                    }
 
                 } else {
                     if ((PICODATA_ITEM_CMD == ihead.type)
@@ -1752,11 +2222,28 @@ static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
 
                     /* picoos_uint16 framesTreated = 0; */
                     picoos_uint8 cepnum;
-                    picoos_uint16 N;
+                    picoos_uint16 b, N, skip;
+#if defined(PICODSP_FLOAT)
+                    picoos_uint8 lanes;
+#endif
 
-                    N = cep->activeEndPos; /* numframes in current step */
+                    if (cep->lookahead > 0) {
+                        /* windowed: frames [indexReadPos, activeEndPos[ are
+                           output; up to 'lookahead' frames before and all
+                           known frames after them are smoothed as context */
+                        if (cep->activeEndPos > cep->indexWritePos) {
+                            cep->activeEndPos = cep->indexWritePos;
+                        }
+                        b = (cep->indexReadPos > cep->lookahead) ? cep->indexReadPos
+                                - cep->lookahead : 0;
+                        N = cep->indexWritePos - b;
+                        skip = cep->indexReadPos - b;
+                    } else {
+                        b = skip = 0;
+                        N = cep->activeEndPos; /* numframes in current step */
+                    }
 
-                    /* the range to be smoothed starts at 0 and is N long */
+                    /* the range to be smoothed starts at b and is N long */
 
                     /* smooth each cepstral dimension separately */
                     /* still to be experimented if higher order coeff can remain unsmoothed, i.e. simple copy from pdf */
@@ -1767,51 +2254,80 @@ static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
                     cep->outF0ReadPos = cep->outF0WritePos = 0;
 
                     PICODBG_DEBUG(("smoothing %d frames\n", N));
+#if defined(PICODSP_FLOAT)
+                    /* as many cepstral dimensions at once as the work area holds */
+                    lanes = ((N > 0) && (N * PICOCEP_LANES > PICOCEP_MAXWINLEN))
+                            ? (picoos_uint8) (PICOCEP_MAXWINLEN / N) : PICOCEP_LANES;
+#endif
 
                     /* smooth f0 */
                     pdf = cep->pdflfz;
                     for (cepnum = 0; cepnum < pdf->ceporder; cepnum++) {
-                        if (cep->activeEndPos <= 0) {
+                        if (CEP_CANCELLED(cep)) {
+                            /* the engine discards everything, resetting this PU */
+                            return PICODATA_PU_BUSY;
+                        } else if (cep->activeEndPos <= 0) {
                             /* do nothing */
                         } else if (3 < N) {
-                            makeWUWandWUm(cep, pdf, cep->indicesLFZ, 0, N,
+#if defined(PICODSP_FLOAT)
+                            if (0 == cepnum % lanes) {
+                                smoothBlock(cep, pdf, cep->indicesLFZ + b, N, cepnum,
+                                        lanes, cep->outF0 + cep->outF0WritePos);
+                            }
+#else
+                            makeWUWandWUm(cep, pdf, cep->indicesLFZ, b, N,
                                     cepnum); /* update diag0, diag1, diag2, WUm */
                             invMatrix(cep, N, cep->outF0 + cep->outF0WritePos, cepnum, pdf,
                                     PICOCEP_LFZINVPOW, PICOCEP_LFZDOUBLEDEC);
+#endif
                         } else {
-                            getDirect(pdf, cep->indicesLFZ, cep->activeEndPos,
+                            getDirect(pdf, cep->indicesLFZ + b, N,
                                     cepnum, cep->outF0 + cep->outF0WritePos);
                         }
                     }/* end for cepnum  */
-                    cep->outF0WritePos += cep->activeEndPos * pdf->ceporder;
+                    cep->outF0ReadPos = skip * pdf->ceporder;
+                    cep->outF0WritePos += N * pdf->ceporder;
 
                     /* smooth mgc */
                     pdf = cep->pdfmgc;
                     for (cepnum = 0; cepnum < pdf->ceporder; cepnum++) {
-                        if (cep->activeEndPos <= 0) {
+                        if (CEP_CANCELLED(cep)) {
+                            return PICODATA_PU_BUSY;
+                        } else if (cep->activeEndPos <= 0) {
                             /* do nothing */
                         } else if (3 < N) {
-                            makeWUWandWUm(cep, pdf, cep->indicesMGC, 0, N,
+#if defined(PICODSP_FLOAT)
+                            if (0 == cepnum % lanes) {
+                                smoothBlock(cep, pdf, cep->indicesMGC + b, N, cepnum,
+                                        lanes, cep->outXCep + cep->outXCepWritePos);
+                            }
+#else
+                            makeWUWandWUm(cep, pdf, cep->indicesMGC, b, N,
                                     cepnum); /* update diag0, diag1, diag2, WUm */
                             invMatrix(cep, N, cep->outXCep
                                             + cep->outXCepWritePos, cepnum,
                                     pdf, PICOCEP_MGCINVPOW,
                                     PICOCEP_MGCDOUBLEDEC);
+#endif
                         } else {
-                            getDirect(pdf, cep->indicesMGC, cep->activeEndPos,
+                            getDirect(pdf, cep->indicesMGC + b, N,
                                     cepnum, cep->outXCep + cep->outXCepWritePos);
                         }
                     }/* end for cepnum  */
-                    cep->outXCepWritePos += cep->activeEndPos * pdf->ceporder;
+                    cep->outXCepReadPos = skip * pdf->ceporder;
+                    cep->outXCepWritePos += N * pdf->ceporder;
 
-                    getVoiced(pdf, cep->indicesMGC, cep->activeEndPos, cep->outVoiced
+                    getVoiced(pdf, cep->indicesMGC + b, N, cep->outVoiced
                                     + cep->outVoicedWritePos);
-                    cep->outVoicedWritePos += cep->activeEndPos;
+                    cep->outVoicedReadPos = skip;
+                    cep->outVoicedWritePos += N;
 
                 }
                 /* setting indexReadPos to the next active index to be used. (will be advanced by FRAME when
-                 * reading the phoneId */
-                cep->indexReadPos = 0;
+                 * reading the phoneId; windowed smoothing continues where the previous window ended) */
+                if (0 == cep->lookahead) {
+                    cep->indexReadPos = 0;
+                }
                 cep->procState = PICOCEP_STEPSTATE_PROCESS_FRAME;
                 return PICODATA_PU_BUSY; /*data to feed*/
 
@@ -1965,6 +2481,10 @@ static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
                 } else {
                     /*------------  no more frames can be output but sentence end not reached ----------------------------------------*/
                     PICODBG_DEBUG(("Maximum number of frames per sentence reached"));
+                    if (cep->lookahead > 0) {
+                        /* windowed smoothing: drop the frames no longer needed as context */
+                        shiftWindow(cep);
+                    }
                     cep->procState = PICOCEP_STEPSTATE_PROCESS_PARSE;
                 }
                 /*----------------------------------------------------*/
@@ -47,6 +47,20 @@ picodata_ProcessingUnit picocep_newCepUnit(picoos_MemoryManager mm,
         picoos_Common common, picodata_CharBuffer cbIn,
         picodata_CharBuffer cbOut, picorsrc_Voice voice);
 
+/* low latency: smooth the first phrase of each utterance on its own */
+void picocep_setSmoothFirstPhrase(picodata_ProcessingUnit this,
+        picoos_bool enable);
+
+/* windowed smoothing: output frames as soon as 'lookahead' further frames
+   are known (0: smooth whole sentences) */
+void picocep_setLookahead(picodata_ProcessingUnit this,
+        picoos_uint16 lookahead);
+
+/* cancellation: smoothing is abandoned as soon as '*cancel' is set (by
+   another thread, see picopal_atomic_store); NULL disables the check */
+void picocep_setCancelFlag(picodata_ProcessingUnit this,
+        picoos_uint32 * cancel);
+
 #ifdef __cplusplus
 }
 #endif
@@ -62,8 +62,35 @@ extern "C" {
  * (TTS processing chain).
  * At each step (ctrlStep) it passes control to one of the sub-PUs (currrent PU). It may re-assign
  * the role of "current PU" to another sub-PU, according to the status information returned from each PU.
+ *
+ * In pipelined mode the chain is split in two: the text analysis PUs (front-end, TOK..PAM) are
+ * scheduled by a thread of their own, the signal generation PUs (back-end, CEP and SIG) are scheduled
+ * by ctrlStep in the caller's thread. The CharBuffer between PAM and CEP is the only one written
+ * by one thread and read by the other.
  */
 
+/* size of the cb between front-end and back-end in pipelined mode; large enough for
+   the front-end to run about a phrase ahead of the back-end */
+#define PICOCTRL_PIPELINE_BUF_SIZE (picoos_uint16) (32 * PICODATA_BUFSIZE_DEFAULT)
+
+/* additional engine memory needed in pipelined mode (cb, thread and locks) */
+#define PICOCTRL_PIPELINE_ENGINE_SIZE (PICOCTRL_PIPELINE_BUF_SIZE + 4096)
+
+/* maximum number of consecutive steps given to a busy PU before the
+   scheduler looks at the PUs below it (safety bound of the drain loop) */
+#define PICOCTRL_MAX_DRAIN_STEPS 1024
+
+/* low latency mode: number of words after which SA cuts the first phrase
+   of an utterance (which CEP then smoothes on its own) */
+#define PICOCTRL_FIRST_PHRASE_WORDS 4
+
+/* front-end thread states */
+#define CTRL_FE_BUSY  0 /* processing */
+#define CTRL_FE_IDLE  1 /* waiting for input text */
+#define CTRL_FE_FULL  2 /* waiting for the back-end to empty the cb in between */
+#define CTRL_FE_ERROR 3 /* stopped after a PU error; waiting for reset */
+#define CTRL_FE_CANCELLED 4 /* stopped after a cancellation; waiting for the discard */
+
 /*----------------------------------------------------------
  *  object   : Control
  *  shortcut     : ctrl
@@ -80,8 +107,34 @@ typedef struct ctrl_subobj {
     picodata_ProcessingUnit procUnit [PICOCTRL_MAX_PROC_UNITS];
     picodata_step_result_t procStatus [PICOCTRL_MAX_PROC_UNITS];
     picodata_CharBuffer procCbOut [PICOCTRL_MAX_PROC_UNITS];
+
+    /* low latency mode: until the first sample of an utterance has been
+       output, the scheduler moves on to the next PU as soon as a step produced
+       output instead of draining the current PU */
+    picoos_bool lowLatency;
+    picoos_uint32 firstSamplePending; /* set and cleared by the engine */
+    picoos_uint16 cepLookahead; /* windowed parameter generation, 0 if off */
+
+    /* set by picoctrl_engCancel, possibly from another thread; the PUs are
+       not stepped any more until the engine has discarded its items (see
+       ctrlDiscard), which also clears it */
+    picoos_uint32 cancel;
+
+    /* pipelined mode only */
+    picoos_bool pipelined;
+    picoos_uint8 splitPU;       /* first back-end PU */
+    picoos_uint8 feCurPU;       /* current PU of the front-end thread */
+    picoos_Thread feThread;     /* NULL until the first step after (re-)initialization */
+    picoos_Mutex feLock;        /* protects the state fields below */
+    picoos_Cond feCond;         /* signalled on every state change */
+    picoos_uint32 feState;      /* CTRL_FE_..., may be peeked at without lock */
+    picoos_uint32 feStop;       /* set to terminate the front-end thread */
+    picoos_uint32 beWaiting;    /* back-end is waiting for front-end output */
 } ctrl_subobj_t;
 
+static void ctrlStopFrontEnd(register picodata_ProcessingUnit this);
+static pico_status_t ctrlResetUnits(register picodata_ProcessingUnit this, picoos_int32 resetMode);
+
 /**
  * performs Control PU initialization
  * @param    this : pointer to Control PU
@@ -91,16 +144,33 @@ typedef struct ctrl_subobj {
  * @callergraph
  */
 static pico_status_t ctrlInitialize(register picodata_ProcessingUnit this, picoos_int32 resetMode) {
-    register ctrl_subobj_t * ctrl;
-    pico_status_t status= PICO_OK;
-    picoos_int8 i;
-
     if (NULL == this || NULL == this->subObj) {
         return PICO_ERR_OTHER;
     }
-    ctrl = (ctrl_subobj_t *) this->subObj;
-    ctrl->curPU = 0;
+    ctrlStopFrontEnd(this);
+    return ctrlResetUnits(this, resetMode);
+}/*ctrlInitialize*/
+
+/**
+ * (re-)initializes the PUs and empties the cbs between them; the front-end
+ * thread must not be running the PUs
+ * @param    this : pointer to Control PU
+ * @param    resetMode : PICO_RESET_FULL or PICO_RESET_SOFT
+ * @return    PICO_OK : processing done
+ * @return    PICO_ERR_OTHER : init error
+ * @callgraph
+ * @callergraph
+ */
+static pico_status_t ctrlResetUnits(register picodata_ProcessingUnit this, picoos_int32 resetMode) {
+    register ctrl_subobj_t * ctrl = (ctrl_subobj_t *) this->subObj;
+    pico_status_t status= PICO_OK;
+    picoos_int8 i;
+
+    ctrl->curPU = ctrl->splitPU;
+    ctrl->feCurPU = 0;
+    ctrl->feState = CTRL_FE_BUSY;
     ctrl->lastItemTypeProduced=0;    /*no item produced by default*/
+    ctrl->firstSamplePending = FALSE;
     status = PICO_OK;
     for (i = 0; i < ctrl->numProcUnits; i++) {
         if (PICO_OK == status) {
@@ -116,21 +186,26 @@ static pico_status_t ctrlInitialize(register picodata_ProcessingUnit this, picoo
         picoos_emRaiseException(this->common->em,status,NULL,(picoos_char*)"problem (re-)initializing the engine");
     }
     return status;
-}/*ctrlInitialize*/
+}/*ctrlResetUnits*/
 
 
 /**
- * performs one processing step
+ * performs one processing step on the PUs [firstPU, endPU) of the chain; the
+ * current PU is stepped repeatedly until it is idle or its output is full
+ * ("drain" scheduling), so that the PUs below get larger batches of input;
+ * in low latency mode, while the first sample of an utterance is pending,
+ * the PUs below get control as soon as there is any input for them
  * @param    this : pointer to Control PU
+ * @param    firstPU, endPU : range of PUs to be scheduled
+ * @param    curPU : current PU of the range (input/output)
  * @param    mode : activation mode (unused)
- * @param    bytesOutput : number of bytes produced during this step (output)
- * @return    PICO_OK : processing done
- * @return    PICO_EXC_OUT_OF_MEM : no more memory available
- * @return    PICO_ERR_OTHER : other error
+ * @param    bytesOutput : number of bytes produced by the last PU of the range (output)
+ * @return    status of the current PU; PICODATA_PU_IDLE iff all PUs of the range are idle
  * @callgraph
  * @callergraph
  */
-static picodata_step_result_t ctrlStep(register picodata_ProcessingUnit this,
+static picodata_step_result_t ctrlSchedule(register picodata_ProcessingUnit this,
+        picoos_uint8 firstPU, picoos_uint8 endPU, picoos_uint8 * curPU,
         picoos_int16 mode, picoos_uint16 * bytesOutput) {
     /* rules/invariants:
      * - all pu's above current have status idle except possibly pu+1, which may  be busy.
@@ -140,35 +215,48 @@ static picodata_step_result_t ctrlStep(register picodata_ProcessingUnit this,
     register ctrl_subobj_t * ctrl = (ctrl_subobj_t *) this->subObj;
     picodata_step_result_t status;
     picoos_uint16 puBytesOutput;
+    picoos_uint16 numSteps = 0;
+    picoos_bool drain;
 #if defined(PICO_DEVEL_MODE)
     picoos_uint8  btype;
 #endif
 
     *bytesOutput = 0;
-    ctrl->lastItemTypeProduced=0; /*no item produced by default*/
+    drain = !(ctrl->lowLatency && picopal_atomic_load(&ctrl->firstSamplePending));
+    if (endPU == ctrl->numProcUnits) {
+        /* only tracked in the caller's thread */
+        ctrl->lastItemTypeProduced=0; /*no item produced by default*/
+    }
 
-    /* --------------------- */
-    /* do step of current pu */
-    /* --------------------- */
-    status = ctrl->procStatus[ctrl->curPU] = ctrl->procUnit[ctrl->curPU]->step(
-            ctrl->procUnit[ctrl->curPU], mode, &puBytesOutput);
+    /* ------------------------------------------------ */
+    /* do steps of current pu until it is idle or full */
+    /* ------------------------------------------------ */
+    do {
+        status = ctrl->procStatus[*curPU] = ctrl->procUnit[*curPU]->step(
+                ctrl->procUnit[*curPU], mode, &puBytesOutput);
 
-    if (puBytesOutput) {
+        if (puBytesOutput) {
 
 #if defined(PICO_DEVEL_MODE)
-        /*store the type of item produced*/
-        btype =  picodata_cbGetFrontItemType(ctrl->procUnit[ctrl->curPU]->cbOut);
-        ctrl->lastItemTypeProduced=(picoos_uint8)btype;
+            /*store the type of item produced*/
+            if (endPU == ctrl->numProcUnits) {
+                btype =  picodata_cbGetFrontItemType(ctrl->procUnit[*curPU]->cbOut);
+                ctrl->lastItemTypeProduced=(picoos_uint8)btype;
+            }
 #endif
 
-        if (ctrl->curPU < ctrl->numProcUnits-1) {
-            /* data was output to internal PU buffers : set following pu to busy */
-            ctrl->procStatus[ctrl->curPU + 1] = PICODATA_PU_BUSY;
-        } else {
-            /* data was output to caller output buffer */
-            *bytesOutput = puBytesOutput;
+            if (*curPU < endPU-1) {
+                /* data was output to internal PU buffers : set following pu to busy */
+                ctrl->procStatus[*curPU + 1] = PICODATA_PU_BUSY;
+            } else {
+                /* data was output to caller output buffer */
+                *bytesOutput += puBytesOutput;
+            }
         }
-    }
+    } while (((PICODATA_PU_BUSY == status) || (PICODATA_PU_ATOMIC == status))
+             && (drain || (0 == puBytesOutput) || (PICODATA_PU_ATOMIC == status))
+             && !picopal_atomic_load(&ctrl->cancel)
+             && (++numSteps < PICOCTRL_MAX_DRAIN_STEPS));
     /* recalculate state depending on pu status returned from curPU */
     switch (status) {
         case PICODATA_PU_ATOMIC:
@@ -178,53 +266,337 @@ static picodata_step_result_t ctrlStep(register picodata_ProcessingUnit this,
 
         case PICODATA_PU_BUSY:
             PICODBG_DEBUG(("got PICODATA_PU_BUSY"));
-            if ( (ctrl->curPU+1 < ctrl->numProcUnits) && (PICODATA_PU_BUSY
-                    == ctrl->procStatus[ctrl->curPU+1])) {
-                ctrl->curPU++;
+            if ( (*curPU+1 < endPU) && (PICODATA_PU_BUSY
+                    == ctrl->procStatus[*curPU+1])) {
+                (*curPU)++;
             }
             return status;
             break;
 
         case PICODATA_PU_IDLE:
             PICODBG_DEBUG(("got PICODATA_PU_IDLE"));
-            if ( (ctrl->curPU+1 < ctrl->numProcUnits) && (PICODATA_PU_BUSY
-                    == ctrl->procStatus[ctrl->curPU+1])) {
+            if ( (*curPU+1 < endPU) && (PICODATA_PU_BUSY
+                    == ctrl->procStatus[*curPU+1])) {
                 /* still data to process below */
-                ctrl->curPU++;
-            } else if (0 == ctrl->curPU) { /* all pu's are idle */
+                (*curPU)++;
+            } else if (firstPU == *curPU) { /* all pu's are idle */
                 /* nothing to do */
             } else { /* find non-idle pu above */
                 PICODBG_DEBUG((
                     "find non-idle pu above from pu %d with status %d",
-                    ctrl->curPU, ctrl->procStatus[ctrl->curPU]));
-                while ((ctrl->curPU > 0) && (PICODATA_PU_IDLE
-                        == ctrl->procStatus[ctrl->curPU])) {
-                    ctrl->curPU--;
+                    *curPU, ctrl->procStatus[*curPU]));
+                while ((*curPU > firstPU) && (PICODATA_PU_IDLE
+                        == ctrl->procStatus[*curPU])) {
+                    (*curPU)--;
                 }
-                ctrl->procStatus[ctrl->curPU] = PICODATA_PU_BUSY;
+                ctrl->procStatus[*curPU] = PICODATA_PU_BUSY;
             }
             PICODBG_DEBUG(("going to pu %d with status %d",
-                           ctrl->curPU, ctrl->procStatus[ctrl->curPU]));
+                           *curPU, ctrl->procStatus[*curPU]));
             /*update last scheduled PU*/
-            return ctrl->procStatus[ctrl->curPU];
+            return ctrl->procStatus[*curPU];
             break;
 
         case PICODATA_PU_OUT_FULL:
             PICODBG_DEBUG(("got PICODATA_PU_OUT_FULL"));
-            if (ctrl->curPU+1 < ctrl->numProcUnits) { /* let pu below empty buffer */
-                ctrl->curPU++;
-                ctrl->procStatus[ctrl->curPU] = PICODATA_PU_BUSY;
+            if (*curPU+1 < endPU) { /* let pu below empty buffer */
+                (*curPU)++;
+                ctrl->procStatus[*curPU] = PICODATA_PU_BUSY;
             } else {
                 /* nothing more to do, out_full will be returned to caller */
             }
-            return ctrl->procStatus[ctrl->curPU];
+            return ctrl->procStatus[*curPU];
             break;
         default:
             return PICODATA_PU_ERROR;
             break;
     }
+}/*ctrlSchedule*/
+
+/**
+ * sets the front-end state and wakes up the other thread
+ * @param    ctrl : control sub-object
+ * @param    from : only change the state if it is currently 'from'
+ * @param    to : new state
+ * @remarks    takes the front-end lock
+ * @callgraph
+ * @callergraph
+ */
+static void ctrlSetFrontEndState(ctrl_subobj_t * ctrl, picoos_uint32 from, picoos_uint32 to)
+{
+    picoos_lockMutex(ctrl->feLock);
+    if (from == ctrl->feState) {
+        picopal_atomic_store(&ctrl->feState, to);
+        picoos_signalCond(ctrl->feCond);
+    }
+    picoos_unlockMutex(ctrl->feLock);
+}/*ctrlSetFrontEndState*/
+
+/**
+ * returns TRUE if the cb between front-end and back-end has room for at least one
+ * item and is at least half empty, i.e. if it is worthwhile to resume the front-end
+ * @callgraph
+ * @callergraph
+ */
+static picoos_bool ctrlFrontEndMayResume(ctrl_subobj_t * ctrl)
+{
+    picodata_CharBuffer cb = ctrl->procCbOut[ctrl->splitPU - 1];
+    picoos_uint16 space = picodata_cbGetSpace(cb);
+
+    return (space >= PICODATA_MAX_ITEMSIZE) && (space >= picodata_cbGetLen(cb));
+}/*ctrlFrontEndMayResume*/
+
+/**
+ * main loop of the front-end thread : schedules the PUs before splitPU until
+ * stopped, sleeping while there is no input or no room for output
+ * @param    arg : pointer to Control PU
+ * @callgraph
+ * @callergraph
+ */
+static void ctrlFrontEnd(void * arg)
+{
+    register picodata_ProcessingUnit this = (picodata_ProcessingUnit) arg;
+    register ctrl_subobj_t * ctrl = (ctrl_subobj_t *) this->subObj;
+    picodata_step_result_t status;
+    picoos_uint16 bytesOutput;
+
+    while (!picopal_atomic_load(&ctrl->feStop)) {
+        if (picopal_atomic_load(&ctrl->cancel)) {
+            /* leave the PUs to the back-end, which discards their items, and
+               continue when it is done */
+            picoos_lockMutex(ctrl->feLock);
+            picopal_atomic_store(&ctrl->feState, CTRL_FE_CANCELLED);
+            picoos_signalCond(ctrl->feCond);
+            while ((CTRL_FE_CANCELLED == ctrl->feState) && !ctrl->feStop) {
+                picoos_waitCond(ctrl->feCond, ctrl->feLock);
+            }
+            picoos_unlockMutex(ctrl->feLock);
+            continue;
+        }
+        status = ctrlSchedule(this, 0, ctrl->splitPU, &ctrl->feCurPU, 0, &bytesOutput);
+
+        if ((bytesOutput > 0) && picopal_atomic_load(&ctrl->beWaiting)) {
+            picoos_lockMutex(ctrl->feLock);
+            picoos_signalCond(ctrl->feCond);
+            picoos_unlockMutex(ctrl->feLock);
+        }
+        switch (status) {
+            case PICODATA_PU_IDLE:
+                picoos_lockMutex(ctrl->feLock);
+                if (0 == picodata_cbGetLen(this->cbIn)) {
+                    picopal_atomic_store(&ctrl->feState, CTRL_FE_IDLE);
+                    picoos_signalCond(ctrl->feCond);
+                    while ((CTRL_FE_IDLE == ctrl->feState) && !ctrl->feStop) {
+                        picoos_waitCond(ctrl->feCond, ctrl->feLock);
+                    }
+                }
+                picoos_unlockMutex(ctrl->feLock);
+                break;
+            case PICODATA_PU_OUT_FULL:
+                picoos_lockMutex(ctrl->feLock);
+                if (!ctrlFrontEndMayResume(ctrl)) {
+                    picopal_atomic_store(&ctrl->feState, CTRL_FE_FULL);
+                    picoos_signalCond(ctrl->feCond);
+                    while ((CTRL_FE_FULL == ctrl->feState) && !ctrl->feStop) {
+                        picoos_waitCond(ctrl->feCond, ctrl->feLock);
+                    }
+                }
+                picoos_unlockMutex(ctrl->feLock);
+                break;
+            case PICODATA_PU_ERROR:
+                picoos_lockMutex(ctrl->feLock);
+                picopal_atomic_store(&ctrl->feState, CTRL_FE_ERROR);
+                picoos_signalCond(ctrl->feCond);
+                while ((CTRL_FE_ERROR == ctrl->feState) && !ctrl->feStop) {
+                    picoos_waitCond(ctrl->feCond, ctrl->feLock);
+                }
+                picoos_unlockMutex(ctrl->feLock);
+                break;
+            default:
+                break;
+        }
+    }
+}/*ctrlFrontEnd*/
+
+/**
+ * stops the front-end thread (if running) and waits for its termination
+ * @param    this : pointer to Control PU
+ * @callgraph
+ * @callergraph
+ */
+static void ctrlStopFrontEnd(register picodata_ProcessingUnit this)
+{
+    register ctrl_subobj_t * ctrl = (ctrl_subobj_t *) this->subObj;
+
+    if (NULL != ctrl->feThread) {
+        picoos_lockMutex(ctrl->feLock);
+        picopal_atomic_store(&ctrl->feStop, TRUE);
+        picoos_signalCond(ctrl->feCond);
+        picoos_unlockMutex(ctrl->feLock);
+        picoos_joinThread(this->common->mm, &ctrl->feThread);
+        ctrl->feStop = FALSE;
+    }
+}/*ctrlStopFrontEnd*/
+
+/**
+ * called by the back-end when it has run out of input : waits until the front-end
+ * has produced new output or has become idle
+ * @param    this : pointer to Control PU
+ * @return    PICODATA_PU_BUSY : back-end has new input
+ * @return    PICODATA_PU_IDLE : front-end and back-end are idle
+ * @return    PICODATA_PU_ERROR : front-end has stopped because of an error
+ * @return    PICODATA_PU_IDLE : cancellation requested
+ * @callgraph
+ * @callergraph
+ */
+static picodata_step_result_t ctrlWaitFrontEnd(register picodata_ProcessingUnit this)
+{
+    register ctrl_subobj_t * ctrl = (ctrl_subobj_t *) this->subObj;
+    picodata_step_result_t status;
+
+    picoos_lockMutex(ctrl->feLock);
+    for (;;) {
+        if (picopal_atomic_load(&ctrl->cancel)) {
+            status = PICODATA_PU_IDLE;
+            break;
+        } else if (picodata_cbGetLen(ctrl->procCbOut[ctrl->splitPU - 1]) > 0) {
+            ctrl->procStatus[ctrl->splitPU] = PICODATA_PU_BUSY;
+            status = PICODATA_PU_BUSY;
+            break;
+        } else if (CTRL_FE_ERROR == ctrl->feState) {
+            status = PICODATA_PU_ERROR;
+            break;
+        } else if (CTRL_FE_IDLE == ctrl->feState) {
+            status = PICODATA_PU_IDLE;
+            break;
+        } else if (CTRL_FE_FULL == ctrl->feState) {
+            /* cannot stay full while the cb in between is empty */
+            picopal_atomic_store(&ctrl->feState, CTRL_FE_BUSY);
+            picoos_signalCond(ctrl->feCond);
+        }
+        picopal_atomic_store(&ctrl->beWaiting, TRUE);
+        picoos_waitCond(ctrl->feCond, ctrl->feLock);
+        picopal_atomic_store(&ctrl->beWaiting, FALSE);
+    }
+    picoos_unlockMutex(ctrl->feLock);
+    return status;
+}/*ctrlWaitFrontEnd*/
+
+/**
+ * performs one processing step
+ * @param    this : pointer to Control PU
+ * @param    mode : activation mode (unused)
+ * @param    bytesOutput : number of bytes produced during this step (output)
+ * @return    PICO_OK : processing done
+ * @return    PICO_EXC_OUT_OF_MEM : no more memory available
+ * @return    PICO_ERR_OTHER : other error
+ * @callgraph
+ * @callergraph
+ */
+static picodata_step_result_t ctrlStep(register picodata_ProcessingUnit this,
+        picoos_int16 mode, picoos_uint16 * bytesOutput) {
+    register ctrl_subobj_t * ctrl = (ctrl_subobj_t *) this->subObj;
+    picodata_step_result_t status;
+
+    if (ctrl->pipelined && (NULL == ctrl->feThread)) {
+        ctrl->feThread = picoos_startThread(this->common->mm, ctrlFrontEnd, this);
+        if (NULL == ctrl->feThread) {
+            picoos_emRaiseWarning(this->common->em, PICO_WARN_FALLBACK, NULL,
+                    (picoos_char *) "cannot start text analysis thread, pipelining disabled");
+            ctrl->pipelined = FALSE;
+            ctrl->splitPU = 0;
+            ctrl->curPU = 0;
+        }
+    }
+    if (!ctrl->pipelined) {
+        return ctrlSchedule(this, 0, ctrl->numProcUnits, &ctrl->curPU, mode, bytesOutput);
+    }
+
+    status = ctrlSchedule(this, ctrl->splitPU, ctrl->numProcUnits, &ctrl->curPU, mode, bytesOutput);
+    if ((CTRL_FE_FULL == picopal_atomic_load(&ctrl->feState)) && ctrlFrontEndMayResume(ctrl)) {
+        ctrlSetFrontEndState(ctrl, CTRL_FE_FULL, CTRL_FE_BUSY);
+    }
+    if (PICODATA_PU_IDLE == status) {
+        status = ctrlWaitFrontEnd(this);
+    }
+    return status;
 }/*ctrlStep*/
 
+/**
+ * to be called after new input has been put to the cbIn of the Control PU
+ * @param    this : pointer to Control PU
+ * @callgraph
+ * @callergraph
+ */
+static void ctrlInputAvailable(register picodata_ProcessingUnit this)
+{
+    register ctrl_subobj_t * ctrl = (ctrl_subobj_t *) this->subObj;
+
+    if (ctrl->pipelined) {
+        ctrlSetFrontEndState(ctrl, CTRL_FE_IDLE, CTRL_FE_BUSY);
+    }
+}/*ctrlInputAvailable*/
+
+/**
+ * requests cancellation; may be called from any thread. The scheduler does not
+ * step the PUs any more, and a waiting back-end or front-end is woken up
+ * @param    this : pointer to Control PU
+ * @callgraph
+ * @callergraph
+ */
+static void ctrlCancel(register picodata_ProcessingUnit this)
+{
+    register ctrl_subobj_t * ctrl = (ctrl_subobj_t *) this->subObj;
+
+    picopal_atomic_store(&ctrl->cancel, TRUE);
+    if (NULL != ctrl->feLock) {
+        picoos_lockMutex(ctrl->feLock);
+        picoos_signalCond(ctrl->feCond);
+        picoos_unlockMutex(ctrl->feLock);
+    }
+}/*ctrlCancel*/
+
+/**
+ * discards all items after a cancellation: the PUs are re-initialized as with
+ * PICO_RESET_SOFT and all cbs, including the input and output cb, are emptied.
+ * A front-end thread is kept; it is only waited for until it has left the PUs.
+ * Clears the cancellation.
+ * @param    this : pointer to Control PU
+ * @return    PICO_OK : items discarded
+ * @return    PICO_ERR_OTHER : if error
+ * @callgraph
+ * @callergraph
+ */
+static pico_status_t ctrlDiscard(register picodata_ProcessingUnit this)
+{
+    register ctrl_subobj_t * ctrl = (ctrl_subobj_t *) this->subObj;
+    pico_status_t status;
+
+    if (NULL != ctrl->feThread) {
+        /* the front-end only leaves the busy state under the lock, and then
+           waits for it to change */
+        picoos_lockMutex(ctrl->feLock);
+        while (CTRL_FE_BUSY == ctrl->feState) {
+            picoos_waitCond(ctrl->feCond, ctrl->feLock);
+        }
+    }
+    status = ctrlResetUnits(this, PICO_RESET_SOFT);
+    if (PICO_OK == status) {
+        status = picodata_cbReset(this->cbIn);
+    }
+    if (PICO_OK == status) {
+        status = picodata_cbReset(this->cbOut);
+    }
+    picopal_atomic_store(&ctrl->cancel, FALSE);
+    if (NULL != ctrl->feThread) {
+        /* ctrlResetUnits has set the busy state: the front-end finds its PUs
+           idle and waits for input */
+        picoos_signalCond(ctrl->feCond);
+        picoos_unlockMutex(ctrl->feLock);
+    }
+    return status;
+}/*ctrlDiscard*/
+
 /**
  * terminates Control PU
  * @param    this : pointer to Control PU
@@ -241,6 +613,7 @@ static pico_status_t ctrlTerminate(register picodata_ProcessingUnit this) {
         return PICO_ERR_OTHER;
     }
     ctrl = (ctrl_subobj_t *) this->subObj;
+    ctrlStopFrontEnd(this);
     for (i = 0; i < ctrl->numProcUnits; i++) {
         status = ctrl->procUnit[i]->terminate(ctrl->procUnit[i]);
         PICODBG_DEBUG(("terminating procUnit[%i] returned status %i",i, status));
@@ -251,6 +624,26 @@ static pico_status_t ctrlTerminate(register picodata_ProcessingUnit this) {
     return status;
 }/*ctrlTerminate*/
 
+/**
+ * stops the front-end thread and disposes its synchronization objects, i.e.
+ * everything of the Control PU that is not just memory
+ * @param    this : pointer to Control PU
+ * @return    void
+ * @callgraph
+ * @callergraph
+ */
+static void ctrlDisposeFrontEnd(register picodata_ProcessingUnit this) {
+    register ctrl_subobj_t * ctrl;
+
+    if (NULL == this || NULL == this->subObj) {
+        return;
+    }
+    ctrl = (ctrl_subobj_t *) this->subObj;
+    ctrlStopFrontEnd(this);
+    picoos_disposeCond(this->common->mm, &ctrl->feCond);
+    picoos_disposeMutex(this->common->mm, &ctrl->feLock);
+}/*ctrlDisposeFrontEnd*/
+
 /**
  * deallocates Control PU's subobject
  * @param    this : pointer to Control PU
@@ -269,6 +662,7 @@ static pico_status_t ctrlSubObjDeallocate(register picodata_ProcessingUnit this,
     }
     ctrl = (ctrl_subobj_t *) this->subObj;
     mm = mm;        /* fix warning "var not used in this function"*/
+    ctrlDisposeFrontEnd(this);
     /* deallocate members (procCbOut and procUnit) */
     for (i = ctrl->numProcUnits-1; i >= 0; i--) {
         picodata_disposeProcessingUnit(this->common->mm,&ctrl->procUnit[i]);
@@ -322,6 +716,10 @@ static pico_status_t ctrlAddPU(register picodata_ProcessingUnit this,
     } else {
         PICODBG_DEBUG(("creating intermediate cbOut of pu[%i]", newPU));
         bufSize = picodata_get_default_buf_size(puType);
+        if (ctrl->pipelined && (PICODATA_PUTYPE_PAM == puType)) {
+            /* cb between front-end and back-end */
+            bufSize = PICOCTRL_PIPELINE_BUF_SIZE;
+        }
         ctrl->procCbOut[newPU] = picodata_newCharBuffer(this->common->mm,
                 this->common,bufSize);
 
@@ -353,6 +751,10 @@ static pico_status_t ctrlAddPU(register picodata_ProcessingUnit this,
             PICODBG_DEBUG(("creating SentAnaUnit for pu %i", newPU));
             ctrl->procUnit[newPU] = picosa_newSentAnaUnit(this->common->mm,
                     this->common, cbIn, ctrl->procCbOut[newPU], this->voice);
+            if (ctrl->lowLatency) {
+                picosa_setFirstPhraseWords(ctrl->procUnit[newPU],
+                        PICOCTRL_FIRST_PHRASE_WORDS);
+            }
         break;
     case PICODATA_PUTYPE_ACPH:
             PICODBG_DEBUG(("creating AccPhrUnit for pu %i", newPU));
@@ -373,6 +775,13 @@ static pico_status_t ctrlAddPU(register picodata_ProcessingUnit this,
             PICODBG_DEBUG(("creating CepUnit for pu %i", newPU));
             ctrl->procUnit[newPU] = picocep_newCepUnit(this->common->mm,
                     this->common, cbIn, ctrl->procCbOut[newPU], this->voice);
+            if (ctrl->lowLatency) {
+                picocep_setSmoothFirstPhrase(ctrl->procUnit[newPU], TRUE);
+            }
+            if (ctrl->cepLookahead > 0) {
+                picocep_setLookahead(ctrl->procUnit[newPU], ctrl->cepLookahead);
+            }
+            picocep_setCancelFlag(ctrl->procUnit[newPU], &ctrl->cancel);
         break;
 #if defined(PICO_DEVEL_MODE)
         case PICODATA_PUTYPE_SINK:
@@ -411,6 +820,8 @@ void picoctrl_disposeControl(picoos_MemoryManager mm,
  * @param    cbIn : the input char buffer
  * @param    cbOut : the output char buffer
  * @param    voice : the voice object
+ * @param    engineMode : PICO_ENGINE_SERIAL or PICO_ENGINE_PIPELINED,
+ *             possibly or'ed with PICO_ENGINE_LOW_LATENCY and PICO_ENGINE_CEP_LOOKAHEAD
  * @return    the pointer to the PU object created if OK
  * @return    PICO_EXC_OUT_OF_MEM : no more memory available
  * @return    NULL otherwise
@@ -419,7 +830,8 @@ void picoctrl_disposeControl(picoos_MemoryManager mm,
  */
 picodata_ProcessingUnit picoctrl_newControl(picoos_MemoryManager mm,
         picoos_Common common, picodata_CharBuffer cbIn,
-        picodata_CharBuffer cbOut, picorsrc_Voice voice) {
+        picodata_CharBuffer cbOut, picorsrc_Voice voice,
+        picoos_int32 engineMode) {
     picoos_int16 i;
     register ctrl_subobj_t * ctrl;
     picodata_ProcessingUnit this = picodata_newProcessingUnit(mm, common, cbIn,
@@ -448,6 +860,25 @@ picodata_ProcessingUnit picoctrl_newControl(picoos_MemoryManager mm,
     }
     ctrl->numProcUnits = 0;
 
+    ctrl->lowLatency = (0 != (engineMode & PICO_ENGINE_LOW_LATENCY));
+    ctrl->cepLookahead = (picoos_uint16) ((engineMode & PICO_ENGINE_CEP_LOOKAHEAD_MASK) >> 8);
+    ctrl->firstSamplePending = FALSE;
+    ctrl->cancel = FALSE;
+    ctrl->pipelined = FALSE;
+    ctrl->splitPU = 0;
+    ctrl->feCurPU = 0;
+    ctrl->feThread = NULL;
+    ctrl->feLock = NULL;
+    ctrl->feCond = NULL;
+    ctrl->feState = CTRL_FE_BUSY;
+    ctrl->feStop = FALSE;
+    ctrl->beWaiting = FALSE;
+    if (engineMode & PICO_ENGINE_PIPELINED) {
+        ctrl->feLock = picoos_newMutex(mm);
+        ctrl->feCond = picoos_newCond(mm);
+        ctrl->pipelined = (NULL != ctrl->feLock) && (NULL != ctrl->feCond);
+    }
+
     if (
             (PICO_OK == ctrlAddPU(this,PICODATA_PUTYPE_TOK, FALSE, /*last*/FALSE)) &&
             (PICO_OK == ctrlAddPU(this,PICODATA_PUTYPE_PR, FALSE, FALSE)) &&
@@ -463,7 +894,11 @@ picodata_ProcessingUnit picoctrl_newControl(picoos_MemoryManager mm,
         /* we don't call ctrlInitialize here because ctrlAddPU does initialize the PUs allready and the only thing
          * remaining to initialize is:
          */
-        ctrl->curPU = 0;
+        if (ctrl->pipelined) {
+            /* CEP and SIG form the back-end */
+            ctrl->splitPU = ctrl->numProcUnits - 2;
+        }
+        ctrl->curPU = ctrl->splitPU;
         return this;
     } else {
         picoctrl_disposeControl(this->common->mm,&this);
@@ -497,13 +932,29 @@ void picoctrl_disposeControl(picoos_MemoryManager mm,
  */
 typedef struct picoctrl_engine {
     picoos_uint32 magic;        /* magic number used to validate handles */
-    void *raw_mem;
     picoos_Common common;
     picorsrc_Voice voice;
     picodata_ProcessingUnit control;
     picodata_CharBuffer cbIn, cbOut;
+    /* speech sink set by picoctrl_engSetSpeechSink, if any */
+    picoctrl_SpeechSink speechSink;
+    void * speechSinkData;
+    picoos_uint32 numSunk;      /* samples passed to the sink in the current fetch */
+    /* event sink set by picoctrl_engSetEventSink, if any */
+    picoctrl_EventSink eventSink;
+    void * eventSinkData;
+    picoos_bool inSentence;     /* speech passed to the sink since the last sentence end */
+    /* time to first sample */
+    picoos_uint8 uttState;      /* ENG_UTT_... */
+    picoos_uint32 uttStart;     /* time the current utterance was fed (usec) */
+    picoos_int32 timeToFirstSample; /* of the last utterance (usec), -1 if none */
 } picoctrl_engine_t;
 
+/* utterance states of the engine */
+#define ENG_UTT_IDLE     0 /* all output of the previous utterance fetched */
+#define ENG_UTT_WAITING  1 /* text fed, waiting for the first sample */
+#define ENG_UTT_SPEAKING 2 /* first sample output */
+
 
 #define MAGIC_MASK 0x5069436F  /* PiCo */
 
@@ -529,6 +980,8 @@ pico_status_t picoctrl_engReset(picoctrl_Engine this, picoos_int32 resetMode)
         return PICO_ERR_NULLPTR_ACCESS;
     }
     picoos_emReset(this->common->em);
+    this->inSentence = FALSE;
+    this->uttState = ENG_UTT_IDLE;
 
     status = this->control->terminate(this->control);
     if (PICO_OK == status) {
@@ -560,11 +1013,37 @@ picoos_int16 picoctrl_isValidEngineHandle(picoctrl_Engine this)
     return (this != NULL) && CHECK_MAGIC_NUMBER(this);
 }/*picoctrl_isValidEngineHandle*/
 
+/**
+ * releases everything an engine holds apart from its memory block: the
+ * front-end thread, the synchronization objects and the voice
+ * @param    rm : resource manager associated to the engine
+ * @param    this : the engine object
+ * @return    void
+ * @callgraph
+ * @callergraph
+ */
+static void engRelease(picorsrc_ResourceManager rm, picoctrl_Engine this)
+{
+    /* control first: it may run a thread still using the voice */
+    if (NULL != this->control) {
+        ctrlDisposeFrontEnd(this->control);
+    }
+    if (NULL != this->voice) {
+        picorsrc_releaseVoice(rm,&(this->voice));
+    }
+    if ((NULL != this->common) && (NULL != this->common->mm)) {
+        picoos_disposeExceptionManager(this->common->mm, &this->common->em);
+        picoos_disposeMemoryManager(&this->common->mm);
+    }
+}/*engRelease*/
+
 /**
  * creates a new engine object
  * @param    mm : memory manager to be used for this engine
  * @param    rm : resource manager to be used for this engine
  * @param    voiceName : voice definition to be used for this engine
+ * @param    engineMode : PICO_ENGINE_SERIAL or PICO_ENGINE_PIPELINED,
+ *             possibly or'ed with PICO_ENGINE_LOW_LATENCY and PICO_ENGINE_CEP_LOOKAHEAD
  * @return    PICO_OK : reset performed
  * @return    new engine handle
  * @return  NULL otherwise
@@ -572,18 +1051,39 @@ picoos_int16 picoctrl_isValidEngineHandle(picoctrl_Engine this)
  * @callergraph
  */
 picoctrl_Engine picoctrl_newEngine(picoos_MemoryManager mm,
-        picorsrc_ResourceManager rm, const picoos_char * voiceName) {
+        picorsrc_ResourceManager rm, const picoos_char * voiceName,
+        picoos_int32 engineMode) {
     picoos_uint8 done= TRUE;
 
     picoos_uint16 bSize;
+    picoos_objsize_t engSize = PICOCTRL_DEFAULT_ENGINE_SIZE;
+    void * raw_mem;
+    byte_ptr_t rest_mem;
+    picoos_objsize_t rest_mem_size;
 
     picoos_MemoryManager engMM;
     picoos_ExceptionManager engEM;
 
-    picoctrl_Engine this = (picoctrl_Engine) picoos_allocate(mm, sizeof(*this));
+    picoctrl_Engine this;
 
     PICODBG_DEBUG(("creating engine for voice '%s'",voiceName));
 
+#if !PICOPAL_HAVE_ATOMICS
+    /* the front-end and back-end threads share the cb between them without
+       locking, which needs the ordering of picopal_atomic_load/store */
+    engineMode &= ~PICO_ENGINE_PIPELINED;
+#endif
+
+    /* the engine object and everything it allocates share a single block of
+       the system memory; within the block, allocation is stack-wise */
+    if (engineMode & PICO_ENGINE_PIPELINED) {
+        engSize += PICOCTRL_PIPELINE_ENGINE_SIZE;
+    }
+    raw_mem = picoos_allocate(mm, sizeof(*this) + PICOOS_ALIGN_SIZE + engSize);
+    this = (picoctrl_Engine) picoos_raw_malloc(raw_mem,
+            sizeof(*this) + PICOOS_ALIGN_SIZE + engSize, sizeof(*this),
+            &rest_mem, &rest_mem_size);
+
     done = (NULL != this);
 
     if (done) {
@@ -593,16 +1093,18 @@ picoctrl_Engine picoctrl_newEngine(picoos_MemoryManager mm,
         this->control = NULL;
         this->cbIn = NULL;
         this->cbOut = NULL;
-
-        this->raw_mem = picoos_allocate(mm, PICOCTRL_DEFAULT_ENGINE_SIZE);
-        if (NULL == this->raw_mem) {
-            done = FALSE;
-        }
-    }
-
-    if (done) {
-        engMM = picoos_newMemoryManager(this->raw_mem, PICOCTRL_DEFAULT_ENGINE_SIZE,
-                    /*enableMemProt*/ FALSE);
+        this->speechSink = NULL;
+        this->speechSinkData = NULL;
+        this->numSunk = 0;
+        this->eventSink = NULL;
+        this->eventSinkData = NULL;
+        this->inSentence = FALSE;
+        this->uttState = ENG_UTT_IDLE;
+        this->uttStart = 0;
+        this->timeToFirstSample = -1;
+
+        engMM = picoos_newMemoryManagerEx(rest_mem, rest_mem_size,
+                    /*enableMemProt*/ FALSE, PICOOS_MEM_ARENA);
         done = (NULL != engMM);
     }
     if (done) {
@@ -614,6 +1116,12 @@ picoctrl_Engine picoctrl_newEngine(picoos_MemoryManager mm,
         this->common->mm = engMM;
         this->common->em = engEM;
 
+        if ((engineMode & PICO_ENGINE_PIPELINED)
+                && !(picoos_enableMemLock(engMM) && picoos_emEnableLock(engEM, engMM))) {
+            /* no thread support */
+            engineMode &= ~PICO_ENGINE_PIPELINED;
+        }
+
         done = (PICO_OK == picorsrc_createVoice(rm,voiceName,&(this->voice)));
     }
     if (done)  {
@@ -630,7 +1138,7 @@ picoctrl_Engine picoctrl_newEngine(picoos_MemoryManager mm,
 
 
         this->control = picoctrl_newControl(this->common->mm, this->common,
-                this->cbIn, this->cbOut, this->voice);
+                this->cbIn, this->cbOut, this->voice, engineMode);
         done = (NULL != this->cbIn) && (NULL != this->cbOut)
                 && (NULL != this->control);
     }
@@ -638,20 +1146,17 @@ picoctrl_Engine picoctrl_newEngine(picoos_MemoryManager mm,
         SET_MAGIC_NUMBER(this);
     } else {
         if (NULL != this) {
-            if (NULL != this->voice) {
-                picorsrc_releaseVoice(rm,&(this->voice));
-            }
-            if(NULL != this->raw_mem) {
-                picoos_deallocate(mm,&(this->raw_mem));
-            }
-            picoos_deallocate(mm,(void *)&this);
+            engRelease(rm, this);
+            this = NULL;
         }
+        picoos_deallocate(mm, &raw_mem);
     }
     return this;
 }/*picoctrl_newEngine*/
 
 /**
- * disposes an engine object
+ * disposes an engine object; the objects within the engine memory block
+ * are not disposed one by one, the block is released as a whole
  * @param    mm : memory manager associated to the engine
  * @param    rm : resource manager associated to the engine
  * @param    this : handle of the engine to dispose
@@ -663,18 +1168,15 @@ picoctrl_Engine picoctrl_newEngine(picoos_MemoryManager mm,
 void picoctrl_disposeEngine(picoos_MemoryManager mm, picorsrc_ResourceManager rm,
         picoctrl_Engine * this)
 {
+    void * raw_mem;
+
     if (NULL != (*this)) {
-        if (NULL != (*this)->voice) {
-            picorsrc_releaseVoice(rm,&((*this)->voice));
-        }
-        if(NULL != (*this)->control) {
-            picoctrl_disposeControl((*this)->common->mm,&((*this)->control));
-        }
-        if(NULL != (*this)->raw_mem) {
-            picoos_deallocate(mm,&((*this)->raw_mem));
-        }
+        engRelease(rm, *this);
         (*this)->magic ^= 0xFFFEFDFC;
-        picoos_deallocate(mm,(void **)this);
+        /* the engine object is at the start of its memory block */
+        raw_mem = (void *) (*this);
+        picoos_deallocate(mm, &raw_mem);
+        *this = NULL;
     }
 }/*picoctrl_disposeEngine*/
 
@@ -722,7 +1224,7 @@ picoos_Common picoctrl_engGetCommon(picoctrl_Engine this) {
  */
 pico_status_t picoctrl_engFeedText(picoctrl_Engine this,
         picoos_char * text,
-        picoos_int16 textSize, picoos_int16 * bytesPut) {
+        picoos_int32 textSize, picoos_int32 * bytesPut) {
     if (NULL == this) {
         return PICO_ERR_OTHER;
     }
@@ -731,66 +1233,314 @@ pico_status_t picoctrl_engFeedText(picoctrl_Engine this,
     while ((*bytesPut < textSize) && (PICO_OK == picodata_cbPutCh(this->cbIn, text[*bytesPut]))) {
         (*bytesPut)++;
     }
+    if (*bytesPut > 0) {
+        if (ENG_UTT_IDLE == this->uttState) {
+            /* start of an utterance; a cancellation requested before
+               applied to the previous one */
+            picopal_atomic_store(&((ctrl_subobj_t *) this->control->subObj)->cancel, FALSE);
+            this->uttState = ENG_UTT_WAITING;
+            this->uttStart = picoos_get_usec();
+            picopal_atomic_store(&((ctrl_subobj_t *) this->control->subObj)->firstSamplePending, TRUE);
+        }
+        ctrlInputAvailable(this->control);
+    }
 
     return PICO_OK;
 }/*picoctrl_engFeedText*/
 
 /**
- * gets engine output bytes
+ * discards the input text and all items in the PUs and cbs after a
+ * cancellation; unlike the text analysis state, the DSP state of the signal
+ * generation is kept (as with a soft reset). Unlike picoctrl_engReset, the
+ * text analysis thread of a pipelined engine keeps running.
+ * @param    this : handle of the engine
+ * @return    PICO_WARN_CANCELLED : items discarded
+ * @return    PICO_STEP_ERROR : if error
+ * @callgraph
+ * @callergraph
+ */
+static picodata_step_result_t engDiscard(picoctrl_Engine this)
+{
+    picoos_emReset(this->common->em);
+    this->inSentence = FALSE;
+    this->uttState = ENG_UTT_IDLE;
+    if (PICO_OK != ctrlDiscard(this->control)) {
+        return (picodata_step_result_t)PICO_STEP_ERROR;
+    }
+    return (picodata_step_result_t)PICO_WARN_CANCELLED;
+}/*engDiscard*/
+
+/**
+ * records the time to first sample of the current utterance and ends the
+ * low latency scheduling for it
+ * @param    this : handle of the engine
+ * @return    void
+ * @callgraph
+ * @callergraph
+ */
+static void engFirstSample(picoctrl_Engine this)
+{
+    this->timeToFirstSample = (picoos_int32) (picoos_get_usec() - this->uttStart);
+    this->uttState = ENG_UTT_SPEAKING;
+    picopal_atomic_store(&((ctrl_subobj_t *) this->control->subObj)->firstSamplePending, FALSE);
+    PICODBG_DEBUG(("time to first sample: %d usec", this->timeToFirstSample));
+}/*engFirstSample*/
+
+/**
+ * gets engine output bytes; the engine is stepped until 'buffer' is full, no
+ * more output item fits into it, or the engine is idle
  * @param    this : handle of the engine
  * @param    buffer : the destination buffer
  * @param    bufferSize : max size of the destinatioon buffer
  * @param    *bytesReceived : the number of bytes effectively returned
- * @return    PICO_OK : feeding succeded
- * @return    PICO_ERR_OTHER : if error
+ * @return    PICO_STEP_BUSY : more output may follow
+ * @return    PICO_STEP_IDLE : all input processed, no output returned
+ * @return    PICO_WARN_CANCELLED : cancellation requested; all input discarded
+ * @return    PICO_STEP_ERROR : if error
  * @callgraph
  * @callergraph
  */
 picodata_step_result_t picoctrl_engFetchOutputItemBytes(
         picoctrl_Engine this,
         picoos_char *buffer,
-        picoos_int16 bufferSize,
-        picoos_int16 *bytesReceived) {
+        picoos_int32 bufferSize,
+        picoos_int32 *bytesReceived) {
     picoos_uint16 ui;
+    picoos_int32 space;
     picodata_step_result_t stepResult;
     pico_status_t rv;
 
     if (NULL == this) {
         return (picodata_step_result_t)PICO_STEP_ERROR;
     }
-    PICODBG_DEBUG(("doing one step"));
-    stepResult = this->control->step(this->control,/* mode */0,&ui);
-    if (PICODATA_PU_ERROR != stepResult) {
-        PICODBG_TRACE(("filling output buffer"));
-        rv = picodata_cbGetSpeechData(this->cbOut, (picoos_uint8 *)buffer,
-                                      bufferSize, &ui);
-
-        if (ui > 255) {   /* because picoapi uses signed int16 */
+    *bytesReceived = 0;
+    this->numSunk = 0;
+    do {
+        PICODBG_DEBUG(("doing one step"));
+        stepResult = this->control->step(this->control,/* mode */0,&ui);
+        if (PICODATA_PU_ERROR == stepResult) {
+            PICODBG_DEBUG(("ERROR"));
             return (picodata_step_result_t)PICO_STEP_ERROR;
-        } else {
-            *bytesReceived = ui;
         }
-        if ((rv == PICO_EXC_BUF_UNDERFLOW) || (rv == PICO_EXC_BUF_OVERFLOW)) {
+        /* checked after the step: a cancelled step may end early, reporting idle */
+        if (picopal_atomic_load(&((ctrl_subobj_t *) this->control->subObj)->cancel)) {
+            return engDiscard(this);
+        }
+        PICODBG_TRACE(("filling output buffer"));
+        do {
+            /* items are much smaller than 64K; larger space need not be passed on */
+            space = bufferSize - *bytesReceived;
+            rv = picodata_cbGetSpeechData(this->cbOut,
+                    (picoos_uint8 *)buffer + *bytesReceived,
+                    (picoos_uint16) ((space > 0xffff) ? 0xffff : space), &ui);
+            *bytesReceived += ui;
+        } while (PICO_OK == rv);
+        /* overflow is only an error if not even one item fits into the buffer */
+        if ((rv == PICO_EXC_BUF_UNDERFLOW)
+                || ((rv == PICO_EXC_BUF_OVERFLOW) && (0 == *bytesReceived))) {
             PICODBG_ERROR(("problem getting speech data"));
             return (picodata_step_result_t)PICO_STEP_ERROR;
         }
-        /* rv must now be PICO_OK or PICO_EOF */
-        PICODBG_ASSERT(((PICO_EOF == rv) || (PICO_OK == rv)));
-        if ((PICODATA_PU_IDLE == stepResult) && (PICO_EOF == rv)) {
-            PICODBG_DEBUG(("IDLE"));
-            return (picodata_step_result_t)PICO_STEP_IDLE;
-        } else if (PICODATA_PU_ERROR == stepResult) {
-            PICODBG_DEBUG(("ERROR"));
-            return (picodata_step_result_t)PICO_STEP_ERROR;
-        } else {
-            PICODBG_DEBUG(("BUSY"));
-            return (picodata_step_result_t)PICO_STEP_BUSY;
+        /* rv must now be PICO_EOF, or PICO_EXC_BUF_OVERFLOW with 'buffer' filled */
+        if ((ENG_UTT_WAITING == this->uttState)
+                && ((*bytesReceived > 0) || (this->numSunk > 0))) {
+            engFirstSample(this);
+            if (((ctrl_subobj_t *) this->control->subObj)->lowLatency) {
+                /* pass the first samples on without waiting for more */
+                break;
+            }
         }
+    } while ((PICO_EOF == rv) && (PICODATA_PU_IDLE != stepResult)
+             && (*bytesReceived < bufferSize) && (0 == this->numSunk));
+
+    if ((PICODATA_PU_IDLE == stepResult) && (PICO_EOF == rv) && (0 == *bytesReceived)
+            && (0 == this->numSunk)) {
+        PICODBG_DEBUG(("IDLE"));
+        this->uttState = ENG_UTT_IDLE;
+        picopal_atomic_store(&((ctrl_subobj_t *) this->control->subObj)->firstSamplePending, FALSE);
+        return (picodata_step_result_t)PICO_STEP_IDLE;
     } else {
-        return (picodata_step_result_t)PICO_STEP_ERROR;
+        PICODBG_DEBUG(("BUSY"));
+        return (picodata_step_result_t)PICO_STEP_BUSY;
     }
 }/*picoctrl_engFetchOutputItemBytes*/
 
+/**
+ * passes the items put into the output cb on to the engine's sinks: speech
+ * data to the speech sink, marks and sentence ends to the event sink
+ * @param    userData : the engine
+ * @param    item : the item, in place in the buffer of the last PU
+ * @param    blen : length of the item
+ * @return    void
+ * @callgraph
+ * @callergraph
+ */
+static void engItemSink(void * userData, const picoos_uint8 * item,
+        picoos_uint16 blen)
+{
+    picoctrl_Engine this = (picoctrl_Engine) userData;
+    picoos_char name[PICODATA_MAX_ITEMSIZE];
+    picoos_uint16 numSamples;
+
+    blen = blen;        /* avoid warning "var not used in this function" */
+    switch (item[PICODATA_ITEMIND_TYPE]) {
+        case PICODATA_ITEM_FRAME:
+            numSamples = (picoos_uint16) (item[PICODATA_ITEMIND_LEN] / sizeof(picoos_int16));
+            this->numSunk += numSamples;
+            this->inSentence = TRUE;
+            this->speechSink(this->speechSinkData,
+                    (const picoos_int16 *) &item[PICODATA_ITEM_HEADSIZE], numSamples);
+            break;
+        case PICODATA_ITEM_CMD:
+            if ((NULL != this->eventSink)
+                    && (PICODATA_ITEMINFO1_CMD_MARKER == item[PICODATA_ITEMIND_INFO1])) {
+                picoos_mem_copy(&item[PICODATA_ITEM_HEADSIZE], name,
+                        item[PICODATA_ITEMIND_LEN]);
+                name[item[PICODATA_ITEMIND_LEN]] = '\0';
+                this->eventSink(this->eventSinkData, PICOCTRL_EVENT_MARK, name);
+            }
+            break;
+        case PICODATA_ITEM_BOUND:
+            /* a flush following a sentence end is no sentence of its own */
+            if (this->inSentence
+                    && ((PICODATA_ITEMINFO1_BOUND_SEND == item[PICODATA_ITEMIND_INFO1])
+                        || (PICODATA_ITEMINFO1_BOUND_TERM == item[PICODATA_ITEMIND_INFO1]))) {
+                this->inSentence = FALSE;
+                if (NULL != this->eventSink) {
+                    this->eventSink(this->eventSinkData, PICOCTRL_EVENT_SENTENCE, NULL);
+                }
+            }
+            break;
+        default:
+            /* not part of the engine output */
+            break;
+    }
+}
+
+/**
+ * requests the cancellation of the current utterance; may be called from any
+ * thread, e.g. while another one is fetching output. The PUs are not stepped
+ * any more, and the next (or current) fetch discards all input and items.
+ * A cancellation requested while the engine is idle has no effect.
+ * @param    this : handle of the engine
+ * @return    PICO_OK : cancellation requested
+ * @return    PICO_ERR_OTHER : if error
+ * @callgraph
+ * @callergraph
+ */
+pico_status_t picoctrl_engCancel(picoctrl_Engine this)
+{
+    if (NULL == this) {
+        return PICO_ERR_OTHER;
+    }
+    ctrlCancel(this->control);
+    return PICO_OK;
+}/*picoctrl_engCancel*/
+
+/**
+ * sets a sink to which the speech data is passed directly by the last PU,
+ * bypassing the output cb and the buffer of picoctrl_engFetchOutputItemBytes;
+ * while a sink is set, a fetch returns after each step producing speech
+ * @param    this : handle of the engine
+ * @param    sink : the sink, or NULL to fetch speech data into buffers again
+ * @param    userData : passed on to the sink
+ * @return    PICO_OK : sink set
+ * @return    PICO_ERR_OTHER : if error
+ * @callgraph
+ * @callergraph
+ */
+pico_status_t picoctrl_engSetSpeechSink(picoctrl_Engine this,
+        picoctrl_SpeechSink sink, void * userData)
+{
+    if (NULL == this) {
+        return PICO_ERR_OTHER;
+    }
+    this->speechSink = sink;
+    this->speechSinkData = userData;
+    picodata_cbSetItemSink(this->cbOut, (NULL == sink) ? NULL : engItemSink, this);
+    return PICO_OK;
+}/*picoctrl_engSetSpeechSink*/
+
+/**
+ * returns the speech sink set by picoctrl_engSetSpeechSink and its user data
+ * @param    this : handle of the engine
+ * @param    sink : the sink, NULL if none is set
+ * @param    userData : the user data of the sink
+ * @return    PICO_OK : sink returned
+ * @return    PICO_ERR_OTHER : if error
+ * @callgraph
+ * @callergraph
+ */
+pico_status_t picoctrl_engGetSpeechSink(picoctrl_Engine this,
+        picoctrl_SpeechSink * sink, void * * userData)
+{
+    if (NULL == this) {
+        return PICO_ERR_OTHER;
+    }
+    *sink = this->speechSink;
+    *userData = this->speechSinkData;
+    return PICO_OK;
+}/*picoctrl_engGetSpeechSink*/
+
+/**
+ * sets a sink to which marks and sentence ends are passed in order with
+ * the speech data; only used while a speech sink is set
+ * @param    this : handle of the engine
+ * @param    sink : the sink, or NULL
+ * @param    userData : passed on to the sink
+ * @return    PICO_OK : sink set
+ * @return    PICO_ERR_OTHER : if error
+ * @callgraph
+ * @callergraph
+ */
+pico_status_t picoctrl_engSetEventSink(picoctrl_Engine this,
+        picoctrl_EventSink sink, void * userData)
+{
+    if (NULL == this) {
+        return PICO_ERR_OTHER;
+    }
+    this->eventSink = sink;
+    this->eventSinkData = userData;
+    return PICO_OK;
+}/*picoctrl_engSetEventSink*/
+
+/**
+ * returns the event sink set by picoctrl_engSetEventSink and its user data
+ * @param    this : handle of the engine
+ * @param    sink : the sink, NULL if none is set
+ * @param    userData : the user data of the sink
+ * @return    PICO_OK : sink returned
+ * @return    PICO_ERR_OTHER : if error
+ * @callgraph
+ * @callergraph
+ */
+pico_status_t picoctrl_engGetEventSink(picoctrl_Engine this,
+        picoctrl_EventSink * sink, void * * userData)
+{
+    if (NULL == this) {
+        return PICO_ERR_OTHER;
+    }
+    *sink = this->eventSink;
+    *userData = this->eventSinkData;
+    return PICO_OK;
+}/*picoctrl_engGetEventSink*/
+
+/**
+ * returns the time from feeding the first text of the last utterance
+ * (after the engine had been idle or reset) to the first output of speech
+ * @param    this : handle of the engine
+ * @return    time in microseconds; -1 if no utterance produced speech yet
+ * @callgraph
+ * @callergraph
+ */
+picoos_int32 picoctrl_engGetTimeToFirstSample(picoctrl_Engine this)
+{
+    if (NULL == this) {
+        return -1;
+    }
+    return this->timeToFirstSample;
+}/*picoctrl_engGetTimeToFirstSample*/
+
 /**
  * returns the last scheduled PU
  * @param    this : handle of the engine
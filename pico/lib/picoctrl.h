@@ -44,7 +44,9 @@ extern "C" {
 /* temporarily increased for preprocessing
 #define PICOCTRL_DEFAULT_ENGINE_SIZE 200000
 */
-#define PICOCTRL_DEFAULT_ENGINE_SIZE 1000000
+/* also holds the float32 work areas of CEP, SIG and their transform plan
+   with PICODSP_FLOAT (see picodsp.h) */
+#define PICOCTRL_DEFAULT_ENGINE_SIZE 1004000
 
 typedef struct picoctrl_engine * picoctrl_Engine;
 
@@ -53,7 +55,8 @@ picoos_int16 picoctrl_isValidEngineHandle(picoctrl_Engine this);
 picoctrl_Engine picoctrl_newEngine (
         picoos_MemoryManager mm,
         picorsrc_ResourceManager rm,
-        const picoos_char * voiceName
+        const picoos_char * voiceName,
+        picoos_int32 engineMode
         );
 
 void picoctrl_disposeEngine(
@@ -65,8 +68,8 @@ void picoctrl_disposeEngine(
 pico_status_t picoctrl_engFeedText(
         picoctrl_Engine engine,
         picoos_char * text,
-        picoos_int16  textSize,
-        picoos_int16 * bytesPut);
+        picoos_int32  textSize,
+        picoos_int32 * bytesPut);
 
 pico_status_t picoctrl_engReset(
         picoctrl_Engine engine,
@@ -74,13 +77,54 @@ pico_status_t picoctrl_engReset(
 
 picoos_Common picoctrl_engGetCommon(picoctrl_Engine this);
 
+pico_status_t picoctrl_engCancel(picoctrl_Engine engine);
+
 picodata_step_result_t picoctrl_engFetchOutputItemBytes(
         picoctrl_Engine engine,
         picoos_char * buffer,
-        picoos_int16 bufferSize,
-        picoos_int16  * bytesReceived
+        picoos_int32 bufferSize,
+        picoos_int32  * bytesReceived
 );
 
+/* receives speech data directly from the last PU */
+typedef void (* picoctrl_SpeechSink) (void * userData,
+        const picoos_int16 * samples, picoos_uint16 numSamples);
+
+pico_status_t picoctrl_engSetSpeechSink(
+        picoctrl_Engine engine,
+        picoctrl_SpeechSink sink,
+        void * userData
+        );
+
+pico_status_t picoctrl_engGetSpeechSink(
+        picoctrl_Engine engine,
+        picoctrl_SpeechSink * sink,
+        void * * userData
+        );
+
+/* events passed to a picoctrl_EventSink */
+#define PICOCTRL_EVENT_MARK       1  /* <mark> reached; 'name' is its name */
+#define PICOCTRL_EVENT_SENTENCE   2  /* end of sentence; 'name' is NULL */
+
+typedef void (* picoctrl_EventSink) (void * userData,
+        picoos_uint8 event, const picoos_char * name);
+
+pico_status_t picoctrl_engSetEventSink(
+        picoctrl_Engine engine,
+        picoctrl_EventSink sink,
+        void * userData
+        );
+
+pico_status_t picoctrl_engGetEventSink(
+        picoctrl_Engine engine,
+        picoctrl_EventSink * sink,
+        void * * userData
+        );
+
+picoos_int32 picoctrl_engGetTimeToFirstSample(
+        picoctrl_Engine engine
+        );
+
 void picoctrl_engResetExceptionManager(
         picoctrl_Engine this
         );
@@ -64,8 +64,16 @@ typedef struct picodata_char_buffer
     picoos_char *buf;
     picoos_uint16 rear; /* next free position to write */
     picoos_uint16 front; /* next position to read */
-    picoos_uint16 len; /* empty: len = 0, full: len = size */
     picoos_uint16 size;
+    /* buf[size..size+mirror-1] mirrors buf[0..mirror-1], so that every item
+       starting at 'front' (and every reserved slice starting at 'rear') is
+       contiguous in buf */
+    picoos_uint16 mirror;
+    /* running byte counts; numPut is only written by the producer and numGot
+       only by the consumer, so that one producer and one consumer thread may
+       use the cb concurrently. empty: numPut = numGot, full: difference = size */
+    picoos_uint32 numPut;
+    picoos_uint32 numGot;
 
     picoos_Common common;
 
@@ -75,6 +83,10 @@ typedef struct picodata_char_buffer
     picodata_cbSubResetMethod subReset;
     picodata_cbSubDeallocateMethod subDeallocate;
     void * subObj;
+
+    /* if set, receives all items put in place of the cb */
+    picodata_cbItemSink itemSink;
+    void * itemSinkData;
 } char_buffer_t;
 
 
@@ -86,11 +98,52 @@ static pico_status_t data_cbGetItem(register picodata_CharBuffer this,
         picoos_uint8 *buf, const picoos_uint16 blenmax,
         picoos_uint16 *blen, const picoos_uint8 issd);
 
+/* number of bytes in cb, as seen by either side */
+#define CB_LEN(this) ((picoos_uint16) (picopal_atomic_load(&(this)->numPut) \
+                                       - picopal_atomic_load(&(this)->numGot)))
+
+/* publish 'n' bytes written at rear (producer side) */
+static void cbPut(register picodata_CharBuffer this, picoos_uint16 n)
+{
+    this->rear = (this->rear + n) % this->size;
+    picopal_atomic_store(&this->numPut, this->numPut + n);
+}
+
+/* publish 'n' bytes written contiguously at &buf[rear], possibly reaching
+   into the mirror area (producer side): bytes written past the end of the
+   ring are copied to its start, bytes written at the start of the ring are
+   copied to the mirror area */
+static void cbCommitPut(register picodata_CharBuffer this, picoos_uint16 n)
+{
+    picoos_uint32 end = (picoos_uint32) this->rear + n;
+
+    if (end > this->size) {
+        picoos_mem_copy(&this->buf[this->size], this->buf, end - this->size);
+        end = this->size;
+    }
+    if (this->rear < this->mirror) {
+        if (end > this->mirror) {
+            end = this->mirror;
+        }
+        picoos_mem_copy(&this->buf[this->rear], &this->buf[this->size + this->rear],
+                        end - this->rear);
+    }
+    cbPut(this, n);
+}
+
+/* release 'n' bytes read at front (consumer side) */
+static void cbGot(register picodata_CharBuffer this, picoos_uint16 n)
+{
+    this->front = (this->front + n) % this->size;
+    picopal_atomic_store(&this->numGot, this->numGot + n);
+}
+
 pico_status_t picodata_cbReset(register picodata_CharBuffer this)
 {
     this->rear = 0;
     this->front = 0;
-    this->len = 0;
+    this->numPut = 0;
+    this->numGot = 0;
     if (NULL != this->subObj) {
         return this->subReset(this);
     } else {
@@ -110,7 +163,8 @@ picodata_CharBuffer picodata_newCharBuffer(picoos_MemoryManager mm,
     if (NULL == this) {
         return NULL;
     }
-    this->buf = picoos_allocate(mm, size);
+    this->mirror = (size < PICODATA_MAX_ITEMSIZE) ? size : PICODATA_MAX_ITEMSIZE;
+    this->buf = picoos_allocate(mm, size + this->mirror);
     if (NULL == this->buf) {
         picoos_deallocate(mm, (void*) &this);
         return NULL;
@@ -125,6 +179,9 @@ picodata_CharBuffer picodata_newCharBuffer(picoos_MemoryManager mm,
     this->subDeallocate = NULL;
     this->subObj = NULL;
 
+    this->itemSink = NULL;
+    this->itemSinkData = NULL;
+
     picodata_cbReset(this);
     return this;
 }
@@ -145,10 +202,12 @@ void picodata_disposeCharBuffer(picoos_MemoryManager mm,
 pico_status_t picodata_cbPutCh(register picodata_CharBuffer this,
                                picoos_char ch)
 {
-    if (this->len < this->size) {
-        this->buf[this->rear++] = ch;
-        this->rear %= this->size;
-        this->len++;
+    if (CB_LEN(this) < this->size) {
+        this->buf[this->rear] = ch;
+        if (this->rear < this->mirror) {
+            this->buf[this->size + this->rear] = ch;
+        }
+        cbPut(this, 1);
         return PICO_OK;
     } else {
         return PICO_EXC_BUF_OVERFLOW;
@@ -159,10 +218,9 @@ pico_status_t picodata_cbPutCh(register picodata_CharBuffer this,
 picoos_int16 picodata_cbGetCh(register picodata_CharBuffer this)
 {
     picoos_char ch;
-    if (this->len > 0) {
-        ch = this->buf[this->front++];
-        this->front %= this->size;
-        this->len--;
+    if (CB_LEN(this) > 0) {
+        ch = this->buf[this->front];
+        cbGot(this, 1);
         return ch;
     } else {
         return PICO_EOF;
@@ -177,11 +235,14 @@ static pico_status_t data_cbGetItem(register picodata_CharBuffer this,
         picoos_uint8 *buf, const picoos_uint16 blenmax,
         picoos_uint16 *blen, const picoos_uint8 issd)
 {
+#if defined(PICO_DEBUG)
     picoos_uint16 i;
+#endif
+    picoos_uint16 len = CB_LEN(this);
 
-    if (this->len < PICODATA_ITEM_HEADSIZE) {    /* item not in cb? */
+    if (len < PICODATA_ITEM_HEADSIZE) {    /* item not in cb? */
         *blen = 0;
-        if (this->len == 0) {    /* is cb empty? */
+        if (len == 0) {    /* is cb empty? */
             PICODBG_DEBUG(("no item to get"));
             return PICO_EOF;
         } else {    /* cb not empty, but not a valid item */
@@ -189,8 +250,8 @@ static pico_status_t data_cbGetItem(register picodata_CharBuffer this,
         }
         return PICO_EXC_BUF_UNDERFLOW;
     }
-    *blen = PICODATA_ITEM_HEADSIZE + (picoos_uint8)(this->buf[((this->front) +
-                                      PICODATA_ITEMIND_LEN) % this->size]);
+    *blen = PICODATA_ITEM_HEADSIZE +
+            (picoos_uint8)(this->buf[this->front + PICODATA_ITEMIND_LEN]);
 
     /* if getting speech data in item */
     if (issd) {
@@ -198,19 +259,15 @@ static pico_status_t data_cbGetItem(register picodata_CharBuffer this,
         if (this->buf[this->front] != PICODATA_ITEM_FRAME) {
             PICODBG_WARN(("item type mismatch for speech data: %c",
                           this->buf[this->front]));
-            for (i=0; i<*blen; i++) {
-                this->front++;
-                this->front %= this->size;
-                this->len--;
-            }
+            cbGot(this, *blen);
             *blen = 0;
             return PICO_OK;
         }
     }
 
-    if (*blen > this->len) {    /* item in cb not complete? */
+    if (*blen > len) {    /* item in cb not complete? */
         PICODBG_WARN(("problem getting item, incomplete content, underflow; "
-                      "blen=%d, len=%d", *blen, this->len));
+                      "blen=%d, len=%d", *blen, len));
         *blen = 0;
         return PICO_EXC_BUF_UNDERFLOW;
     }
@@ -223,20 +280,14 @@ static pico_status_t data_cbGetItem(register picodata_CharBuffer this,
     /* if getting speech data in item */
     if (issd) {
         /* skip item header */
-        for (i = 0; i < PICODATA_ITEM_HEADSIZE; i++) {
-            this->front++;
-            this->front %= this->size;
-            this->len--;
-        }
+        cbGot(this, PICODATA_ITEM_HEADSIZE);
         *blen -= PICODATA_ITEM_HEADSIZE;
     }
 
-    /* all ok, now get item (or speech data only) */
-    for (i = 0; i < *blen; i++) {
-        buf[i] = (picoos_uint8)(this->buf[this->front++]);
-        this->front %= this->size;
-        this->len--;
-    }
+    /* all ok, now get item (or speech data only); contiguous thanks to the
+       mirror area */
+    picoos_mem_copy(&this->buf[this->front], buf, *blen);
+    cbGot(this, *blen);
 
 #if defined(PICO_DEBUG)
     if (issd) {
@@ -262,7 +313,9 @@ static pico_status_t data_cbPutItem(register picodata_CharBuffer this,
         const picoos_uint8 *buf, const picoos_uint16 blenmax,
         picoos_uint16 *blen)
 {
+#if defined(PICO_DEBUG)
     picoos_uint16 i;
+#endif
 
     if (blenmax < PICODATA_ITEM_HEADSIZE) {    /* itemlen not accessible? */
         PICODBG_WARN(("problem putting item, underflow"));
@@ -270,16 +323,21 @@ static pico_status_t data_cbPutItem(register picodata_CharBuffer this,
         return PICO_EXC_BUF_UNDERFLOW;
     }
     *blen = buf[PICODATA_ITEMIND_LEN] + PICODATA_ITEM_HEADSIZE;
-    if (*blen > (this->size - this->len)) {    /* cb not enough space? */
-        PICODBG_WARN(("problem putting item, overflow"));
-        *blen = 0;
-        return PICO_EXC_BUF_OVERFLOW;
-    }
     if (*blen > blenmax) {    /* item in buf not completely accessible? */
         PICODBG_WARN(("problem putting item, underflow"));
         *blen = 0;
         return PICO_EXC_BUF_UNDERFLOW;
     }
+    if (NULL != this->itemSink) {
+        /* pass the item on directly from 'buf' */
+        this->itemSink(this->itemSinkData, buf, *blen);
+        return PICO_OK;
+    }
+    if (*blen > (this->size - CB_LEN(this))) {    /* cb not enough space? */
+        PICODBG_WARN(("problem putting item, overflow"));
+        *blen = 0;
+        return PICO_EXC_BUF_OVERFLOW;
+    }
     /* all ok, now put complete item */
 
 #if defined(PICO_DEBUG)
@@ -297,12 +355,8 @@ static pico_status_t data_cbPutItem(register picodata_CharBuffer this,
     }
 #endif
 
-    for (i = 0; i < *blen; i++) {
-        /* put single byte */
-        this->buf[this->rear++] = (picoos_char)buf[i];
-        this->rear %= this->size;
-        this->len++;
-    }
+    picoos_mem_copy(buf, &this->buf[this->rear], *blen);
+    cbCommitPut(this, *blen);
     return PICO_OK;
 }
 
@@ -342,11 +396,79 @@ pico_status_t picodata_cbPutItem(register picodata_CharBuffer this,
         return this->putItem(this,buf,blenmax,blen);
 }
 
+pico_status_t picodata_cbPeekItem(register picodata_CharBuffer this,
+        const picoos_uint8 **item, picoos_uint16 *blen)
+{
+    picoos_uint16 len = CB_LEN(this);
+
+    *item = NULL;
+    *blen = 0;
+    if (len < PICODATA_ITEM_HEADSIZE) {
+        return (len == 0) ? PICO_EOF : PICO_EXC_BUF_UNDERFLOW;
+    }
+    len = PICODATA_ITEM_HEADSIZE +
+          (picoos_uint8)(this->buf[this->front + PICODATA_ITEMIND_LEN]);
+    if (len > CB_LEN(this)) {
+        return PICO_EXC_BUF_UNDERFLOW;
+    }
+    *item = (const picoos_uint8 *) &this->buf[this->front];
+    *blen = len;
+    return PICO_OK;
+}
+
+pico_status_t picodata_cbCommitGet(register picodata_CharBuffer this,
+        const picoos_uint16 blen)
+{
+    if (blen > CB_LEN(this)) {
+        return PICO_EXC_BUF_UNDERFLOW;
+    }
+    cbGot(this, blen);
+    return PICO_OK;
+}
+
+pico_status_t picodata_cbReserve(register picodata_CharBuffer this,
+        picoos_uint8 **buf, const picoos_uint16 blen)
+{
+    if ((blen > this->mirror) || (blen > (this->size - CB_LEN(this)))) {
+        *buf = NULL;
+        return PICO_EXC_BUF_OVERFLOW;
+    }
+    *buf = (picoos_uint8 *) &this->buf[this->rear];
+    return PICO_OK;
+}
+
+pico_status_t picodata_cbCommitPut(register picodata_CharBuffer this,
+        const picoos_uint16 blen)
+{
+    if ((blen > this->mirror) || (blen > (this->size - CB_LEN(this)))) {
+        return PICO_EXC_BUF_OVERFLOW;
+    }
+    cbCommitPut(this, blen);
+    return PICO_OK;
+}
+
+void picodata_cbSetItemSink(register picodata_CharBuffer this,
+        picodata_cbItemSink sink, void * userData)
+{
+    this->itemSink = sink;
+    this->itemSinkData = userData;
+}
+
 /* unsafe, just for measuring purposes */
 picoos_uint8 picodata_cbGetFrontItemType(register picodata_CharBuffer this)
 {
     return  this->buf[this->front];
 }
+
+picoos_uint16 picodata_cbGetLen(register picodata_CharBuffer this)
+{
+    return CB_LEN(this);
+}
+
+picoos_uint16 picodata_cbGetSpace(register picodata_CharBuffer this)
+{
+    return this->size - CB_LEN(this);
+}
 /* ***************************************************************
  *                   items: support function                     *
  *****************************************************************/
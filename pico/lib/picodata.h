@@ -325,9 +325,52 @@ pico_status_t picodata_cbPutItem(register picodata_CharBuffer this,
         const picoos_uint8 *buf, const picoos_uint16 blenmax,
         picoos_uint16 *blen);
 
+/* zero-copy item access. Every item in a CharBuffer, and every slice of up
+   to PICODATA_MAX_ITEMSIZE bytes reserved for writing, is contiguous in
+   memory, also if it wraps around the end of the ring. As with the other
+   functions, one producer and one consumer thread may use a cb concurrently.
+
+   picodata_cbPeekItem sets item to the front item (head and content) in
+   place and blen to its length, without removing it; the item stays valid
+   until it is released with picodata_cbCommitGet(this, blen). Return values
+   as for picodata_cbGetItem, except that there is no PICO_EXC_BUF_OVERFLOW.
+
+   picodata_cbReserve sets buf to blen writable bytes at the rear of the cb
+   (PICO_EXC_BUF_OVERFLOW if there is not enough space);
+   picodata_cbCommitPut(this, blen) then makes them visible to the consumer.
+*/
+pico_status_t picodata_cbPeekItem(register picodata_CharBuffer this,
+        const picoos_uint8 **item, picoos_uint16 *blen);
+
+pico_status_t picodata_cbCommitGet(register picodata_CharBuffer this,
+        const picoos_uint16 blen);
+
+pico_status_t picodata_cbReserve(register picodata_CharBuffer this,
+        picoos_uint8 **buf, const picoos_uint16 blen);
+
+pico_status_t picodata_cbCommitPut(register picodata_CharBuffer this,
+        const picoos_uint16 blen);
+
+/* sets a sink that receives all items put into the cb from then on,
+   instead of the cb itself: the sink is called by picodata_cbPutItem with
+   the item (head and content) in place in the producer's buffer, so that
+   e.g. speech data need not be copied through the cb. A NULL sink restores
+   normal operation */
+typedef void (* picodata_cbItemSink) (void * userData,
+        const picoos_uint8 * item, picoos_uint16 blen);
+
+void picodata_cbSetItemSink(register picodata_CharBuffer this,
+        picodata_cbItemSink sink, void * userData);
+
 /* unsafe, just for measuring purposes */
 picoos_uint8 picodata_cbGetFrontItemType(register picodata_CharBuffer this);
 
+/* number of bytes held in / still free in a CharBuffer. A cb may be used by
+   one producer and one consumer thread concurrently; both functions may be
+   called from either side */
+picoos_uint16 picodata_cbGetLen(register picodata_CharBuffer this);
+picoos_uint16 picodata_cbGetSpace(register picodata_CharBuffer this);
+
 /* ***************************************************************
  *                   items: support function                     *
  *****************************************************************/
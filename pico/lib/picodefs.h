@@ -63,6 +63,9 @@ extern "C" {
 /* maximum number of resources per voice */
 #define PICO_MAX_NUM_RSRC_PER_VOICE     16
 
+/* maximum number of engines per system */
+#define PICO_MAX_NUM_ENGINES            64
+
 /* maximum length of foreign header prepended to PICO resource files
    (header length must be a multiple of 4 bytes) */
 #define PICO_MAX_FOREIGN_HEADER_LEN     64
@@ -130,6 +133,7 @@ typedef signed int pico_Status;
 /* general */
 #define PICO_WARN_INCOMPLETE            (pico_Status)    10
 #define PICO_WARN_FALLBACK              (pico_Status)    11
+#define PICO_WARN_CANCELLED             (pico_Status)    12
 #define PICO_WARN_OTHER                 (pico_Status)    19
 
 /* resources */
@@ -164,6 +168,56 @@ typedef signed int pico_Status;
 #define PICO_RESET_SOFT                                 0x10
 
 
+/* ********************************************************************/
+/* initializeEx memory modes                                          */
+/* ********************************************************************/
+
+/* free memory is searched first-fit */
+#define PICO_MEM_FIRST_FIT                              0
+/* free memory is kept in lists per size class; allocation and release
+   take constant time, e.g. for frequent engine creation and disposal */
+#define PICO_MEM_SIZE_CLASSES                           1
+/* flag to be combined with one of the above: when the memory area is
+   exhausted, additional blocks are allocated from the platform's heap
+   instead of failing with PICO_EXC_OUT_OF_MEM */
+#define PICO_MEM_GROW                                   0x10
+
+
+/* ********************************************************************/
+/* loadResourceEx load modes                                          */
+/* ********************************************************************/
+
+/* resource content is copied into the system memory area */
+#define PICO_LOAD_COPY                                  0
+/* resource content is mapped read-only from the file (shared between
+   processes); falls back to PICO_LOAD_COPY if mapping is not possible */
+#define PICO_LOAD_MAP                                   1
+
+
+/* ********************************************************************/
+/* newEngineEx engine modes                                           */
+/* ********************************************************************/
+
+/* all processing is done in the caller's thread during getData */
+#define PICO_ENGINE_SERIAL                              0
+/* text analysis runs in a separate thread of the engine, signal
+   generation in the caller's thread; falls back to PICO_ENGINE_SERIAL
+   if the platform does not support threads */
+#define PICO_ENGINE_PIPELINED                           1
+/* may be or'ed to either mode: the first phrase of an utterance is cut
+   short and scheduled ahead of the rest, so that speech starts as early as
+   possible; the synthesized output differs slightly from the default */
+#define PICO_ENGINE_LOW_LATENCY                         0x10
+/* may be or'ed to either mode: parameter generation (CEP) outputs the
+   frames of a sentence in windows, each as soon as 'frames' further frames
+   (4 ms each, 8..1023) are known, instead of after the whole sentence. The
+   time to the first speech data and the CEP buffer use then no longer grow
+   with the length of the sentence; the smaller 'frames', the more the
+   output deviates from the default */
+#define PICO_ENGINE_CEP_LOOKAHEAD(frames)               (((frames) & 0x3FF) << 8)
+#define PICO_ENGINE_CEP_LOOKAHEAD_MASK                  0x3FF00
+
+
 /* ********************************************************************/
 /* Engine getData outDataType values                                  */
 /* ********************************************************************/
@@ -171,6 +225,18 @@ typedef signed int pico_Status;
 /* 16 bit PCM samples, native endianness of platform */
 #define PICO_DATA_PCM_16BIT             (pico_Int16)  1
 
+
+/* ********************************************************************/
+/* Engine synthesize callback events                                  */
+/* ********************************************************************/
+
+/* a block of 16 bit PCM samples */
+#define PICO_EVENT_AUDIO                (pico_Int16)  1
+/* a <mark name='...'/> in the text was reached */
+#define PICO_EVENT_MARK                 (pico_Int16)  2
+/* the end of a sentence was reached */
+#define PICO_EVENT_SENTENCE             (pico_Int16)  3
+
 #ifdef __cplusplus
 }
 #endif
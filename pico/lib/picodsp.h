@@ -29,6 +29,12 @@
 #ifndef PICODSP_H_
 #define PICODSP_H_
 
+#include "picoos.h"
+
+/* number format of the FFT/DCT of SIG and of the parameter smoothing of CEP:
+   fixed point by default, for targets without a fast FPU; define
+   PICODSP_FLOAT to compute them in float32 */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -105,6 +111,14 @@ extern "C" {
  -----------------------------------------------------------------------------------------*/
 #define EXP(y) picoos_quick_exp(y)
 
+/* the constant SIG tables are aligned to cache lines, so that each table
+   touches as few lines as possible */
+#if defined(__GNUC__)
+#define PICODSP_CACHE_ALIGNED __attribute__((aligned(64)))
+#else
+#define PICODSP_CACHE_ALIGNED
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2008-2009 SVOX AG, Baslerstr. 30, 8048 Zuerich, Switzerland
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * @file picodspv.h
+ *
+ * Vector operations of the DSP kernels (FFT/DCT, SIG, CEP smoothing)
+ *
+ * Only included by the library sources and not installed: the compiler
+ * intrinsics headers it includes must not be imposed on the users of the
+ * public headers.
+ *
+ */
+
+#ifndef PICODSPV_H_
+#define PICODSPV_H_
+
+#include "picoos.h"
+
+/* vector instruction set of the DSP kernels, selected at compile time;
+   define PICODSP_NO_SIMD to use the scalar code only */
+#if !defined(PICODSP_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) \
+        || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define PICODSP_SIMD_SSE2
+#include <emmintrin.h>
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+#elif !defined(PICODSP_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define PICODSP_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#if defined(PICODSP_SIMD_SSE2) || defined(PICODSP_SIMD_NEON)
+#define PICODSP_SIMD
+#endif
+
+/*----------------------------VECTOR OPERATIONS----------------------------*/
+#if defined(PICODSP_SIMD)
+/* four 32 bit lanes; for complex data, two values (re, im, re, im). The
+   operations wrap around on overflow like the scalar integer code, so that
+   vector kernels give the same results as the scalar ones */
+#if defined(PICODSP_SIMD_SSE2)
+typedef __m128i picodsp_vec_t;
+
+#define picodsp_vload(p) _mm_loadu_si128((const __m128i *)(p))
+#define picodsp_vstore(p, v) _mm_storeu_si128((__m128i *)(p), (v))
+#define picodsp_vset(x0, x1, x2, x3) _mm_setr_epi32((x0), (x1), (x2), (x3))
+#define picodsp_vdup(x) _mm_set1_epi32(x)
+#define picodsp_vadd(a, b) _mm_add_epi32((a), (b))
+#define picodsp_vsub(a, b) _mm_sub_epi32((a), (b))
+#define picodsp_vxor(a, b) _mm_xor_si128((a), (b))
+/* arithmetic shift right by 'n' bits */
+#define picodsp_vshr(a, n) _mm_srai_epi32((a), (n))
+/* shift left by 'n' bits */
+#define picodsp_vshl(a, n) _mm_slli_epi32((a), (n))
+/* (a1, a0, a3, a2): swaps real and imaginary parts */
+#define picodsp_vswap(a) _mm_shuffle_epi32((a), _MM_SHUFFLE(2, 3, 0, 1))
+/* (a2, a3, a0, a1): swaps the two complex values */
+#define picodsp_vrev(a) _mm_shuffle_epi32((a), _MM_SHUFFLE(1, 0, 3, 2))
+/* (a0, a0, a2, a2) and (a1, a1, a3, a3): real and imaginary parts */
+#define picodsp_vdupre(a) _mm_shuffle_epi32((a), _MM_SHUFFLE(2, 2, 0, 0))
+#define picodsp_vdupim(a) _mm_shuffle_epi32((a), _MM_SHUFFLE(3, 3, 1, 1))
+/* (a0, a1, b0, b1) and (a2, a3, b2, b3): the first and the second complex
+   values of a and b */
+#define picodsp_vlo(a, b) _mm_unpacklo_epi64((a), (b))
+#define picodsp_vhi(a, b) _mm_unpackhi_epi64((a), (b))
+/* (a0, b0, a1, b1) and (a2, b2, a3, b3): interleaves a and b */
+#define picodsp_vziplo(a, b) _mm_unpacklo_epi32((a), (b))
+#define picodsp_vziphi(a, b) _mm_unpackhi_epi32((a), (b))
+
+/* lowest 32 bits of the products */
+#if defined(__SSE4_1__)
+#define picodsp_vmul(a, b) _mm_mullo_epi32((a), (b))
+#else
+static __inline picodsp_vec_t picodsp_vmul(picodsp_vec_t a, picodsp_vec_t b)
+{
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+#endif
+
+/* four float32 lanes; fvswap, fvrev and fvziplo/hi as their integer
+   counterparts */
+typedef __m128 picodsp_fvec_t;
+
+#define picodsp_fvload(p) _mm_loadu_ps(p)
+#define picodsp_fvstore(p, v) _mm_storeu_ps((p), (v))
+#define picodsp_fvadd(a, b) _mm_add_ps((a), (b))
+#define picodsp_fvsub(a, b) _mm_sub_ps((a), (b))
+#define picodsp_fvmul(a, b) _mm_mul_ps((a), (b))
+#define picodsp_fvdup(x) _mm_set1_ps(x)
+/* 1 / a, with the precision of a division */
+#define picodsp_fvrecip(a) _mm_div_ps(_mm_set1_ps(1.0f), (a))
+#define picodsp_fvswap(a) _mm_shuffle_ps((a), (a), _MM_SHUFFLE(2, 3, 0, 1))
+#define picodsp_fvrev(a) _mm_shuffle_ps((a), (a), _MM_SHUFFLE(1, 0, 3, 2))
+#define picodsp_fvziplo(a, b) _mm_unpacklo_ps((a), (b))
+#define picodsp_fvziphi(a, b) _mm_unpackhi_ps((a), (b))
+
+#else /* PICODSP_SIMD_NEON */
+typedef int32x4_t picodsp_vec_t;
+typedef float32x4_t picodsp_fvec_t;
+
+#define picodsp_vload(p) vld1q_s32((const int32_t *)(p))
+#define picodsp_vstore(p, v) vst1q_s32((int32_t *)(p), (v))
+#define picodsp_vadd(a, b) vaddq_s32((a), (b))
+#define picodsp_vsub(a, b) vsubq_s32((a), (b))
+#define picodsp_vxor(a, b) veorq_s32((a), (b))
+#define picodsp_vshr(a, n) vshlq_s32((a), vdupq_n_s32(-(n)))
+#define picodsp_vswap(a) vrev64q_s32(a)
+#define picodsp_vrev(a) vcombine_s32(vget_high_s32(a), vget_low_s32(a))
+#define picodsp_vdupre(a) vtrnq_s32((a), (a)).val[0]
+#define picodsp_vdupim(a) vtrnq_s32((a), (a)).val[1]
+#define picodsp_vlo(a, b) vcombine_s32(vget_low_s32(a), vget_low_s32(b))
+#define picodsp_vhi(a, b) vcombine_s32(vget_high_s32(a), vget_high_s32(b))
+#define picodsp_vmul(a, b) vmulq_s32((a), (b))
+#define picodsp_vdup(x) vdupq_n_s32(x)
+#define picodsp_vshl(a, n) vshlq_s32((a), vdupq_n_s32(n))
+#define picodsp_vziplo(a, b) vzipq_s32((a), (b)).val[0]
+#define picodsp_vziphi(a, b) vzipq_s32((a), (b)).val[1]
+#define picodsp_fvload(p) vld1q_f32(p)
+#define picodsp_fvstore(p, v) vst1q_f32((p), (v))
+#define picodsp_fvadd(a, b) vaddq_f32((a), (b))
+#define picodsp_fvsub(a, b) vsubq_f32((a), (b))
+#define picodsp_fvmul(a, b) vmulq_f32((a), (b))
+#define picodsp_fvdup(x) vdupq_n_f32(x)
+#define picodsp_fvswap(a) vrev64q_f32(a)
+#define picodsp_fvrev(a) vcombine_f32(vget_high_f32(a), vget_low_f32(a))
+#define picodsp_fvziplo(a, b) vzipq_f32((a), (b)).val[0]
+#define picodsp_fvziphi(a, b) vzipq_f32((a), (b)).val[1]
+
+static __inline picodsp_vec_t picodsp_vset(picoos_int32 x0, picoos_int32 x1,
+        picoos_int32 x2, picoos_int32 x3)
+{
+    int32_t x[4];
+    x[0] = x0; x[1] = x1; x[2] = x2; x[3] = x3;
+    return vld1q_s32(x);
+}
+
+#if defined(__aarch64__)
+#define picodsp_fvrecip(a) vdivq_f32(vdupq_n_f32(1.0f), (a))
+#else
+/* ARMv7 has no vector division: estimate refined by two Newton steps */
+static __inline picodsp_fvec_t picodsp_fvrecip(picodsp_fvec_t a)
+{
+    float32x4_t r = vrecpeq_f32(a);
+    r = vmulq_f32(vrecpsq_f32(a, r), r);
+    return vmulq_f32(vrecpsq_f32(a, r), r);
+}
+#endif
+#endif
+
+/* (a3, a2, a1, a0): reverses the order of the lanes */
+#define picodsp_vrev4(a) picodsp_vrev(picodsp_vswap(a))
+
+/* negates the lanes for which 'mask' is -1 (the others are 0) */
+#define picodsp_vneg(a, mask) picodsp_vsub(picodsp_vxor((a), (mask)), (mask))
+
+/* shift right by 'n' bits rounding towards zero, i.e. per lane
+   x >= 0 ? x >> n : -((-x) >> n) */
+static __inline picodsp_vec_t picodsp_vshrsym(picodsp_vec_t a, int n)
+{
+    picodsp_vec_t sign = picodsp_vshr(a, 31);
+    return picodsp_vneg(picodsp_vshr(picodsp_vneg(a, sign), n), sign);
+}
+
+#if defined(PICODSP_SIMD_SSE2)
+/* division by 'd' > 0 rounding towards zero, like the scalar a / d. Done in
+   double precision, which is exact: the rounded quotient of two 32 bit
+   integers never reaches the next integer. There is no counterpart on NEON,
+   which lacks a vector division on ARMv7 */
+static __inline picodsp_vec_t picodsp_vdiv(picodsp_vec_t a, picoos_int32 d)
+{
+    __m128d dd = _mm_set1_pd((double) d);
+    __m128i lo = _mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(a), dd));
+    __m128i hi = _mm_cvttpd_epi32(_mm_div_pd(
+            _mm_cvtepi32_pd(_mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2))), dd));
+    return _mm_unpacklo_epi64(lo, hi);
+}
+#endif
+#endif /* PICODSP_SIMD */
+
+#endif /*PICODSPV_H_*/
@@ -49,6 +49,7 @@ extern pico_Status pico_initialize_priv(
         void *memory,
         const pico_Uint32 size,
         pico_Int16 enableMemProt,
+        pico_Int32 memMode,
         pico_System *system);
 
 
@@ -62,7 +63,7 @@ PICO_FUNC picoext_initialize(
         pico_System *outSystem
         )
 {
-    return pico_initialize_priv(memory, size, enableMemProt, outSystem);
+    return pico_initialize_priv(memory, size, enableMemProt, PICO_MEM_FIRST_FIT, outSystem);
 }
 
 
@@ -203,6 +204,89 @@ PICO_FUNC picoext_getEngineMemUsage(
     return status;
 }
 
+PICO_FUNC picoext_getSystemMemHighWater(
+        pico_System system,
+        pico_Int32 *outHighWaterBytes
+        )
+{
+    pico_Status status = PICO_OK;
+
+    if (!is_valid_system_handle(system)) {
+        status = PICO_ERR_INVALID_HANDLE;
+    } else if (outHighWaterBytes == NULL) {
+        status = PICO_ERR_NULLPTR_ACCESS;
+    } else {
+        picoos_Common common = pico_sysGetCommon(system);
+        /* the system object precedes the memory manager in the memory area */
+        *outHighWaterBytes = (pico_Int32) (((picoos_objsize_t) common->mm - (picoos_objsize_t) system)
+                + picoos_getMemHighWater(common->mm));
+    }
+
+    return status;
+}
+
+
+PICO_FUNC picoext_getSystemMemFragmentation(
+        pico_System system,
+        pico_Int32 *outFreeBytes,
+        pico_Int32 *outLargestFreeBytes,
+        pico_Int32 *outNumFreeBlocks
+        )
+{
+    pico_Status status = PICO_OK;
+
+    if (!is_valid_system_handle(system)) {
+        status = PICO_ERR_INVALID_HANDLE;
+    } else if ((outFreeBytes == NULL) || (outLargestFreeBytes == NULL) || (outNumFreeBlocks == NULL)) {
+        status = PICO_ERR_NULLPTR_ACCESS;
+    } else {
+        picoos_Common common = pico_sysGetCommon(system);
+        picoos_getMemFragmentation(common->mm, outFreeBytes, outLargestFreeBytes, outNumFreeBlocks);
+    }
+
+    return status;
+}
+
+
+PICO_FUNC picoext_getEngineMemFragmentation(
+        pico_Engine engine,
+        pico_Int32 *outFreeBytes,
+        pico_Int32 *outLargestFreeBytes,
+        pico_Int32 *outNumFreeBlocks
+        )
+{
+    pico_Status status = PICO_OK;
+
+    if (!picoctrl_isValidEngineHandle((picoctrl_Engine) engine)) {
+        status = PICO_ERR_INVALID_HANDLE;
+    } else if ((outFreeBytes == NULL) || (outLargestFreeBytes == NULL) || (outNumFreeBlocks == NULL)) {
+        status = PICO_ERR_NULLPTR_ACCESS;
+    } else {
+        picoos_Common common = picoctrl_engGetCommon((picoctrl_Engine) engine);
+        picoos_getMemFragmentation(common->mm, outFreeBytes, outLargestFreeBytes, outNumFreeBlocks);
+    }
+
+    return status;
+}
+
+PICO_FUNC picoext_getEngineTimeToFirstSample(
+        pico_Engine engine,
+        pico_Int32 *outMicroseconds
+        )
+{
+    pico_Status status = PICO_OK;
+
+    if (!picoctrl_isValidEngineHandle((picoctrl_Engine) engine)) {
+        status = PICO_ERR_INVALID_HANDLE;
+    } else if (outMicroseconds == NULL) {
+        status = PICO_ERR_NULLPTR_ACCESS;
+    } else {
+        *outMicroseconds = picoctrl_engGetTimeToFirstSample((picoctrl_Engine) engine);
+    }
+
+    return status;
+}
+
 PICO_FUNC picoext_getLastScheduledPU(
         pico_Engine engine
         )
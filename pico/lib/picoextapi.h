@@ -147,6 +147,47 @@ PICO_FUNC picoext_getEngineMemUsage(
         pico_Int32 *outMaxUsedBytes
         );
 
+/* Returns the high-water mark of the system memory: the minimum size of the
+   memory area passed to pico_initialize with which all system-level
+   allocations so far (including engines and resources loaded with
+   PICO_LOAD_COPY) would have succeeded. Loading the voices and running an
+   engine over a calibration text thus determines the memory size needed.
+   The value is exact for PICO_MEM_FIRST_FIT and an estimate otherwise; it
+   includes the size of any blocks added because of PICO_MEM_GROW. */
+
+PICO_FUNC picoext_getSystemMemHighWater(
+        pico_System system,
+        pico_Int32 *outHighWaterBytes
+        );
+
+/* Returns the fragmentation of the free system/engine memory: the total
+   number of free bytes, the size of the largest free block and the number
+   of free blocks. */
+
+PICO_FUNC picoext_getSystemMemFragmentation(
+        pico_System system,
+        pico_Int32 *outFreeBytes,
+        pico_Int32 *outLargestFreeBytes,
+        pico_Int32 *outNumFreeBlocks
+        );
+
+PICO_FUNC picoext_getEngineMemFragmentation(
+        pico_Engine engine,
+        pico_Int32 *outFreeBytes,
+        pico_Int32 *outLargestFreeBytes,
+        pico_Int32 *outNumFreeBlocks
+        );
+
+/* Returns the time to first sample of the last utterance: the time from
+   feeding its first text (to an idle or reset engine) to the first output of
+   speech data by pico_getData or to the callback, in microseconds; -1 if no
+   utterance has produced speech yet. */
+
+PICO_FUNC picoext_getEngineTimeToFirstSample(
+        pico_Engine engine,
+        pico_Int32 *outMicroseconds
+        );
+
 PICO_FUNC picoext_getLastScheduledPU(
         pico_Engine engine
         );
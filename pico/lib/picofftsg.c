@@ -28,6 +28,7 @@
 
 #include "picoos.h"
 #include "picofftsg.h"
+#include "picodspv.h"
 #include "picodbg.h"
 
 #ifdef __cplusplus
@@ -47,212 +48,47 @@ extern "C" {
   - decimation  :frequency
   - radix       :split-radix
   - data        :inplace
-  - table       :not use
-
-  functions
-  - cdft: Complex Discrete Fourier Transform
-  - rdft: Real Discrete Fourier Transform
-  - ddct: Discrete Cosine Transform
-  - ddst: Discrete Sine Transform
-  - dfct: Cosine Transform of RDFT (Real Symmetric DFT)
-  - dfst: Sine Transform of RDFT (Real Anti-symmetric DFT)
-
-  function prototypes
-  - void cdft(picoos_int32, picoos_int32, PICOFFTSG_FFTTYPE *);
-  - void rdft(picoos_int32, picoos_int32, PICOFFTSG_FFTTYPE *);
-  - void ddct(picoos_int32, picoos_int32, PICOFFTSG_FFTTYPE *);
-  - void ddst(picoos_int32, picoos_int32, PICOFFTSG_FFTTYPE *);
-  - void dfct(picoos_int32, PICOFFTSG_FFTTYPE *);
-  - void dfst(picoos_int32, PICOFFTSG_FFTTYPE *);
-
-  <b>Complex DFT (Discrete Fourier Transform)</b>
+  - table       :precomputed once per plan (picofftsg_newPlan)
 
-  [definition]
-  - <case1>
-      - X[k] = sum_j=0^n-1 x[j]*exp(2*pi*i*j*k/n), 0<=k<n
-  - <case2>
-      - X[k] = sum_j=0^n-1 x[j]*exp(-2*pi*i*j*k/n), 0<=k<n
-  - (notes: sum_j=0^n-1 is a summation from j=0 to n-1)
-
-  [usage]
-  - <case1>
-      - cdft(2*n, 1, a);
-  - <case2>
-      - cdft(2*n, -1, a);
-
-  [parameters]
-  - 2*n            :data length (picoos_int32)
-  - n >= 1, n = power of 2
-  - a[0...2*n-1]   :input/output data (PICOFFTSG_FFTTYPE *)
-  - input data
-      - a[2*j] = Re(x[j]),
-      - a[2*j+1] = Im(x[j]), 0<=j<n
-  - output data
-      - a[2*k] = Re(X[k]),
-      - a[2*k+1] = Im(X[k]), 0<=k<n
-
-  [remark]
-  - Inverse of cdft(2*n, -1, a); is
-      -cdft(2*n, 1, a);
-          - for (j = 0; j <= 2 * n - 1; j++) {
-              - a[j] *= 1.0 / n;
-          - }
-
-
-  <b> Real DFT / Inverse of Real DFT </b>
-
-  [definition]
-  - <case1> RDFT
-      - R[k] = sum_j=0^n-1 a[j]*cos(2*pi*j*k/n), 0<=k<=n/2
-      - I[k] = sum_j=0^n-1 a[j]*sin(2*pi*j*k/n), 0<k<n/2
-  -    <case2> IRDFT (excluding scale)
-      - a[k] = (R[0] + R[n/2]*cos(pi*k))/2 +
-      - sum_j=1^n/2-1 R[j]*cos(2*pi*j*k/n) +
-      - sum_j=1^n/2-1 I[j]*sin(2*pi*j*k/n), 0<=k<n
-
-  [usage]
-  - <case1>
-      - rdft(n, 1, a);
-  -    <case2>
-      - rdft(n, -1, a);
+  Of Ooura's package only the two transforms needed by SIG are kept, each
+  for the one size SIG uses; they are called through a plan holding the
+  tables of that size (see picofftsg.h):
 
-  [parameters]
-  - n              :data length (picoos_int32)
-  - n >= 2, n = power of 2
-  - a[0...n-1]     :input/output data (PICOFFTSG_FFTTYPE *)
-  - <case1>
-      - output data
-          - a[2*k] = R[k], 0<=k<n/2
-          - a[2*k+1] = I[k], 0<k<n/2
-          - a[1] = R[n/2]
-  - <case2>
-      - input data
-          - a[2*j] = R[j], 0<=j<n/2
-          - a[2*j+1] = I[j], 0<j<n/2
-          - a[1] = R[n/2]
-
-  [remark]
-  - Inverse of rdft(n, 1, a); is
-  - rdft(n, -1, a);
-      - for (j = 0; j <= n - 1; j++) {
-          - a[j] *= 2.0 / n;
-     -}
-
-
-  <b> DCT (Discrete Cosine Transform) / Inverse of DCT</b>
+  entry points
+  - picofftsg_newPlan(mm, rdftSize, dfctSize), picofftsg_disposePlan(mm, &plan)
+  - picofftsg_rdftInv(plan, a): Inverse of Real DFT (Ooura's rdft(n, -1, a))
+  - picofftsg_dfctNmf(plan, a): Cosine Transform of RDFT (Ooura's dfct(n, a))
+  - with PICODSP_FLOAT, picofftsg_rdftInvFloat and picofftsg_dfctNmfFloat
+    compute the same in float32
 
-  [definition]
-  - <case1> IDCT (excluding scale)
-      - C[k] = sum_j=0^n-1 a[j]*cos(pi*j*(k+1/2)/n), 0<=k<n
-  - <case2> DCT
-      - C[k] = sum_j=0^n-1 a[j]*cos(pi*(j+1/2)*k/n), 0<=k<n
+  <b> Inverse of Real DFT (picofftsg_rdftInv) </b>
 
-  [usage]
-  - <case1>
-    - ddct(n, 1, a);
-  - <case2>
-    - ddct(n, -1, a);
+  [definition] (excluding scale)
+  - a[k] = (R[0] + R[n/2]*cos(pi*k))/2 +
+  - sum_j=1^n/2-1 R[j]*cos(2*pi*j*k/n) +
+  - sum_j=1^n/2-1 I[j]*sin(2*pi*j*k/n), 0<=k<n
 
   [parameters]
-  - n              :data length (picoos_int32)
-  - n >= 2, n = power of 2
+  - n              :rdftSize of the plan, a power of 2
   - a[0...n-1]     :input/output data (PICOFFTSG_FFTTYPE *)
-  - output data
-      - a[k] = C[k], 0<=k<n
-
-  [remark]
-  - Inverse of ddct(n, -1, a); is
-  - a[0] *= 0.5;
-  - ddct(n, 1, a);
-  - for (j = 0; j <= n - 1; j++) {
-      - a[j] *= 2.0 / n;
-  - }
-
-  <b> DST (Discrete Sine Transform) / Inverse of DST</b>
-
-  [definition]
-  - <case1> IDST (excluding scale)
-      - S[k] = sum_j=1^n A[j]*sin(pi*j*(k+1/2)/n), 0<=k<n
-  - <case2> DST
-      - S[k] = sum_j=0^n-1 a[j]*sin(pi*(j+1/2)*k/n), 0<k<=n
+  - input data
+      - a[2*j] = R[j], 0<=j<n/2
+      - a[2*j+1] = I[j], 0<j<n/2
+      - a[1] = R[n/2]
 
-  [usage]
-  - <case1>
-      - ddst(n, 1, a);
-  - <case2>
-      - ddst(n, -1, a);
-
-  [parameters]
-  - n              :data length (picoos_int32)
-  - n >= 2, n = power of 2
-  - a[0...n-1]     :input/output data (PICOFFTSG_FFTTYPE *)
-  - <case1>
-      - input data
-          - a[j] = A[j], 0<j<n
-          - a[0] = A[n]
-      - output data
-          - a[k] = S[k], 0<=k<n
-  - <case2>
-    - output data
-        - a[k] = S[k], 0<k<n
-        - a[0] = S[n]
-
-  [remark]
-  - Inverse of ddst(n, -1, a); is
-  - a[0] *= 0.5;
-  - ddst(n, 1, a);
-  - for (j = 0; j <= n - 1; j++) {
-      - a[j] *= 2.0 / n;
-  - }
-
-  <b> Cosine Transform of RDFT (Real Symmetric DFT)</b>
+  <b> Cosine Transform of RDFT (picofftsg_dfctNmf) </b>
 
   [definition]
   - C[k] = sum_j=0^n a[j]*cos(pi*j*k/n), 0<=k<=n
 
-  [usage]
-  - dfct(n, a);
-
   [parameters]
-  - n              :data length - 1 (picoos_int32)
-  - n >= 2, n = power of 2
-  - a[0...n]       :input/output data (PICOFFTSG_FFTTYPE *)
-
+  - n              :dfctSize of the plan, a power of 2
+  - a[0...n]       :input/output data (PICOFFTSG_FFTTYPE *); the float
+                    version needs a[0...2*n-1], using the upper half as
+                    work area
   - output data
     - a[k] = C[k], 0<=k<=n
 
-  [remark]
-  - Inverse of a[0] *= 0.5; a[n] *= 0.5; dfct(n, a); is
-  - a[0] *= 0.5;
-  - a[n] *= 0.5;
-  - dfct(n, a);
-  - for (j = 0; j <= n; j++) {
-      - a[j] *= 2.0 / n;
-  - }
-
-  <b> Sine Transform of RDFT (Real Anti-symmetric DFT)</b>
-
-  [definition]
-  - S[k] = sum_j=1^n-1 a[j]*sin(pi*j*k/n), 0<k<n
-
-  [usage]
-  - dfst(n, a);
-
-  [parameters]
-  - n              :data length + 1 (picoos_int32)
-  - n >= 2, n = power of 2
-  - a[0...n-1]     :input/output data (PICOFFTSG_FFTTYPE *)
-  - output data
-      - a[k] = S[k], 0<k<n
-      - (a[0] is used for work area)
-
-  [remark]
-  - Inverse of dfst(n, a); is
-  - dfst(n, a);
-  - for (j = 1; j <= n - 1; j++) {
-    - a[j] *= 2.0 / n;
-  - }
-
 */
 
 /* fixed point multiplier for weights */
@@ -366,6 +202,63 @@ extern "C" {
 #define Mult_W_W picofftsg_mult_w_w
 
 
+/* ***********************************************************************************************/
+/* transform plan */
+/* ***********************************************************************************************/
+/* transform sizes supported by the plan */
+#define PICOFFTSG_PLAN_RDFT_SIZE 256
+#define PICOFFTSG_PLAN_DFCT_SIZE 128
+
+/* number of precomputed twiddle factors: cftb1st(256) 60, cftmdl1(64) 12,
+   cftmdl2(64) 24, rftbsub(256) 126, rftfsub(64..8) 30+14+6+2,
+   dctsub(64..8) 62+30+14+6 */
+#define PICOFFTSG_PLAN_TWIDDLES 386
+
+/* maximum number of exchanges of a bit reversal, (128 - 16) / 2 for 128 elements */
+#define PICOFFTSG_MAX_SWAPS 56
+
+#if defined(PICODSP_FLOAT)
+/* the float32 transforms are based on a complex FFT of 128 values */
+#define PICOFFTSG_FLT_CFT_SIZE (PICOFFTSG_PLAN_RDFT_SIZE / 2)
+
+/* twiddle factors of its radix-2 stages of length 8..128 */
+#define PICOFFTSG_FLT_CFT_TWIDDLES (2 * (PICOFFTSG_FLT_CFT_SIZE - 4))
+#endif
+
+/* bit reversal permutation: pairs of element indices to be exchanged */
+typedef struct picofftsg_perm {
+    picoos_uint8 num;
+    picoos_uint8 idx[2 * PICOFFTSG_MAX_SWAPS];
+} picofftsg_perm_t;
+
+/* twiddle factors as produced by the kernels' recurrences, in the order in
+   which the kernels use them, and the bit reversals of the supported sizes */
+typedef struct picofftsg_plan {
+    PICOFFTSG_FFTTYPE *b1stW;       /* cftb1st(256) */
+    PICOFFTSG_FFTTYPE *mdl1W;       /* cftmdl1(64) */
+    PICOFFTSG_FFTTYPE *mdl2W;       /* cftmdl2(64) */
+    PICOFFTSG_FFTTYPE *rftbW;       /* rftbsub(256) */
+    PICOFFTSG_FFTTYPE *rftfW[4];    /* rftfsub(8 << i) */
+    PICOFFTSG_FFTTYPE *dctW[4];     /* dctsub(8 << i) */
+    PICOFFTSG_FFTTYPE w[PICOFFTSG_PLAN_TWIDDLES];
+    picofftsg_perm_t rdftIp;        /* bitrv2conj(256) */
+    picofftsg_perm_t cftIp;         /* bitrv2(64) */
+    picofftsg_perm_t dctIp[6];      /* bitrv1(4 << i) */
+#if defined(PICODSP_FLOAT)
+    /* w^j = exp(2*pi*i*j/256), 0<=j<64, as (-cos, cos)/2 and (-sin, -sin)/2
+       pairs, the factors of the post-processing of rdftInvFloat */
+    picoos_single fltRftU[PICOFFTSG_PLAN_RDFT_SIZE / 2];
+    picoos_single fltRftV[PICOFFTSG_PLAN_RDFT_SIZE / 2];
+    /* exp(2*pi*i*k/L), 0<=k<L/2 for L = 8..128: L/2 cosines, then L/2 sines */
+    picoos_single fltCftW[PICOFFTSG_FLT_CFT_TWIDDLES];
+    picoos_uint8 fltRev[PICOFFTSG_FLT_CFT_SIZE]; /* bit reversal of 128 */
+    /* work area of the complex FFT: real and imaginary parts */
+    picoos_single fltRe[PICOFFTSG_FLT_CFT_SIZE];
+    picoos_single fltIm[PICOFFTSG_FLT_CFT_SIZE];
+#endif
+} picofftsg_plan_t;
+
+
 /* ***********************************************************************************************/
 /* forward declarations */
 /* ***********************************************************************************************/
@@ -373,96 +266,104 @@ static PICOFFTSG_FFTTYPE picofftsg_mult_w_w(PICOFFTSG_FFTTYPE x1, PICOFFTSG_FFTT
 static PICOFFTSG_FFTTYPE picofftsg_mult_w_a(PICOFFTSG_FFTTYPE x1, PICOFFTSG_FFTTYPE y1);
 
 
-static void cftfsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-static void cftbsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-static void rftfsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-static void rftbsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-
-static void cftfsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-static void cftbsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-static void rftfsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-static void rftbsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-static void dctsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
+static void cftfsub(picofftsg_plan_t *plan, picoos_int32 n, PICOFFTSG_FFTTYPE *a);
+static void cftbsub(picofftsg_plan_t *plan, PICOFFTSG_FFTTYPE *a);
+static void rftfsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w);
+static void rftbsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w);
+static void dctsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w);
 static void dctsub4(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
 
-static void ddct(picoos_int32 n, picoos_int32 isgn, PICOFFTSG_FFTTYPE *a);
-static void bitrv1(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-
-static void bitrv2(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
+static void ddct(picofftsg_plan_t *plan, picoos_int32 n, PICOFFTSG_FFTTYPE *a);
+static void bitrv1(const picofftsg_perm_t *ip, PICOFFTSG_FFTTYPE *a);
+static void bitrv2(const picofftsg_perm_t *ip, PICOFFTSG_FFTTYPE *a);
+static void bitrv2conj(picoos_int32 n, const picofftsg_perm_t *ip, PICOFFTSG_FFTTYPE *a);
 static void bitrv216(PICOFFTSG_FFTTYPE *a);
 static void bitrv208(PICOFFTSG_FFTTYPE *a);
-static void cftmdl1(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-static void cftrec4(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-static void cftleaf(picoos_int32 n, picoos_int32 isplt, PICOFFTSG_FFTTYPE *a);
-static void cftfx41(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-static void cftf161(PICOFFTSG_FFTTYPE *a);
-static void cftf081(PICOFFTSG_FFTTYPE *a);
-static void cftf040(PICOFFTSG_FFTTYPE *a);
-static void cftx020(PICOFFTSG_FFTTYPE *a);
 
-void bitrv2conj(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-void bitrv216neg(PICOFFTSG_FFTTYPE *a);
-void bitrv208neg(PICOFFTSG_FFTTYPE *a);
-void cftb1st(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-void cftrec4(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-void cftleaf(picoos_int32 n, picoos_int32 isplt, PICOFFTSG_FFTTYPE *a);
-void cftfx41(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-void cftf161(PICOFFTSG_FFTTYPE *a);
-void cftf081(PICOFFTSG_FFTTYPE *a);
-void cftb040(PICOFFTSG_FFTTYPE *a);
-void cftx020(PICOFFTSG_FFTTYPE *a);
-
-static picoos_int32 cfttree(picoos_int32 n, picoos_int32 j, picoos_int32 k, PICOFFTSG_FFTTYPE *a);
-static void cftleaf(picoos_int32 n, picoos_int32 isplt, PICOFFTSG_FFTTYPE *a);
-static void cftmdl1(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-
-static void cftmdl1(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-static void cftmdl2(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-
-static void cftmdl1(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
-static void cftmdl2(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
+static void cftb1st(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w);
+static void cftleaf(PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w1, const PICOFFTSG_FFTTYPE *w2);
+static void cftmdl1(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w);
+static void cftmdl2(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w);
+static void cftfx41(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
 static void cftf161(PICOFFTSG_FFTTYPE *a);
 static void cftf162(PICOFFTSG_FFTTYPE *a);
 static void cftf081(PICOFFTSG_FFTTYPE *a);
 static void cftf082(PICOFFTSG_FFTTYPE *a);
+static void cftf040(PICOFFTSG_FFTTYPE *a);
+static void cftx020(PICOFFTSG_FFTTYPE *a);
 
-static void cftf161(PICOFFTSG_FFTTYPE *a);
-static void cftf162(PICOFFTSG_FFTTYPE *a);
-static void cftf081(PICOFFTSG_FFTTYPE *a);
-static void cftf082(PICOFFTSG_FFTTYPE *a);
+static PICOFFTSG_FFTTYPE *makewt1(picoos_int32 n, PICOFFTSG_FFTTYPE *w);
+static PICOFFTSG_FFTTYPE *makewt2(picoos_int32 n, PICOFFTSG_FFTTYPE *w);
+static PICOFFTSG_FFTTYPE *makert(picoos_int32 n, PICOFFTSG_FFTTYPE *w);
+static PICOFFTSG_FFTTYPE *makect(picoos_int32 n, PICOFFTSG_FFTTYPE *w);
+static void makeipt(picoos_int32 n, picofftsg_perm_t *ip);
+#if defined(PICODSP_FLOAT)
+static void cftbflt(picofftsg_plan_t *plan, picoos_single *a);
+static void makeflt(picofftsg_plan_t *plan);
+#endif
 
 /* ***********************************************************************************************/
 /* Exported functions */
 /* ***********************************************************************************************/
-void rdft(picoos_int32 n, picoos_int32 isgn, PICOFFTSG_FFTTYPE *a)
+picofftsg_Plan picofftsg_newPlan(picoos_MemoryManager mm,
+        picoos_int32 rdftSize, picoos_int32 dfctSize)
 {
-    PICOFFTSG_FFTTYPE xi;
+    picofftsg_Plan this;
+    PICOFFTSG_FFTTYPE *w;
+    picoos_int32 i;
 
-    if (isgn >= 0) {
-        if (n > 4) {
-            cftfsub(n, a);
-            rftfsub(n, a);
-        } else if (n == 4) {
-            cftfsub(n, a);
-        }
-        xi = a[0] - a[1];
-        a[0] += a[1];
-        a[1] = xi;
-    } else {
-        a[1] =  (a[0] - a[1]) / 2;
-        a[0] -= a[1];
-        if (n > 4) {
-            rftbsub(n, a);
-            cftbsub(n, a);
-        } else if (n == 4) {
-            cftbsub(n, a);
-        }
+    if ((PICOFFTSG_PLAN_RDFT_SIZE != rdftSize) || (PICOFFTSG_PLAN_DFCT_SIZE != dfctSize)) {
+        return NULL;
+    }
+    this = (picofftsg_Plan) picoos_allocate(mm, sizeof(*this));
+    if (NULL == this) {
+        return NULL;
+    }
+    w = this->w;
+    this->b1stW = w;
+    w = makewt1(rdftSize, w);
+    this->mdl1W = w;
+    w = makewt1(64, w);
+    this->mdl2W = w;
+    w = makewt2(64, w);
+    this->rftbW = w;
+    w = makert(rdftSize, w);
+    for (i = 0; i < 4; i++) {
+        this->rftfW[i] = w;
+        w = makert(8 << i, w);
+        this->dctW[i] = w;
+        w = makect(8 << i, w);
     }
+    PICODBG_ASSERT(w == this->w + PICOFFTSG_PLAN_TWIDDLES);
 
+    makeipt(rdftSize >> 1, &this->rdftIp);
+    makeipt(32, &this->cftIp);
+    for (i = 0; i < 6; i++) {
+        makeipt(4 << i, &this->dctIp[i]);
+    }
+#if defined(PICODSP_FLOAT)
+    makeflt(this);
+#endif
+    return this;
 }
 
+void picofftsg_disposePlan(picoos_MemoryManager mm, picofftsg_Plan * this)
+{
+    if (NULL != (*this)) {
+        picoos_deallocate(mm, (void *) this);
+    }
+}
 
-picoos_single norm_result(picoos_int32 m2, PICOFFTSG_FFTTYPE *tmpX, PICOFFTSG_FFTTYPE *norm_window)
+void picofftsg_rdftInv(picofftsg_Plan this, PICOFFTSG_FFTTYPE *a)
+{
+    a[1] =  (a[0] - a[1]) / 2;
+    a[0] -= a[1];
+    rftbsub(PICOFFTSG_PLAN_RDFT_SIZE, a, this->rftbW);
+    cftbsub(this, a);
+}
+
+
+picoos_single norm_result(picoos_int32 m2, PICOFFTSG_FFTTYPE *tmpX, const PICOFFTSG_FFTTYPE *norm_window)
 {
     picoos_int16 nI;
     PICOFFTSG_FFTTYPE a,b, E;
@@ -483,56 +384,41 @@ picoos_single norm_result(picoos_int32 m2, PICOFFTSG_FFTTYPE *tmpX, PICOFFTSG_FF
     }
 }
 
-void ddct(picoos_int32 n, picoos_int32 isgn, PICOFFTSG_FFTTYPE *a)
+void ddct(picofftsg_plan_t *plan, picoos_int32 n, PICOFFTSG_FFTTYPE *a)
 {
-    picoos_int32 j;
+    picoos_int32 i, j;
     PICOFFTSG_FFTTYPE xr;
 
-    if (isgn < 0) {
-        xr = a[n - 1];
-        for (j = n - 2; j >= 2; j -= 2) {
-            a[j + 1] = a[j] - a[j - 1];
-            a[j] += a[j - 1];
-        }
-        a[1] = a[0] - xr;
-        a[0] += xr;
-        if (n > 4) {
-            rftbsub(n, a);
-            cftbsub(n, a);
-        } else if (n == 4) {
-            cftbsub(n, a);
-        }
+    for (i = 0; (8 << i) < n; i++) {
+        /* index of the twiddle factors of size n */
     }
     if (n > 4) {
-        dctsub(n, a);
+        dctsub(n, a, plan->dctW[i]);
+        cftfsub(plan, n, a);
+        rftfsub(n, a, plan->rftfW[i]);
     } else {
         dctsub4(n, a);
-    }
-    if (isgn >= 0) {
-        if (n > 4) {
-            cftfsub(n, a);
-            rftfsub(n, a);
-        } else if (n == 4) {
-            cftfsub(n, a);
+        if (n == 4) {
+            cftfsub(plan, n, a);
         }
+    }
 
-
-        xr = a[0] - a[1];
-        a[0] += a[1];
-        for (j = 2; j < n; j += 2) {
-            a[j - 1] = a[j] - a[j + 1];
-            a[j] += a[j + 1];
-        }
-        a[n - 1] = xr;
+    xr = a[0] - a[1];
+    a[0] += a[1];
+    for (j = 2; j < n; j += 2) {
+        a[j - 1] = a[j] - a[j + 1];
+        a[j] += a[j + 1];
     }
+    a[n - 1] = xr;
 }
 
-void dfct_nmf(picoos_int32 n, picoos_int32 *a)
+void picofftsg_dfctNmf(picofftsg_Plan this, PICOFFTSG_FFTTYPE *a)
 {
-    picoos_int32 j, k, m, mh;
+    picoos_int32 i, j, k, m, mh, n;
     PICOFFTSG_FFTTYPE xr, xi, yr, yi, an;
     PICOFFTSG_FFTTYPE *aj, *ak, *amj, *amk;
 
+    n = PICOFFTSG_PLAN_DFCT_SIZE;
     m = n >> 1;
     for (j = 0; j < m; j++) {
         k = n - j;
@@ -541,10 +427,11 @@ void dfct_nmf(picoos_int32 n, picoos_int32 *a)
         a[k] = xr;
     }
     an = a[n];
+    i = 4; /* this->dctIp[i] is the bit reversal of m elements */
     while (m >= 2) {
-        ddct(m, 1, a);
+        ddct(this, m, a);
         if (m > 2) {
-            bitrv1(m, a);
+            bitrv1(&this->dctIp[i], a);
         }
         mh = m >> 1;
         xi = a[m];
@@ -568,18 +455,119 @@ void dfct_nmf(picoos_int32 n, picoos_int32 *a)
         *amj = xr;
 
         m = mh;
+        i--;
     }
 
     xi = a[1];
     a[1] = a[0];
     a[0] = an + xi;
     a[n] = an - xi;
-    if (n > 2) {
-        bitrv1(n, a);
+    bitrv1(&this->dctIp[5], a);
+}
+
+#if defined(PICODSP_FLOAT)
+void picofftsg_rdftInvFloat(picofftsg_Plan this, picoos_single *a)
+{
+    picoos_int32 j, k;
+    picoos_single sr, si, dr, di, tr, ti;
+    const picoos_single *u, *v;
+#if defined(PICODSP_SIMD)
+    static const picoos_single conj[4] = { 1.0f, -1.0f, 1.0f, -1.0f };
+    static const picoos_single half[4] = { 0.5f, 0.5f, 0.5f, 0.5f };
+    picodsp_fvec_t vconj, vhalf, vp, vq, vs, vd, vt;
+#endif
+
+    /* spectrum of the complex signal z[m] = a[2*m] + i*a[2*m+1]: with
+       Y[j] = R[j] - i*I[j] (stored as its conjugate), S = Y[j] + Y*[m-j],
+       D = Y[j] - Y*[m-j] and T = i*w^j*D, w = exp(2*pi*i/n):
+       C[j] = (S + T)/2 and C[m-j] = ((S - T)/2)*; C[m/2] = Y*[m/2] is
+       left as it is */
+    sr = a[0];
+    a[0] = 0.5f * (sr + a[1]);
+    a[1] = 0.5f * (sr - a[1]);
+    u = this->fltRftU;
+    v = this->fltRftV;
+    j = 2;
+    k = PICOFFTSG_PLAN_RDFT_SIZE - 2;
+#if defined(PICODSP_SIMD)
+    /* two values of j and of m-j at a time; the latter in reversed order */
+    vconj = picodsp_fvload(conj);
+    vhalf = picodsp_fvload(half);
+    for (; j + 4 < k; j += 4, k -= 4) {
+        vp = picodsp_fvmul(picodsp_fvload(a + j), vconj);
+        vq = picodsp_fvrev(picodsp_fvload(a + k - 2));
+        vs = picodsp_fvmul(picodsp_fvadd(vp, vq), vhalf);
+        vd = picodsp_fvsub(vp, vq);
+        vt = picodsp_fvadd(picodsp_fvmul(picodsp_fvload(u + j), picodsp_fvswap(vd)),
+                picodsp_fvmul(picodsp_fvload(v + j), vd));
+        picodsp_fvstore(a + j, picodsp_fvadd(vs, vt));
+        picodsp_fvstore(a + k - 2, picodsp_fvrev(picodsp_fvmul(picodsp_fvsub(vs, vt), vconj)));
+    }
+#endif
+    for (; j < k; j += 2, k -= 2) {
+        sr = 0.5f * (a[j] + a[k]);
+        si = 0.5f * (a[k + 1] - a[j + 1]);
+        dr = a[j] - a[k];
+        di = -a[j + 1] - a[k + 1];
+        tr = u[j] * di + v[j] * dr;
+        ti = u[j + 1] * dr + v[j + 1] * di;
+        a[j] = sr + tr;
+        a[j + 1] = si + ti;
+        a[k] = sr - tr;
+        a[k + 1] = ti - si;
     }
+    cftbflt(this, a);
+}
+
+void picofftsg_dfctNmfFloat(picofftsg_Plan this, picoos_single *a)
+{
+    picoos_int32 j, n;
+    picoos_single a0, an;
 
+    /* C[k] is the IRDFT of size 2*n of R[j] = a[j], I[j] = 0, plus
+       (a[0] + a[n]*cos(pi*k))/2 */
+    n = PICOFFTSG_PLAN_RDFT_SIZE >> 1;
+    a0 = a[0];
+    an = a[n];
+    for (j = n - 1; j > 0; j--) {
+        a[2 * j] = a[j];
+        a[2 * j + 1] = 0;
+    }
+    a[1] = an;
+    picofftsg_rdftInvFloat(this, a);
+    a0 *= 0.5f;
+    an *= 0.5f;
+    for (j = 0; j < n; j += 2) {
+        a[j] += a0 + an;
+        a[j + 1] += a0 - an;
+    }
+    a[n] += a0 + an;
 }
 
+picoos_single norm_result_float(picoos_int32 m2, picoos_single *tmpX, const PICOFFTSG_FFTTYPE *norm_window)
+{
+    picoos_int16 nI;
+    picoos_single a;
+    picoos_double E;
+
+    /* as norm_result, without the truncations */
+    E = 0.0;
+    for (nI=0; nI<m2; nI++) {
+        a = (picoos_single) norm_window[nI] * tmpX[nI] * (1.0f / (1 << 29));
+        tmpX[nI] = a;
+        a *= 1.0f / (1 << 18);
+        E += a * a;
+    }
+
+    if (E>0) {
+        return (picoos_single)sqrt(E/16.0)/m2;
+    }
+    else {
+        return 0.0;
+    }
+}
+#endif
+
 /* ***********************************************************************************************/
 /* internal routines */
 /* ***********************************************************************************************/
@@ -606,20 +594,109 @@ static PICOFFTSG_FFTTYPE picofftsg_mult_w_a(PICOFFTSG_FFTTYPE x1, PICOFFTSG_FFTT
     return x * y;
 }
 
-static void cftfsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
+#if defined(PICODSP_SIMD)
+/*
+  vector kernels: two neighbouring complex values (re, im, re, im) per vector.
+  Twiddle factors are passed as (w0r, w0i, w1r, w1i), already shifted as by
+  picofftsg_mult_w_w (see picofftsg_vtwiddle); the sums of products are formed
+  in the same way as by the scalar code, so that the results are identical.
+ */
+#define picofftsg_vnegre() picodsp_vset(-1, 0, -1, 0)
+#define picofftsg_vnegim() picodsp_vset(0, -1, 0, -1)
+
+/* the twiddle factors (w0r, w0i) and (w1r, w1i) in the form used by the
+   vector kernels */
+#define picofftsg_vtwiddle(w0r, w0i, w1r, w1i) \
+    picodsp_vshrsym(picodsp_vset((w0r), (w0i), (w1r), (w1i)), 15)
+
+/* the same for the twiddle factors (w[0], w[1]) and (w[2], w[3]) of a plan */
+#define picofftsg_vloadw(w) picodsp_vshrsym(picodsp_vload(w), 15)
+
+/* the twiddle factors in reverse order and with real and imaginary parts
+   swapped: (w1i, w1r, w0i, w0r), as used for the values mirrored at the
+   middle of a butterfly span */
+#define picofftsg_vmirror(w) picodsp_vswap(picodsp_vrev(w))
+
+/* w * x per complex value, like (Mult_W_W(wr, xr) - Mult_W_W(wi, xi),
+   Mult_W_W(wr, xi) + Mult_W_W(wi, xr)); with 'negim' instead of 'negre' as
+   'mask', conj(w) * x */
+static __inline picodsp_vec_t picofftsg_vcmul(picodsp_vec_t w, picodsp_vec_t x,
+        picodsp_vec_t mask)
+{
+    x = picodsp_vshrsym(x, 14);
+    return picodsp_vadd(picodsp_vmul(picodsp_vdupre(w), x),
+            picodsp_vmul(picodsp_vneg(picodsp_vdupim(w), mask), picodsp_vswap(x)));
+}
+
+/* radix-4 butterflies of cftmdl1 (isgn >= 0) or cftb1st (isgn < 0) on the
+   two complex values at a[0] and their counterparts at a[m], a[2m], a[3m] */
+static void cftvmdl1(picoos_int32 m, picoos_int32 isgn, PICOFFTSG_FFTTYPE *a,
+        picodsp_vec_t w1, picodsp_vec_t w3)
+{
+    picodsp_vec_t negre, negim, a0, a1, a2, a3, x0, x1, x2, x3;
+
+    negre = picofftsg_vnegre();
+    negim = picofftsg_vnegim();
+    a0 = picodsp_vload(a);
+    a1 = picodsp_vload(a + m);
+    a2 = picodsp_vload(a + 2 * m);
+    a3 = picodsp_vload(a + 3 * m);
+    x0 = picodsp_vadd(a0, a2);
+    x1 = picodsp_vsub(a0, a2);
+    x2 = picodsp_vadd(a1, a3);
+    x3 = picodsp_vsub(a1, a3);
+    if (isgn >= 0) {
+        x3 = picodsp_vneg(picodsp_vswap(x3), negre);
+    } else {
+        /* conjugated input */
+        x0 = picodsp_vneg(x0, negim);
+        x1 = picodsp_vneg(x1, negim);
+        x2 = picodsp_vneg(x2, negim);
+        x3 = picodsp_vswap(x3);
+    }
+    picodsp_vstore(a, picodsp_vadd(x0, x2));
+    picodsp_vstore(a + m, picodsp_vsub(x0, x2));
+    picodsp_vstore(a + 2 * m, picofftsg_vcmul(w1, picodsp_vadd(x1, x3), negre));
+    picodsp_vstore(a + 3 * m, picofftsg_vcmul(w3, picodsp_vsub(x1, x3), negim));
+}
+
+/* radix-4 butterflies of cftmdl2 on the two complex values at a[0] and their
+   counterparts at a[m], a[2m], a[3m] */
+static void cftvmdl2(picoos_int32 m, PICOFFTSG_FFTTYPE *a, picodsp_vec_t w1a,
+        picodsp_vec_t w1b, picodsp_vec_t w3a, picodsp_vec_t w3b)
+{
+    picodsp_vec_t negre, negim, a0, a1, a2, a3, x0, x1, x2, x3, y0, y2;
+
+    negre = picofftsg_vnegre();
+    negim = picofftsg_vnegim();
+    a0 = picodsp_vload(a);
+    a1 = picodsp_vload(a + m);
+    a2 = picodsp_vneg(picodsp_vswap(picodsp_vload(a + 2 * m)), negre);
+    a3 = picodsp_vneg(picodsp_vswap(picodsp_vload(a + 3 * m)), negre);
+    x0 = picodsp_vadd(a0, a2);
+    x1 = picodsp_vsub(a0, a2);
+    x2 = picodsp_vadd(a1, a3);
+    x3 = picodsp_vsub(a1, a3);
+    y0 = picofftsg_vcmul(w1a, x0, negre);
+    y2 = picofftsg_vcmul(w1b, x2, negre);
+    picodsp_vstore(a, picodsp_vadd(y0, y2));
+    picodsp_vstore(a + m, picodsp_vsub(y0, y2));
+    y0 = picofftsg_vcmul(w3a, x1, negim);
+    y2 = picofftsg_vcmul(w3b, x3, negim);
+    picodsp_vstore(a + 2 * m, picodsp_vadd(y0, y2));
+    picodsp_vstore(a + 3 * m, picodsp_vsub(y0, y2));
+}
+#endif
+
+static void cftfsub(picofftsg_plan_t *plan, picoos_int32 n, PICOFFTSG_FFTTYPE *a)
 {
 
     if (n > 8) {
         if (n > 32) {
-            cftmdl1(n, a);
-                if (n > 512) {
-                    cftrec4(n, a);
-                } else if (n > 128) {
-                    cftleaf(n, 1, a);
-                } else {
-                    cftfx41(n, a);
-                }
-            bitrv2(n, a);
+            /* n == 64, as planned */
+            cftmdl1(n, a, plan->mdl1W);
+            cftfx41(n, a);
+            bitrv2(&plan->cftIp, a);
         } else if (n == 32) {
             cftf161(a);
             bitrv216(a);
@@ -635,759 +712,44 @@ static void cftfsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
 }
 
 
-void cftbsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
+/* n == PICOFFTSG_PLAN_RDFT_SIZE */
+void cftbsub(picofftsg_plan_t *plan, PICOFFTSG_FFTTYPE *a)
 {
-    if (n > 8) {
-        if (n > 32) {
-            cftb1st(n, a);
-                if (n > 512) {
-                    cftrec4(n, a);
-                } else if (n > 128) {
-                    cftleaf(n, 1, a);
-                } else {
-                    cftfx41(n, a);
-                }
-            bitrv2conj(n, a);
-        } else if (n == 32) {
-            cftf161(a);
-            bitrv216neg(a);
-        } else {
-            cftf081(a);
-            bitrv208neg(a);
-        }
-    } else if (n == 8) {
-        cftb040(a);
-    } else if (n == 4) {
-        cftx020(a);
-    }
+    cftb1st(PICOFFTSG_PLAN_RDFT_SIZE, a, plan->b1stW);
+    cftleaf(a, plan->mdl1W, plan->mdl2W);
+    bitrv2conj(PICOFFTSG_PLAN_RDFT_SIZE, &plan->rdftIp, a);
 }
 
 /* **************************************************************************************************/
 
 /* **************************************************************************************************/
-void bitrv2(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
+/* bit reversal of the complex values in a, exchanging the pairs listed in ip */
+void bitrv2(const picofftsg_perm_t *ip, PICOFFTSG_FFTTYPE *a)
 {
-    picoos_int32 j0, k0, j1, k1, l, m, i, j, k, nh, m2;
-    PICOFFTSG_FFTTYPE xr, xi, yr, yi;
-
-    m = 4;
-    for (l = n >> 2; l > 8; l >>= 2) {
-        m <<= 1;
-    }
-    m2 = m + m;
-    nh = n >> 1;
-    if (l == 8) {
-        j0 = 0;
-        for (k0 = 0; k0 < m; k0 += 4) {
-            k = k0;
-            for (j = j0; j < j0 + k0; j += 4) {
-                xr = a[j];
-                xi = a[j + 1];
-                yr = a[k];
-                yi = a[k + 1];
-                a[j] = yr;
-                a[j + 1] = yi;
-                a[k] = xr;
-                a[k + 1] = xi;
-                j1 = j + m;
-                k1 = k + m2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m;
-                k1 -= m;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m;
-                k1 += m2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += nh;
-                k1 += 2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 -= m2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 += m;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 -= m2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += 2;
-                k1 += nh;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m;
-                k1 += m2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m;
-                k1 -= m;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m;
-                k1 += m2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= nh;
-                k1 -= 2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 -= m2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 += m;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 -= m2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                for (i = nh >> 1; i > (k ^= i); i >>= 1) {
-                    /* Avoid warning*/
-                };
-            }
-            k1 = j0 + k0;
-            j1 = k1 + 2;
-            k1 += nh;
-            xr = a[j1];
-            xi = a[j1 + 1];
-            yr = a[k1];
-            yi = a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            j1 += m;
-            k1 += m2;
-            xr = a[j1];
-            xi = a[j1 + 1];
-            yr = a[k1];
-            yi = a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            j1 += m;
-            k1 -= m;
-            xr = a[j1];
-            xi = a[j1 + 1];
-            yr = a[k1];
-            yi = a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            j1 -= 2;
-            k1 -= nh;
-            xr = a[j1];
-            xi = a[j1 + 1];
-            yr = a[k1];
-            yi = a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            j1 += nh + 2;
-            k1 += nh + 2;
-            xr = a[j1];
-            xi = a[j1 + 1];
-            yr = a[k1];
-            yi = a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            j1 -= nh - m;
-            k1 += m2 - 2;
-            xr = a[j1];
-            xi = a[j1 + 1];
-            yr = a[k1];
-            yi = a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            for (i = nh >> 1; i > (j0 ^= i); i >>= 1) {
-                /* Avoid warning */
-            }
-        }
-    } else {
-        j0 = 0;
-        for (k0 = 0; k0 < m; k0 += 4) {
-            k = k0;
-            for (j = j0; j < j0 + k0; j += 4) {
-                xr = a[j];
-                xi = a[j + 1];
-                yr = a[k];
-                yi = a[k + 1];
-                a[j] = yr;
-                a[j + 1] = yi;
-                a[k] = xr;
-                a[k + 1] = xi;
-                j1 = j + m;
-                k1 = k + m;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += nh;
-                k1 += 2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 -= m;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += 2;
-                k1 += nh;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m;
-                k1 += m;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= nh;
-                k1 -= 2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 -= m;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                for (i = nh >> 1; i > (k ^= i); i >>= 1){
-                    /* Avoid warning */
-                }
-            }
-            k1 = j0 + k0;
-            j1 = k1 + 2;
-            k1 += nh;
-            xr = a[j1];
-            xi = a[j1 + 1];
-            yr = a[k1];
-            yi = a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            j1 += m;
-            k1 += m;
-            xr = a[j1];
-            xi = a[j1 + 1];
-            yr = a[k1];
-            yi = a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            for (i = nh >> 1; i > (j0 ^= i); i >>= 1){
-                /* Avoid  warning */
-            }
-        }
+    picoos_int32 i, j, k;
+    PICOFFTSG_FFTTYPE xr, xi;
+
+    for (i = 0; i < 2 * ip->num; i += 2) {
+        j = 2 * ip->idx[i];
+        k = 2 * ip->idx[i + 1];
+        xr = a[j];
+        xi = a[j + 1];
+        a[j] = a[k];
+        a[j + 1] = a[k + 1];
+        a[k] = xr;
+        a[k + 1] = xi;
     }
 }
 
 
-void bitrv2conj(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
+/* bit reversal of the n/2 complex values in a, conjugating them */
+void bitrv2conj(picoos_int32 n, const picofftsg_perm_t *ip, PICOFFTSG_FFTTYPE *a)
 {
-    picoos_int32 j0, k0, j1, k1, l, m, i, j, k, nh, m2;
-    PICOFFTSG_FFTTYPE xr, xi, yr, yi;
-
-
-    m = 4;
-    for (l = n >> 2; l > 8; l >>= 2) {
-        m <<= 1;
-    }
-    m2 = m + m;
-    nh = n >> 1;
-    if (l == 8) {
-        j0 = 0;
-        for (k0 = 0; k0 < m; k0 += 4) {
-            k = k0;
-            for (j = j0; j < j0 + k0; j += 4) {
-                xr = a[j];
-                xi = -a[j + 1];
-                yr = a[k];
-                yi = -a[k + 1];
-                a[j] = yr;
-                a[j + 1] = yi;
-                a[k] = xr;
-                a[k + 1] = xi;
-                j1 = j + m;
-                k1 = k + m2;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m;
-                k1 -= m;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m;
-                k1 += m2;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += nh;
-                k1 += 2;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 -= m2;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 += m;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 -= m2;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += 2;
-                k1 += nh;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m;
-                k1 += m2;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m;
-                k1 -= m;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m;
-                k1 += m2;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= nh;
-                k1 -= 2;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 -= m2;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 += m;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 -= m2;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                for (i = nh >> 1; i > (k ^= i); i >>= 1) {
-                    /* Avoid warning */
-                }
-            }
-            k1 = j0 + k0;
-            j1 = k1 + 2;
-            k1 += nh;
-            a[j1 - 1] = -a[j1 - 1];
-            xr = a[j1];
-            xi = -a[j1 + 1];
-            yr = a[k1];
-            yi = -a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            a[k1 + 3] = -a[k1 + 3];
-            j1 += m;
-            k1 += m2;
-            xr = a[j1];
-            xi = -a[j1 + 1];
-            yr = a[k1];
-            yi = -a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            j1 += m;
-            k1 -= m;
-            xr = a[j1];
-            xi = -a[j1 + 1];
-            yr = a[k1];
-            yi = -a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            j1 -= 2;
-            k1 -= nh;
-            xr = a[j1];
-            xi = -a[j1 + 1];
-            yr = a[k1];
-            yi = -a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            j1 += nh + 2;
-            k1 += nh + 2;
-            xr = a[j1];
-            xi = -a[j1 + 1];
-            yr = a[k1];
-            yi = -a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            j1 -= nh - m;
-            k1 += m2 - 2;
-            a[j1 - 1] = -a[j1 - 1];
-            xr = a[j1];
-            xi = -a[j1 + 1];
-            yr = a[k1];
-            yi = -a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            a[k1 + 3] = -a[k1 + 3];
-            for (i = nh >> 1; i > (j0 ^= i); i >>= 1) { /* Avoid warning*/
+    picoos_int32 j;
 
-            }
-        }
-    } else {
-        j0 = 0;
-        for (k0 = 0; k0 < m; k0 += 4) {
-            k = k0;
-            for (j = j0; j < j0 + k0; j += 4) {
-                xr = a[j];
-                xi = -a[j + 1];
-                yr = a[k];
-                yi = -a[k + 1];
-                a[j] = yr;
-                a[j + 1] = yi;
-                a[k] = xr;
-                a[k + 1] = xi;
-                j1 = j + m;
-                k1 = k + m;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += nh;
-                k1 += 2;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 -= m;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += 2;
-                k1 += nh;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m;
-                k1 += m;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= nh;
-                k1 -= 2;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 -= m;
-                k1 -= m;
-                xr = a[j1];
-                xi = -a[j1 + 1];
-                yr = a[k1];
-                yi = -a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                for (i = nh >> 1; i > (k ^= i); i >>= 1) {
-                    /* Avoid warning*/
-                }
-            }
-            k1 = j0 + k0;
-            j1 = k1 + 2;
-            k1 += nh;
-            a[j1 - 1] = -a[j1 - 1];
-            xr = a[j1];
-            xi = -a[j1 + 1];
-            yr = a[k1];
-            yi = -a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            a[k1 + 3] = -a[k1 + 3];
-            j1 += m;
-            k1 += m;
-            a[j1 - 1] = -a[j1 - 1];
-            xr = a[j1];
-            xi = -a[j1 + 1];
-            yr = a[k1];
-            yi = -a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-            a[k1 + 3] = -a[k1 + 3];
-            for (i = nh >> 1; i > (j0 ^= i); i >>= 1) {
-                /* Avoid warning*/
-            }
-        }
+    bitrv2(ip, a);
+    for (j = 1; j < n; j += 2) {
+        a[j] = -a[j];
     }
 }
 
@@ -1449,76 +811,6 @@ void bitrv216(PICOFFTSG_FFTTYPE *a)
 }
 
 
-void bitrv216neg(PICOFFTSG_FFTTYPE *a)
-{
-    PICOFFTSG_FFTTYPE x1r, x1i, x2r, x2i, x3r, x3i, x4r, x4i,
-        x5r, x5i, x6r, x6i, x7r, x7i, x8r, x8i,
-        x9r, x9i, x10r, x10i, x11r, x11i, x12r, x12i,
-        x13r, x13i, x14r, x14i, x15r, x15i;
-
-    x1r = a[2];
-    x1i = a[3];
-    x2r = a[4];
-    x2i = a[5];
-    x3r = a[6];
-    x3i = a[7];
-    x4r = a[8];
-    x4i = a[9];
-    x5r = a[10];
-    x5i = a[11];
-    x6r = a[12];
-    x6i = a[13];
-    x7r = a[14];
-    x7i = a[15];
-    x8r = a[16];
-    x8i = a[17];
-    x9r = a[18];
-    x9i = a[19];
-    x10r = a[20];
-    x10i = a[21];
-    x11r = a[22];
-    x11i = a[23];
-    x12r = a[24];
-    x12i = a[25];
-    x13r = a[26];
-    x13i = a[27];
-    x14r = a[28];
-    x14i = a[29];
-    x15r = a[30];
-    x15i = a[31];
-    a[2] = x15r;
-    a[3] = x15i;
-    a[4] = x7r;
-    a[5] = x7i;
-    a[6] = x11r;
-    a[7] = x11i;
-    a[8] = x3r;
-    a[9] = x3i;
-    a[10] = x13r;
-    a[11] = x13i;
-    a[12] = x5r;
-    a[13] = x5i;
-    a[14] = x9r;
-    a[15] = x9i;
-    a[16] = x1r;
-    a[17] = x1i;
-    a[18] = x14r;
-    a[19] = x14i;
-    a[20] = x6r;
-    a[21] = x6i;
-    a[22] = x10r;
-    a[23] = x10i;
-    a[24] = x2r;
-    a[25] = x2i;
-    a[26] = x12r;
-    a[27] = x12i;
-    a[28] = x4r;
-    a[29] = x4i;
-    a[30] = x8r;
-    a[31] = x8i;
-}
-
-
 void bitrv208(PICOFFTSG_FFTTYPE *a)
 {
     PICOFFTSG_FFTTYPE x1r, x1i, x3r, x3i, x4r, x4i, x6r, x6i;
@@ -1542,158 +834,18 @@ void bitrv208(PICOFFTSG_FFTTYPE *a)
 }
 
 
-void bitrv208neg(PICOFFTSG_FFTTYPE *a)
-{
-    PICOFFTSG_FFTTYPE x1r, x1i, x2r, x2i, x3r, x3i, x4r, x4i,
-        x5r, x5i, x6r, x6i, x7r, x7i;
-
-    x1r = a[2];
-    x1i = a[3];
-    x2r = a[4];
-    x2i = a[5];
-    x3r = a[6];
-    x3i = a[7];
-    x4r = a[8];
-    x4i = a[9];
-    x5r = a[10];
-    x5i = a[11];
-    x6r = a[12];
-    x6i = a[13];
-    x7r = a[14];
-    x7i = a[15];
-    a[2] = x7r;
-    a[3] = x7i;
-    a[4] = x3r;
-    a[5] = x3i;
-    a[6] = x5r;
-    a[7] = x5i;
-    a[8] = x1r;
-    a[9] = x1i;
-    a[10] = x6r;
-    a[11] = x6i;
-    a[12] = x2r;
-    a[13] = x2i;
-    a[14] = x4r;
-    a[15] = x4i;
-}
-
-
-void bitrv1(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
+/* bit reversal of the real values in a, exchanging the pairs listed in ip */
+void bitrv1(const picofftsg_perm_t *ip, PICOFFTSG_FFTTYPE *a)
 {
-    picoos_int32 j0, k0, j1, k1, l, m, i, j, k, nh;
+    picoos_int32 i, j, k;
     PICOFFTSG_FFTTYPE x;
-    nh = n >> 1;
-    x = a[1];
-    a[1] = a[nh];
-    a[nh] = x;
-    m = 2;
-    for (l = n >> 2; l > 2; l >>= 2) {
-        m <<= 1;
-    }
-    if (l == 2) {
-        j1 = m + 1;
-        k1 = m + nh;
-        x = a[j1];
-        a[j1] = a[k1];
-        a[k1] = x;
-        j0 = 0;
-        for (k0 = 2; k0 < m; k0 += 2) {
-            for (i = nh >> 1; i > (j0 ^= i); i >>= 1) {
-                /* Avoid warning*/
-            }
-            k = k0;
-            for (j = j0; j < j0 + k0; j += 2) {
-                x = a[j];
-                a[j] = a[k];
-                a[k] = x;
-                j1 = j + m;
-                k1 = k + m;
-                x = a[j1];
-                a[j1] = a[k1];
-                a[k1] = x;
-                j1 += nh;
-                k1++;
-                x = a[j1];
-                a[j1] = a[k1];
-                a[k1] = x;
-                j1 -= m;
-                k1 -= m;
-                x = a[j1];
-                a[j1] = a[k1];
-                a[k1] = x;
-                j1++;
-                k1 += nh;
-                x = a[j1];
-                a[j1] = a[k1];
-                a[k1] = x;
-                j1 += m;
-                k1 += m;
-                x = a[j1];
-                a[j1] = a[k1];
-                a[k1] = x;
-                j1 -= nh;
-                k1--;
-                x = a[j1];
-                a[j1] = a[k1];
-                a[k1] = x;
-                j1 -= m;
-                k1 -= m;
-                x = a[j1];
-                a[j1] = a[k1];
-                a[k1] = x;
-                for (i = nh >> 1; i > (k ^= i); i >>= 1) {
-                    /* Avoid warning*/
-                }
-            }
-            k1 = j0 + k0;
-            j1 = k1 + 1;
-            k1 += nh;
-            x = a[j1];
-            a[j1] = a[k1];
-            a[k1] = x;
-            j1 += m;
-            k1 += m;
-            x = a[j1];
-            a[j1] = a[k1];
-            a[k1] = x;
-        }
-    } else {
-        j0 = 0;
-        for (k0 = 2; k0 < m; k0 += 2) {
-            for (i = nh >> 1; i > (j0 ^= i); i >>= 1) {
-                /* Avoid warning*/
-            }
-            k = k0;
-            for (j = j0; j < j0 + k0; j += 2) {
-                x = a[j];
-                a[j] = a[k];
-                a[k] = x;
-                j1 = j + nh;
-                k1 = k + 1;
-                x = a[j1];
-                a[j1] = a[k1];
-                a[k1] = x;
-                j1++;
-                k1 += nh;
-                x = a[j1];
-                a[j1] = a[k1];
-                a[k1] = x;
-                j1 -= nh;
-                k1--;
-                x = a[j1];
-                a[j1] = a[k1];
-                a[k1] = x;
-                for (i = nh >> 1; i > (k ^= i); i >>= 1) {
-                    /* Avoid warning*/
-                }
-            }
-            k1 = j0 + k0;
-            j1 = k1 + 1;
-            k1 += nh;
-            x = a[j1];
-            a[j1] = a[k1];
-            a[k1] = x;
-        }
+
+    for (i = 0; i < 2 * ip->num; i += 2) {
+        j = ip->idx[i];
+        k = ip->idx[i + 1];
+        x = a[j];
+        a[j] = a[k];
+        a[k] = x;
     }
 }
 
@@ -1702,12 +854,16 @@ void bitrv1(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
 
 /* **************************************************************************************************/
 
-void cftb1st(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
+void cftb1st(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w)
 {
-    picoos_int32 i, i0, j, j0, j1, j2, j3, m, mh;
-    PICOFFTSG_FFTTYPE wk1r, wk1i, wk3r, wk3i,
-        wd1r, wd1i, wd3r, wd3i, ss1, ss3;
+    picoos_int32 j, j0, j1, j2, j3, m, mh;
+    PICOFFTSG_FFTTYPE wk1r, wk1i, wk3r, wk3i, wd1r;
     PICOFFTSG_FFTTYPE x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+#if defined(PICODSP_SIMD)
+    picodsp_vec_t w1, w3;
+#else
+    PICOFFTSG_FFTTYPE wd1i, wd3r, wd3i;
+#endif
 
     mh = n >> 3;
     m = 2 * mh;
@@ -1730,127 +886,114 @@ void cftb1st(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
     a[j2 + 1] = x1i + x3r;
     a[j3] = x1r - x3i;
     a[j3 + 1] = x1i - x3r;
-    wd1r = PICODSP_WGT_SHIFT;
-    wd1i = 0;
-    wd3r = PICODSP_WGT_SHIFT;
-    wd3i = 0;
-
-    wk1r  = (PICOFFTSG_FFTTYPE) (0.998795449734  *PICODSP_WGT_SHIFT);
-    wk1i  = (PICOFFTSG_FFTTYPE) (0.049067676067  *PICODSP_WGT_SHIFT);
-    ss1   = (PICOFFTSG_FFTTYPE) (0.098135352135  *PICODSP_WGT_SHIFT);
-    wk3i  = (PICOFFTSG_FFTTYPE) (-0.146730467677 *PICODSP_WGT_SHIFT);
-    wk3r  = (PICOFFTSG_FFTTYPE) (0.989176511765  *PICODSP_WGT_SHIFT);
-    ss3   = (PICOFFTSG_FFTTYPE) (-0.293460935354 *PICODSP_WGT_SHIFT);
-
-    i = 0;
-    for (;;) {
-        i0 = i + CDFT_LOOP_DIV_4;
-        if (i0 > mh - 4) {
-            i0 = mh - 4;
-        }
-        for (j = i + 2; j < i0; j += 4) {
-
-            wd1r -= Mult_W_W(ss1, wk1i);
-            wd1i += Mult_W_W(ss1, wk1r);
-            wd3r -= Mult_W_W(ss3, wk3i);
-            wd3i += Mult_W_W(ss3, wk3r);
-
-            j1 = j + m;
-            j2 = j1 + m;
-            j3 = j2 + m;
-            x0r = a[j] + a[j2];
-            x0i = -a[j + 1] - a[j2 + 1];
-            x1r = a[j] - a[j2];
-            x1i = -a[j + 1] + a[j2 + 1];
-            x2r = a[j1] + a[j3];
-            x2i = a[j1 + 1] + a[j3 + 1];
-            x3r = a[j1] - a[j3];
-            x3i = a[j1 + 1] - a[j3 + 1];
-            a[j] = x0r + x2r;
-            a[j + 1] = x0i - x2i;
-            a[j1] = x0r - x2r;
-            a[j1 + 1] = x0i + x2i;
-            x0r = x1r + x3i;
-            x0i = x1i + x3r;
-            a[j2] = Mult_W_W(wk1r, x0r) - Mult_W_W(wk1i, x0i);
-            a[j2 + 1] = Mult_W_W(wk1r, x0i) + Mult_W_W(wk1i, x0r);
-            x0r = x1r - x3i;
-            x0i = x1i - x3r;
-            a[j3] = Mult_W_W(wk3r, x0r) + Mult_W_W(wk3i, x0i);
-            a[j3 + 1] = Mult_W_W(wk3r, x0i) - Mult_W_W(wk3i, x0r);
-            x0r = a[j + 2] + a[j2 + 2];
-            x0i = -a[j + 3] - a[j2 + 3];
-            x1r = a[j + 2] - a[j2 + 2];
-            x1i = -a[j + 3] + a[j2 + 3];
-            x2r = a[j1 + 2] + a[j3 + 2];
-            x2i = a[j1 + 3] + a[j3 + 3];
-            x3r = a[j1 + 2] - a[j3 + 2];
-            x3i = a[j1 + 3] - a[j3 + 3];
-            a[j + 2] = x0r + x2r;
-            a[j + 3] = x0i - x2i;
-            a[j1 + 2] = x0r - x2r;
-            a[j1 + 3] = x0i + x2i;
-            x0r = x1r + x3i;
-            x0i = x1i + x3r;
-            a[j2 + 2] = Mult_W_W(wd1r, x0r) - Mult_W_W(wd1i, x0i);
-            a[j2 + 3] = Mult_W_W(wd1r, x0i) + Mult_W_W(wd1i, x0r);
-            x0r = x1r - x3i;
-            x0i = x1i - x3r;
-            a[j3 + 2] = Mult_W_W(wd3r, x0r) + Mult_W_W(wd3i, x0i);
-            a[j3 + 3] = Mult_W_W(wd3r, x0i) - Mult_W_W(wd3i, x0r);
-            j0 = m - j;
-            j1 = j0 + m;
-            j2 = j1 + m;
-            j3 = j2 + m;
-            x0r = a[j0] + a[j2];
-            x0i = -a[j0 + 1] - a[j2 + 1];
-            x1r = a[j0] - a[j2];
-            x1i = -a[j0 + 1] + a[j2 + 1];
-            x2r = a[j1] + a[j3];
-            x2i = a[j1 + 1] + a[j3 + 1];
-            x3r = a[j1] - a[j3];
-            x3i = a[j1 + 1] - a[j3 + 1];
-            a[j0] = x0r + x2r;
-            a[j0 + 1] = x0i - x2i;
-            a[j1] = x0r - x2r;
-            a[j1 + 1] = x0i + x2i;
-            x0r = x1r + x3i;
-            x0i = x1i + x3r;
-            a[j2] = Mult_W_W(wk1i, x0r) - Mult_W_W(wk1r, x0i);
-            a[j2 + 1] = Mult_W_W(wk1i, x0i) + Mult_W_W(wk1r, x0r);
-            x0r = x1r - x3i;
-            x0i = x1i - x3r;
-            a[j3] = Mult_W_W(wk3i, x0r) + Mult_W_W(wk3r, x0i);
-            a[j3 + 1] = Mult_W_W(wk3i, x0i) - Mult_W_W(wk3r, x0r);
-            x0r = a[j0 - 2] + a[j2 - 2];
-            x0i = -a[j0 - 1] - a[j2 - 1];
-            x1r = a[j0 - 2] - a[j2 - 2];
-            x1i = -a[j0 - 1] + a[j2 - 1];
-            x2r = a[j1 - 2] + a[j3 - 2];
-            x2i = a[j1 - 1] + a[j3 - 1];
-            x3r = a[j1 - 2] - a[j3 - 2];
-            x3i = a[j1 - 1] - a[j3 - 1];
-            a[j0 - 2] = x0r + x2r;
-            a[j0 - 1] = x0i - x2i;
-            a[j1 - 2] = x0r - x2r;
-            a[j1 - 1] = x0i + x2i;
-            x0r = x1r + x3i;
-            x0i = x1i + x3r;
-            a[j2 - 2] = Mult_W_W(wd1i, x0r) - Mult_W_W(wd1r, x0i);
-            a[j2 - 1] = Mult_W_W(wd1i, x0i) + Mult_W_W(wd1r, x0r);
-            x0r = x1r - x3i;
-            x0i = x1i - x3r;
-            a[j3 - 2] = Mult_W_W(wd3i, x0r) + Mult_W_W(wd3r, x0i);
-            a[j3 - 1] = Mult_W_W(wd3i, x0i) - Mult_W_W(wd3r, x0r);
-            wk1r -= Mult_W_W(ss1, wd1i);
-            wk1i += Mult_W_W(ss1, wd1r);
-            wk3r -= Mult_W_W(ss3, wd3i);
-            wk3i += Mult_W_W(ss3, wd3r);
-        }
-        if (i0 == mh - 4) {
-            break;
-        }
+    for (j = 2; j < mh - 4; j += 4, w += 8) {
+#if defined(PICODSP_SIMD)
+        w1 = picofftsg_vloadw(w);
+        w3 = picofftsg_vloadw(w + 4);
+        cftvmdl1(m, -1, &a[j], w1, w3);
+        cftvmdl1(m, -1, &a[m - j - 2], picofftsg_vmirror(w1), picofftsg_vmirror(w3));
+#else
+        wk1r = w[0];
+        wk1i = w[1];
+        wd1r = w[2];
+        wd1i = w[3];
+        wk3r = w[4];
+        wk3i = w[5];
+        wd3r = w[6];
+        wd3i = w[7];
+        j1 = j + m;
+        j2 = j1 + m;
+        j3 = j2 + m;
+        x0r = a[j] + a[j2];
+        x0i = -a[j + 1] - a[j2 + 1];
+        x1r = a[j] - a[j2];
+        x1i = -a[j + 1] + a[j2 + 1];
+        x2r = a[j1] + a[j3];
+        x2i = a[j1 + 1] + a[j3 + 1];
+        x3r = a[j1] - a[j3];
+        x3i = a[j1 + 1] - a[j3 + 1];
+        a[j] = x0r + x2r;
+        a[j + 1] = x0i - x2i;
+        a[j1] = x0r - x2r;
+        a[j1 + 1] = x0i + x2i;
+        x0r = x1r + x3i;
+        x0i = x1i + x3r;
+        a[j2] = Mult_W_W(wk1r, x0r) - Mult_W_W(wk1i, x0i);
+        a[j2 + 1] = Mult_W_W(wk1r, x0i) + Mult_W_W(wk1i, x0r);
+        x0r = x1r - x3i;
+        x0i = x1i - x3r;
+        a[j3] = Mult_W_W(wk3r, x0r) + Mult_W_W(wk3i, x0i);
+        a[j3 + 1] = Mult_W_W(wk3r, x0i) - Mult_W_W(wk3i, x0r);
+        x0r = a[j + 2] + a[j2 + 2];
+        x0i = -a[j + 3] - a[j2 + 3];
+        x1r = a[j + 2] - a[j2 + 2];
+        x1i = -a[j + 3] + a[j2 + 3];
+        x2r = a[j1 + 2] + a[j3 + 2];
+        x2i = a[j1 + 3] + a[j3 + 3];
+        x3r = a[j1 + 2] - a[j3 + 2];
+        x3i = a[j1 + 3] - a[j3 + 3];
+        a[j + 2] = x0r + x2r;
+        a[j + 3] = x0i - x2i;
+        a[j1 + 2] = x0r - x2r;
+        a[j1 + 3] = x0i + x2i;
+        x0r = x1r + x3i;
+        x0i = x1i + x3r;
+        a[j2 + 2] = Mult_W_W(wd1r, x0r) - Mult_W_W(wd1i, x0i);
+        a[j2 + 3] = Mult_W_W(wd1r, x0i) + Mult_W_W(wd1i, x0r);
+        x0r = x1r - x3i;
+        x0i = x1i - x3r;
+        a[j3 + 2] = Mult_W_W(wd3r, x0r) + Mult_W_W(wd3i, x0i);
+        a[j3 + 3] = Mult_W_W(wd3r, x0i) - Mult_W_W(wd3i, x0r);
+        j0 = m - j;
+        j1 = j0 + m;
+        j2 = j1 + m;
+        j3 = j2 + m;
+        x0r = a[j0] + a[j2];
+        x0i = -a[j0 + 1] - a[j2 + 1];
+        x1r = a[j0] - a[j2];
+        x1i = -a[j0 + 1] + a[j2 + 1];
+        x2r = a[j1] + a[j3];
+        x2i = a[j1 + 1] + a[j3 + 1];
+        x3r = a[j1] - a[j3];
+        x3i = a[j1 + 1] - a[j3 + 1];
+        a[j0] = x0r + x2r;
+        a[j0 + 1] = x0i - x2i;
+        a[j1] = x0r - x2r;
+        a[j1 + 1] = x0i + x2i;
+        x0r = x1r + x3i;
+        x0i = x1i + x3r;
+        a[j2] = Mult_W_W(wk1i, x0r) - Mult_W_W(wk1r, x0i);
+        a[j2 + 1] = Mult_W_W(wk1i, x0i) + Mult_W_W(wk1r, x0r);
+        x0r = x1r - x3i;
+        x0i = x1i - x3r;
+        a[j3] = Mult_W_W(wk3i, x0r) + Mult_W_W(wk3r, x0i);
+        a[j3 + 1] = Mult_W_W(wk3i, x0i) - Mult_W_W(wk3r, x0r);
+        x0r = a[j0 - 2] + a[j2 - 2];
+        x0i = -a[j0 - 1] - a[j2 - 1];
+        x1r = a[j0 - 2] - a[j2 - 2];
+        x1i = -a[j0 - 1] + a[j2 - 1];
+        x2r = a[j1 - 2] + a[j3 - 2];
+        x2i = a[j1 - 1] + a[j3 - 1];
+        x3r = a[j1 - 2] - a[j3 - 2];
+        x3i = a[j1 - 1] - a[j3 - 1];
+        a[j0 - 2] = x0r + x2r;
+        a[j0 - 1] = x0i - x2i;
+        a[j1 - 2] = x0r - x2r;
+        a[j1 - 1] = x0i + x2i;
+        x0r = x1r + x3i;
+        x0i = x1i + x3r;
+        a[j2 - 2] = Mult_W_W(wd1i, x0r) - Mult_W_W(wd1r, x0i);
+        a[j2 - 1] = Mult_W_W(wd1i, x0i) + Mult_W_W(wd1r, x0r);
+        x0r = x1r - x3i;
+        x0i = x1i - x3r;
+        a[j3 - 2] = Mult_W_W(wd3i, x0r) + Mult_W_W(wd3r, x0i);
+        a[j3 - 1] = Mult_W_W(wd3i, x0i) - Mult_W_W(wd3r, x0r);
+#endif
     }
+    wk1r = w[0];
+    wk1i = w[1];
+    wk3r = w[2];
+    wk3i = w[3];
     wd1r = WR5000;
     j0 = mh;
     j1 = j0 + m;
@@ -1908,133 +1051,52 @@ void cftb1st(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
     a[j0 + 3] = x0i - x2i;
     a[j1 + 2] = x0r - x2r;
     a[j1 + 3] = x0i + x2i;
-    x0r = x1r + x3i;
-    x0i = x1i + x3r;
-    a[j2 + 2] = Mult_W_W(wk1i, x0r) - Mult_W_W(wk1r, x0i);
-    a[j2 + 3] = Mult_W_W(wk1i, x0i) + Mult_W_W(wk1r, x0r);
-    x0r = x1r - x3i;
-    x0i = x1i - x3r;
-    a[j3 + 2] = Mult_W_W(wk3i, x0r) + Mult_W_W(wk3r, x0i);
-    a[j3 + 3] = Mult_W_W(wk3i, x0i) - Mult_W_W(wk3r, x0r);
-}
-
-void cftrec4(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
-{
-    picoos_int32 isplt, j, k, m;
-
-    m = n;
-    while (m > 512) {
-        m >>= 2;
-        cftmdl1(m, &a[n - m]);
-    }
-    cftleaf(m, 1, &a[n - m]);
-    k = 0;
-    for (j = n - m; j > 0; j -= m) {
-        k++;
-        isplt = cfttree(m, j, k, a);
-        cftleaf(m, isplt, &a[j - m]);
-    }
-}
-
-
-picoos_int32 cfttree(picoos_int32 n, picoos_int32 j, picoos_int32 k, PICOFFTSG_FFTTYPE *a)
-{
-    picoos_int32 i, isplt, m;
-
-    if ((k & 3) != 0) {
-        isplt = k & 1;
-        if (isplt != 0) {
-            cftmdl1(n, &a[j - n]);
-        } else {
-            cftmdl2(n, &a[j - n]);
-        }
-    } else {
-        m = n;
-        for (i = k; (i & 3) == 0; i >>= 2) {
-            m <<= 2;
-        }
-        isplt = i & 1;
-        if (isplt != 0) {
-            while (m > 128) {
-                cftmdl1(m, &a[j - m]);
-                m >>= 2;
-            }
-        } else {
-            while (m > 128) {
-                cftmdl2(m, &a[j - m]);
-                m >>= 2;
-            }
-        }
-    }
-    return isplt;
-}
-
-
-void cftleaf(picoos_int32 n, picoos_int32 isplt, PICOFFTSG_FFTTYPE *a)
-{
-
-    if (n == 512) {
-        cftmdl1(128, a);
-        cftf161(a);
-        cftf162(&a[32]);
-        cftf161(&a[64]);
-        cftf161(&a[96]);
-        cftmdl2(128, &a[128]);
-        cftf161(&a[128]);
-        cftf162(&a[160]);
-        cftf161(&a[192]);
-        cftf162(&a[224]);
-        cftmdl1(128, &a[256]);
-        cftf161(&a[256]);
-        cftf162(&a[288]);
-        cftf161(&a[320]);
-        cftf161(&a[352]);
-        if (isplt != 0) {
-            cftmdl1(128, &a[384]);
-            cftf161(&a[480]);
-        } else {
-            cftmdl2(128, &a[384]);
-            cftf162(&a[480]);
-        }
-        cftf161(&a[384]);
-        cftf162(&a[416]);
-        cftf161(&a[448]);
-    } else {
-        cftmdl1(64, a);
-        cftf081(a);
-        cftf082(&a[16]);
-        cftf081(&a[32]);
-        cftf081(&a[48]);
-        cftmdl2(64, &a[64]);
-        cftf081(&a[64]);
-        cftf082(&a[80]);
-        cftf081(&a[96]);
-        cftf082(&a[112]);
-        cftmdl1(64, &a[128]);
-        cftf081(&a[128]);
-        cftf082(&a[144]);
-        cftf081(&a[160]);
-        cftf081(&a[176]);
-        if (isplt != 0) {
-            cftmdl1(64, &a[192]);
-            cftf081(&a[240]);
-        } else {
-            cftmdl2(64, &a[192]);
-            cftf082(&a[240]);
-        }
-        cftf081(&a[192]);
-        cftf082(&a[208]);
-        cftf081(&a[224]);
-    }
+    x0r = x1r + x3i;
+    x0i = x1i + x3r;
+    a[j2 + 2] = Mult_W_W(wk1i, x0r) - Mult_W_W(wk1r, x0i);
+    a[j2 + 3] = Mult_W_W(wk1i, x0i) + Mult_W_W(wk1r, x0r);
+    x0r = x1r - x3i;
+    x0i = x1i - x3r;
+    a[j3 + 2] = Mult_W_W(wk3i, x0r) + Mult_W_W(wk3r, x0i);
+    a[j3 + 3] = Mult_W_W(wk3i, x0i) - Mult_W_W(wk3r, x0r);
 }
 
+/* leaves of the transform of size 256 (with isplt == 1 in Ooura's code) */
+void cftleaf(PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w1, const PICOFFTSG_FFTTYPE *w2)
+{
+    cftmdl1(64, a, w1);
+    cftf081(a);
+    cftf082(&a[16]);
+    cftf081(&a[32]);
+    cftf081(&a[48]);
+    cftmdl2(64, &a[64], w2);
+    cftf081(&a[64]);
+    cftf082(&a[80]);
+    cftf081(&a[96]);
+    cftf082(&a[112]);
+    cftmdl1(64, &a[128], w1);
+    cftf081(&a[128]);
+    cftf082(&a[144]);
+    cftf081(&a[160]);
+    cftf081(&a[176]);
+    cftmdl1(64, &a[192], w1);
+    cftf081(&a[240]);
+    cftf081(&a[192]);
+    cftf082(&a[208]);
+    cftf081(&a[224]);
+}
 
-void cftmdl1(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
+
+void cftmdl1(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w)
 {
-    picoos_int32 i, i0, j, j0, j1, j2, j3, m, mh;
-    PICOFFTSG_FFTTYPE wk1r, wk1i, wk3r, wk3i,
-        wd1r, wd1i, wd3r, wd3i, ss1, ss3;
+    picoos_int32 j, j0, j1, j2, j3, m, mh;
+    PICOFFTSG_FFTTYPE wk1r, wk1i, wk3r, wk3i, wd1r;
     PICOFFTSG_FFTTYPE x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+#if defined(PICODSP_SIMD)
+    picodsp_vec_t w1, w3;
+#else
+    PICOFFTSG_FFTTYPE wd1i, wd3r, wd3i;
+#endif
 
     mh = n >> 3;
     m = 2 * mh;
@@ -2057,124 +1119,114 @@ void cftmdl1(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
     a[j2 + 1] = x1i + x3r;
     a[j3] = x1r + x3i;
     a[j3 + 1] = x1i - x3r;
-    wd1r = (PICOFFTSG_FFTTYPE)(PICODSP_WGT_SHIFT);
-    wd1i = 0;
-    wd3r = (PICOFFTSG_FFTTYPE)(PICODSP_WGT_SHIFT);
-    wd3i = 0;
-    wk1r  =  (PICOFFTSG_FFTTYPE) (0.980785250664  *PICODSP_WGT_SHIFT);
-    wk1i  =  (PICOFFTSG_FFTTYPE) (0.195090323687  *PICODSP_WGT_SHIFT);
-    ss1   =  (PICOFFTSG_FFTTYPE) (0.390180647373  *PICODSP_WGT_SHIFT);
-    wk3i  =  (PICOFFTSG_FFTTYPE) (-0.555570185184 *PICODSP_WGT_SHIFT);
-    wk3r  =  (PICOFFTSG_FFTTYPE) (0.831469595432  *PICODSP_WGT_SHIFT);
-    ss3   =  (PICOFFTSG_FFTTYPE) (-1.111140370369 *PICODSP_WGT_SHIFT);
-
-    i = 0;
-    for (;;) {
-        i0 = i + CDFT_LOOP_DIV_4;
-        if (i0 > mh - 4) {
-            i0 = mh - 4;
-        }
-        for (j = i + 2; j < i0; j += 4) {
-            wd1r -= Mult_W_W(ss1, wk1i);
-            wd1i += Mult_W_W(ss1, wk1r);
-            wd3r -= Mult_W_W(ss3, wk3i);
-            wd3i += Mult_W_W(ss3, wk3r);
-            j1 = j + m;
-            j2 = j1 + m;
-            j3 = j2 + m;
-            x0r = a[j] + a[j2];
-            x0i = a[j + 1] + a[j2 + 1];
-            x1r = a[j] - a[j2];
-            x1i = a[j + 1] - a[j2 + 1];
-            x2r = a[j1] + a[j3];
-            x2i = a[j1 + 1] + a[j3 + 1];
-            x3r = a[j1] - a[j3];
-            x3i = a[j1 + 1] - a[j3 + 1];
-            a[j] = x0r + x2r;
-            a[j + 1] = x0i + x2i;
-            a[j1] = x0r - x2r;
-            a[j1 + 1] = x0i - x2i;
-            x0r = x1r - x3i;
-            x0i = x1i + x3r;
-            a[j2] = Mult_W_W(wk1r, x0r) - Mult_W_W(wk1i, x0i);
-            a[j2 + 1] = Mult_W_W(wk1r, x0i) + Mult_W_W(wk1i, x0r);
-            x0r = x1r + x3i;
-            x0i = x1i - x3r;
-            a[j3] = Mult_W_W(wk3r, x0r) + Mult_W_W(wk3i, x0i);
-            a[j3 + 1] = Mult_W_W(wk3r, x0i) - Mult_W_W(wk3i, x0r);
-            x0r = a[j + 2] + a[j2 + 2];
-            x0i = a[j + 3] + a[j2 + 3];
-            x1r = a[j + 2] - a[j2 + 2];
-            x1i = a[j + 3] - a[j2 + 3];
-            x2r = a[j1 + 2] + a[j3 + 2];
-            x2i = a[j1 + 3] + a[j3 + 3];
-            x3r = a[j1 + 2] - a[j3 + 2];
-            x3i = a[j1 + 3] - a[j3 + 3];
-            a[j + 2] = x0r + x2r;
-            a[j + 3] = x0i + x2i;
-            a[j1 + 2] = x0r - x2r;
-            a[j1 + 3] = x0i - x2i;
-            x0r = x1r - x3i;
-            x0i = x1i + x3r;
-            a[j2 + 2] = Mult_W_W(wd1r, x0r) - Mult_W_W(wd1i, x0i);
-            a[j2 + 3] = Mult_W_W(wd1r, x0i) + Mult_W_W(wd1i, x0r);
-            x0r = x1r + x3i;
-            x0i = x1i - x3r;
-            a[j3 + 2] = Mult_W_W(wd3r, x0r) + Mult_W_W(wd3i, x0i);
-            a[j3 + 3] = Mult_W_W(wd3r, x0i) - Mult_W_W(wd3i, x0r);
-            j0 = m - j;
-            j1 = j0 + m;
-            j2 = j1 + m;
-            j3 = j2 + m;
-            x0r = a[j0] + a[j2];
-            x0i = a[j0 + 1] + a[j2 + 1];
-            x1r = a[j0] - a[j2];
-            x1i = a[j0 + 1] - a[j2 + 1];
-            x2r = a[j1] + a[j3];
-            x2i = a[j1 + 1] + a[j3 + 1];
-            x3r = a[j1] - a[j3];
-            x3i = a[j1 + 1] - a[j3 + 1];
-            a[j0] = x0r + x2r;
-            a[j0 + 1] = x0i + x2i;
-            a[j1] = x0r - x2r;
-            a[j1 + 1] = x0i - x2i;
-            x0r = x1r - x3i;
-            x0i = x1i + x3r;
-            a[j2] = Mult_W_W(wk1i, x0r) - Mult_W_W(wk1r, x0i);
-            a[j2 + 1] = Mult_W_W(wk1i, x0i) + Mult_W_W(wk1r, x0r);
-            x0r = x1r + x3i;
-            x0i = x1i - x3r;
-            a[j3] = Mult_W_W(wk3i, x0r) + Mult_W_W(wk3r, x0i);
-            a[j3 + 1] = Mult_W_W(wk3i, x0i) - Mult_W_W(wk3r, x0r);
-            x0r = a[j0 - 2] + a[j2 - 2];
-            x0i = a[j0 - 1] + a[j2 - 1];
-            x1r = a[j0 - 2] - a[j2 - 2];
-            x1i = a[j0 - 1] - a[j2 - 1];
-            x2r = a[j1 - 2] + a[j3 - 2];
-            x2i = a[j1 - 1] + a[j3 - 1];
-            x3r = a[j1 - 2] - a[j3 - 2];
-            x3i = a[j1 - 1] - a[j3 - 1];
-            a[j0 - 2] = x0r + x2r;
-            a[j0 - 1] = x0i + x2i;
-            a[j1 - 2] = x0r - x2r;
-            a[j1 - 1] = x0i - x2i;
-            x0r = x1r - x3i;
-            x0i = x1i + x3r;
-            a[j2 - 2] = Mult_W_W(wd1i, x0r) - Mult_W_W(wd1r, x0i);
-            a[j2 - 1] = Mult_W_W(wd1i, x0i) + Mult_W_W(wd1r, x0r);
-            x0r = x1r + x3i;
-            x0i = x1i - x3r;
-            a[j3 - 2] = Mult_W_W(wd3i, x0r) + Mult_W_W(wd3r, x0i);
-            a[j3 - 1] = Mult_W_W(wd3i, x0i) - Mult_W_W(wd3r, x0r);
-            wk1r -= Mult_W_W(ss1, wd1i);
-            wk1i += Mult_W_W(ss1, wd1r);
-            wk3r -= Mult_W_W(ss3, wd3i);
-            wk3i += Mult_W_W(ss3, wd3r);
-        }
-        if (i0 == mh - 4) {
-            break;
-        }
+    for (j = 2; j < mh - 4; j += 4, w += 8) {
+#if defined(PICODSP_SIMD)
+        w1 = picofftsg_vloadw(w);
+        w3 = picofftsg_vloadw(w + 4);
+        cftvmdl1(m, 1, &a[j], w1, w3);
+        cftvmdl1(m, 1, &a[m - j - 2], picofftsg_vmirror(w1), picofftsg_vmirror(w3));
+#else
+        wk1r = w[0];
+        wk1i = w[1];
+        wd1r = w[2];
+        wd1i = w[3];
+        wk3r = w[4];
+        wk3i = w[5];
+        wd3r = w[6];
+        wd3i = w[7];
+        j1 = j + m;
+        j2 = j1 + m;
+        j3 = j2 + m;
+        x0r = a[j] + a[j2];
+        x0i = a[j + 1] + a[j2 + 1];
+        x1r = a[j] - a[j2];
+        x1i = a[j + 1] - a[j2 + 1];
+        x2r = a[j1] + a[j3];
+        x2i = a[j1 + 1] + a[j3 + 1];
+        x3r = a[j1] - a[j3];
+        x3i = a[j1 + 1] - a[j3 + 1];
+        a[j] = x0r + x2r;
+        a[j + 1] = x0i + x2i;
+        a[j1] = x0r - x2r;
+        a[j1 + 1] = x0i - x2i;
+        x0r = x1r - x3i;
+        x0i = x1i + x3r;
+        a[j2] = Mult_W_W(wk1r, x0r) - Mult_W_W(wk1i, x0i);
+        a[j2 + 1] = Mult_W_W(wk1r, x0i) + Mult_W_W(wk1i, x0r);
+        x0r = x1r + x3i;
+        x0i = x1i - x3r;
+        a[j3] = Mult_W_W(wk3r, x0r) + Mult_W_W(wk3i, x0i);
+        a[j3 + 1] = Mult_W_W(wk3r, x0i) - Mult_W_W(wk3i, x0r);
+        x0r = a[j + 2] + a[j2 + 2];
+        x0i = a[j + 3] + a[j2 + 3];
+        x1r = a[j + 2] - a[j2 + 2];
+        x1i = a[j + 3] - a[j2 + 3];
+        x2r = a[j1 + 2] + a[j3 + 2];
+        x2i = a[j1 + 3] + a[j3 + 3];
+        x3r = a[j1 + 2] - a[j3 + 2];
+        x3i = a[j1 + 3] - a[j3 + 3];
+        a[j + 2] = x0r + x2r;
+        a[j + 3] = x0i + x2i;
+        a[j1 + 2] = x0r - x2r;
+        a[j1 + 3] = x0i - x2i;
+        x0r = x1r - x3i;
+        x0i = x1i + x3r;
+        a[j2 + 2] = Mult_W_W(wd1r, x0r) - Mult_W_W(wd1i, x0i);
+        a[j2 + 3] = Mult_W_W(wd1r, x0i) + Mult_W_W(wd1i, x0r);
+        x0r = x1r + x3i;
+        x0i = x1i - x3r;
+        a[j3 + 2] = Mult_W_W(wd3r, x0r) + Mult_W_W(wd3i, x0i);
+        a[j3 + 3] = Mult_W_W(wd3r, x0i) - Mult_W_W(wd3i, x0r);
+        j0 = m - j;
+        j1 = j0 + m;
+        j2 = j1 + m;
+        j3 = j2 + m;
+        x0r = a[j0] + a[j2];
+        x0i = a[j0 + 1] + a[j2 + 1];
+        x1r = a[j0] - a[j2];
+        x1i = a[j0 + 1] - a[j2 + 1];
+        x2r = a[j1] + a[j3];
+        x2i = a[j1 + 1] + a[j3 + 1];
+        x3r = a[j1] - a[j3];
+        x3i = a[j1 + 1] - a[j3 + 1];
+        a[j0] = x0r + x2r;
+        a[j0 + 1] = x0i + x2i;
+        a[j1] = x0r - x2r;
+        a[j1 + 1] = x0i - x2i;
+        x0r = x1r - x3i;
+        x0i = x1i + x3r;
+        a[j2] = Mult_W_W(wk1i, x0r) - Mult_W_W(wk1r, x0i);
+        a[j2 + 1] = Mult_W_W(wk1i, x0i) + Mult_W_W(wk1r, x0r);
+        x0r = x1r + x3i;
+        x0i = x1i - x3r;
+        a[j3] = Mult_W_W(wk3i, x0r) + Mult_W_W(wk3r, x0i);
+        a[j3 + 1] = Mult_W_W(wk3i, x0i) - Mult_W_W(wk3r, x0r);
+        x0r = a[j0 - 2] + a[j2 - 2];
+        x0i = a[j0 - 1] + a[j2 - 1];
+        x1r = a[j0 - 2] - a[j2 - 2];
+        x1i = a[j0 - 1] - a[j2 - 1];
+        x2r = a[j1 - 2] + a[j3 - 2];
+        x2i = a[j1 - 1] + a[j3 - 1];
+        x3r = a[j1 - 2] - a[j3 - 2];
+        x3i = a[j1 - 1] - a[j3 - 1];
+        a[j0 - 2] = x0r + x2r;
+        a[j0 - 1] = x0i + x2i;
+        a[j1 - 2] = x0r - x2r;
+        a[j1 - 1] = x0i - x2i;
+        x0r = x1r - x3i;
+        x0i = x1i + x3r;
+        a[j2 - 2] = Mult_W_W(wd1i, x0r) - Mult_W_W(wd1r, x0i);
+        a[j2 - 1] = Mult_W_W(wd1i, x0i) + Mult_W_W(wd1r, x0r);
+        x0r = x1r + x3i;
+        x0i = x1i - x3r;
+        a[j3 - 2] = Mult_W_W(wd3i, x0r) + Mult_W_W(wd3r, x0i);
+        a[j3 - 1] = Mult_W_W(wd3i, x0i) - Mult_W_W(wd3r, x0r);
+#endif
     }
+    wk1r = w[0];
+    wk1i = w[1];
+    wk3r = w[2];
+    wk3i = w[3];
     wd1r = WR5000;
     j0 = mh;
     j1 = j0 + m;
@@ -2243,13 +1295,17 @@ void cftmdl1(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
 }
 
 
-void cftmdl2(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
+void cftmdl2(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w)
 {
-    picoos_int32 i, i0, j, j0, j1, j2, j3, m, mh;
+    picoos_int32 j, j0, j1, j2, j3, m, mh;
     PICOFFTSG_FFTTYPE wn4r, wk1r, wk1i, wk3r, wk3i,
-        wl1r, wl1i, wl3r, wl3i, wd1r, wd1i, wd3r, wd3i,
-        we1r, we1i, we3r, we3i, ss1, ss3;
+        wl1r, wl1i, wd1r, wd1i, wd3r, wd3i;
     PICOFFTSG_FFTTYPE x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i, y0r, y0i, y2r, y2i;
+#if defined(PICODSP_SIMD)
+    picodsp_vec_t w1a, w1b, w3a, w3b;
+#else
+    PICOFFTSG_FFTTYPE wl3r, wl3i, we1r, we1i, we3r, we3i;
+#endif
 
     mh = n >> 3;
     m = 2 * mh;
@@ -2277,157 +1333,145 @@ void cftmdl2(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
     a[j2 + 1] = x1i + y0r;
     a[j3] = x1r + y0i;
     a[j3 + 1] = x1i - y0r;
-    wl1r = PICODSP_WGT_SHIFT;
-    wl1i = 0;
-    wl3r = PICODSP_WGT_SHIFT;
-    wl3i = 0;
-    we1r = wn4r;
-    we1i = wn4r;
-    we3r = -wn4r;
-    we3i = -wn4r;
-
-    wk1r  =  (PICOFFTSG_FFTTYPE)(0.995184719563  *PICODSP_WGT_SHIFT);
-    wk1i  =  (PICOFFTSG_FFTTYPE)(0.098017141223  *PICODSP_WGT_SHIFT);
-    wd1r  =  (PICOFFTSG_FFTTYPE)(0.634393274784  *PICODSP_WGT_SHIFT);
-    wd1i  =  (PICOFFTSG_FFTTYPE)(0.773010432720  *PICODSP_WGT_SHIFT);
-    ss1   =  (PICOFFTSG_FFTTYPE)(0.196034282446  *PICODSP_WGT_SHIFT);
-    wk3i  =  (PICOFFTSG_FFTTYPE)(-0.290284663439 *PICODSP_WGT_SHIFT);
-    wk3r  =  (PICOFFTSG_FFTTYPE)(0.956940352917  *PICODSP_WGT_SHIFT);
-    ss3   =  (PICOFFTSG_FFTTYPE)(-0.580569326878 *PICODSP_WGT_SHIFT);
-    wd3r  =  (PICOFFTSG_FFTTYPE)(-0.881921231747 *PICODSP_WGT_SHIFT);
-    wd3i  =  (PICOFFTSG_FFTTYPE)(-0.471396744251 *PICODSP_WGT_SHIFT);
-
-    i = 0;
-    for (;;) {
-        i0 = i + 4 * CDFT_LOOP_DIV;
-        if (i0 > mh - 4) {
-            i0 = mh - 4;
-        }
-        for (j = i + 2; j < i0; j += 4) {
-            wl1r -= Mult_W_W(ss1, wk1i);
-            wl1i += Mult_W_W(ss1, wk1r);
-            wl3r -= Mult_W_W(ss3, wk3i);
-            wl3i += Mult_W_W(ss3, wk3r);
-            we1r -= Mult_W_W(ss1, wd1i);
-            we1i += Mult_W_W(ss1, wd1r);
-            we3r -= Mult_W_W(ss3, wd3i);
-            we3i += Mult_W_W(ss3, wd3r);
-            j1 = j + m;
-            j2 = j1 + m;
-            j3 = j2 + m;
-            x0r = a[j] - a[j2 + 1];
-            x0i = a[j + 1] + a[j2];
-            x1r = a[j] + a[j2 + 1];
-            x1i = a[j + 1] - a[j2];
-            x2r = a[j1] - a[j3 + 1];
-            x2i = a[j1 + 1] + a[j3];
-            x3r = a[j1] + a[j3 + 1];
-            x3i = a[j1 + 1] - a[j3];
-            y0r = Mult_W_W(wk1r, x0r) - Mult_W_W(wk1i, x0i);
-            y0i = Mult_W_W(wk1r, x0i) + Mult_W_W(wk1i, x0r);
-            y2r = Mult_W_W(wd1r, x2r) - Mult_W_W(wd1i, x2i);
-            y2i = Mult_W_W(wd1r, x2i) + Mult_W_W(wd1i, x2r);
-            a[j] = y0r + y2r;
-            a[j + 1] = y0i + y2i;
-            a[j1] = y0r - y2r;
-            a[j1 + 1] = y0i - y2i;
-            y0r = Mult_W_W(wk3r, x1r) + Mult_W_W(wk3i, x1i);
-            y0i = Mult_W_W(wk3r, x1i) - Mult_W_W(wk3i, x1r);
-            y2r = Mult_W_W(wd3r, x3r) + Mult_W_W(wd3i, x3i);
-            y2i = Mult_W_W(wd3r, x3i) - Mult_W_W(wd3i, x3r);
-            a[j2] = y0r + y2r;
-            a[j2 + 1] = y0i + y2i;
-            a[j3] = y0r - y2r;
-            a[j3 + 1] = y0i - y2i;
-            x0r = a[j + 2] - a[j2 + 3];
-            x0i = a[j + 3] + a[j2 + 2];
-            x1r = a[j + 2] + a[j2 + 3];
-            x1i = a[j + 3] - a[j2 + 2];
-            x2r = a[j1 + 2] - a[j3 + 3];
-            x2i = a[j1 + 3] + a[j3 + 2];
-            x3r = a[j1 + 2] + a[j3 + 3];
-            x3i = a[j1 + 3] - a[j3 + 2];
-            y0r = Mult_W_W(wl1r, x0r) - Mult_W_W(wl1i, x0i);
-            y0i = Mult_W_W(wl1r, x0i) + Mult_W_W(wl1i, x0r);
-            y2r = Mult_W_W(we1r, x2r) - Mult_W_W(we1i, x2i);
-            y2i = Mult_W_W(we1r, x2i) + Mult_W_W(we1i, x2r);
-            a[j + 2] = y0r + y2r;
-            a[j + 3] = y0i + y2i;
-            a[j1 + 2] = y0r - y2r;
-            a[j1 + 3] = y0i - y2i;
-            y0r = Mult_W_W(wl3r, x1r) + Mult_W_W(wl3i, x1i);
-            y0i = Mult_W_W(wl3r, x1i) - Mult_W_W(wl3i, x1r);
-            y2r = Mult_W_W(we3r, x3r) + Mult_W_W(we3i, x3i);
-            y2i = Mult_W_W(we3r, x3i) - Mult_W_W(we3i, x3r);
-            a[j2 + 2] = y0r + y2r;
-            a[j2 + 3] = y0i + y2i;
-            a[j3 + 2] = y0r - y2r;
-            a[j3 + 3] = y0i - y2i;
-            j0 = m - j;
-            j1 = j0 + m;
-            j2 = j1 + m;
-            j3 = j2 + m;
-            x0r = a[j0] - a[j2 + 1];
-            x0i = a[j0 + 1] + a[j2];
-            x1r = a[j0] + a[j2 + 1];
-            x1i = a[j0 + 1] - a[j2];
-            x2r = a[j1] - a[j3 + 1];
-            x2i = a[j1 + 1] + a[j3];
-            x3r = a[j1] + a[j3 + 1];
-            x3i = a[j1 + 1] - a[j3];
-            y0r = Mult_W_W(wd1i, x0r) - Mult_W_W(wd1r, x0i);
-            y0i = Mult_W_W(wd1i, x0i) + Mult_W_W(wd1r, x0r);
-            y2r = Mult_W_W(wk1i, x2r) - Mult_W_W(wk1r, x2i);
-            y2i = Mult_W_W(wk1i, x2i) + Mult_W_W(wk1r, x2r);
-            a[j0] = y0r + y2r;
-            a[j0 + 1] = y0i + y2i;
-            a[j1] = y0r - y2r;
-            a[j1 + 1] = y0i - y2i;
-            y0r = Mult_W_W(wd3i, x1r) + Mult_W_W(wd3r, x1i);
-            y0i = Mult_W_W(wd3i, x1i) - Mult_W_W(wd3r, x1r);
-            y2r = Mult_W_W(wk3i, x3r) + Mult_W_W(wk3r, x3i);
-            y2i = Mult_W_W(wk3i, x3i) - Mult_W_W(wk3r, x3r);
-            a[j2] = y0r + y2r;
-            a[j2 + 1] = y0i + y2i;
-            a[j3] = y0r - y2r;
-            a[j3 + 1] = y0i - y2i;
-            x0r = a[j0 - 2] - a[j2 - 1];
-            x0i = a[j0 - 1] + a[j2 - 2];
-            x1r = a[j0 - 2] + a[j2 - 1];
-            x1i = a[j0 - 1] - a[j2 - 2];
-            x2r = a[j1 - 2] - a[j3 - 1];
-            x2i = a[j1 - 1] + a[j3 - 2];
-            x3r = a[j1 - 2] + a[j3 - 1];
-            x3i = a[j1 - 1] - a[j3 - 2];
-            y0r = Mult_W_W(we1i, x0r) - Mult_W_W(we1r, x0i);
-            y0i = Mult_W_W(we1i, x0i) + Mult_W_W(we1r, x0r);
-            y2r = Mult_W_W(wl1i, x2r) - Mult_W_W(wl1r, x2i);
-            y2i = Mult_W_W(wl1i, x2i) + Mult_W_W(wl1r, x2r);
-            a[j0 - 2] = y0r + y2r;
-            a[j0 - 1] = y0i + y2i;
-            a[j1 - 2] = y0r - y2r;
-            a[j1 - 1] = y0i - y2i;
-            y0r = Mult_W_W(we3i, x1r) + Mult_W_W(we3r, x1i);
-            y0i = Mult_W_W(we3i, x1i) - Mult_W_W(we3r, x1r);
-            y2r = Mult_W_W(wl3i, x3r) + Mult_W_W(wl3r, x3i);
-            y2i = Mult_W_W(wl3i, x3i) - Mult_W_W(wl3r, x3r);
-            a[j2 - 2] = y0r + y2r;
-            a[j2 - 1] = y0i + y2i;
-            a[j3 - 2] = y0r - y2r;
-            a[j3 - 1] = y0i - y2i;
-            wk1r -= Mult_W_W(ss1, wl1i);
-            wk1i += Mult_W_W(ss1, wl1r);
-            wk3r -= Mult_W_W(ss3, wl3i);
-            wk3i += Mult_W_W(ss3, wl3r);
-            wd1r -= Mult_W_W(ss1, we1i);
-            wd1i += Mult_W_W(ss1, we1r);
-            wd3r -= Mult_W_W(ss3, we3i);
-            wd3i += Mult_W_W(ss3, we3r);
-        }
-        if (i0 == mh - 4) {
-            break;
-        }
+    for (j = 2; j < mh - 4; j += 4, w += 16) {
+#if defined(PICODSP_SIMD)
+        w1a = picofftsg_vloadw(w);
+        w1b = picofftsg_vloadw(w + 4);
+        w3a = picofftsg_vloadw(w + 8);
+        w3b = picofftsg_vloadw(w + 12);
+        cftvmdl2(m, &a[j], w1a, w1b, w3a, w3b);
+        cftvmdl2(m, &a[m - j - 2], picofftsg_vmirror(w1b), picofftsg_vmirror(w1a),
+                picofftsg_vmirror(w3b), picofftsg_vmirror(w3a));
+#else
+        wk1r = w[0];
+        wk1i = w[1];
+        wl1r = w[2];
+        wl1i = w[3];
+        wd1r = w[4];
+        wd1i = w[5];
+        we1r = w[6];
+        we1i = w[7];
+        wk3r = w[8];
+        wk3i = w[9];
+        wl3r = w[10];
+        wl3i = w[11];
+        wd3r = w[12];
+        wd3i = w[13];
+        we3r = w[14];
+        we3i = w[15];
+        j1 = j + m;
+        j2 = j1 + m;
+        j3 = j2 + m;
+        x0r = a[j] - a[j2 + 1];
+        x0i = a[j + 1] + a[j2];
+        x1r = a[j] + a[j2 + 1];
+        x1i = a[j + 1] - a[j2];
+        x2r = a[j1] - a[j3 + 1];
+        x2i = a[j1 + 1] + a[j3];
+        x3r = a[j1] + a[j3 + 1];
+        x3i = a[j1 + 1] - a[j3];
+        y0r = Mult_W_W(wk1r, x0r) - Mult_W_W(wk1i, x0i);
+        y0i = Mult_W_W(wk1r, x0i) + Mult_W_W(wk1i, x0r);
+        y2r = Mult_W_W(wd1r, x2r) - Mult_W_W(wd1i, x2i);
+        y2i = Mult_W_W(wd1r, x2i) + Mult_W_W(wd1i, x2r);
+        a[j] = y0r + y2r;
+        a[j + 1] = y0i + y2i;
+        a[j1] = y0r - y2r;
+        a[j1 + 1] = y0i - y2i;
+        y0r = Mult_W_W(wk3r, x1r) + Mult_W_W(wk3i, x1i);
+        y0i = Mult_W_W(wk3r, x1i) - Mult_W_W(wk3i, x1r);
+        y2r = Mult_W_W(wd3r, x3r) + Mult_W_W(wd3i, x3i);
+        y2i = Mult_W_W(wd3r, x3i) - Mult_W_W(wd3i, x3r);
+        a[j2] = y0r + y2r;
+        a[j2 + 1] = y0i + y2i;
+        a[j3] = y0r - y2r;
+        a[j3 + 1] = y0i - y2i;
+        x0r = a[j + 2] - a[j2 + 3];
+        x0i = a[j + 3] + a[j2 + 2];
+        x1r = a[j + 2] + a[j2 + 3];
+        x1i = a[j + 3] - a[j2 + 2];
+        x2r = a[j1 + 2] - a[j3 + 3];
+        x2i = a[j1 + 3] + a[j3 + 2];
+        x3r = a[j1 + 2] + a[j3 + 3];
+        x3i = a[j1 + 3] - a[j3 + 2];
+        y0r = Mult_W_W(wl1r, x0r) - Mult_W_W(wl1i, x0i);
+        y0i = Mult_W_W(wl1r, x0i) + Mult_W_W(wl1i, x0r);
+        y2r = Mult_W_W(we1r, x2r) - Mult_W_W(we1i, x2i);
+        y2i = Mult_W_W(we1r, x2i) + Mult_W_W(we1i, x2r);
+        a[j + 2] = y0r + y2r;
+        a[j + 3] = y0i + y2i;
+        a[j1 + 2] = y0r - y2r;
+        a[j1 + 3] = y0i - y2i;
+        y0r = Mult_W_W(wl3r, x1r) + Mult_W_W(wl3i, x1i);
+        y0i = Mult_W_W(wl3r, x1i) - Mult_W_W(wl3i, x1r);
+        y2r = Mult_W_W(we3r, x3r) + Mult_W_W(we3i, x3i);
+        y2i = Mult_W_W(we3r, x3i) - Mult_W_W(we3i, x3r);
+        a[j2 + 2] = y0r + y2r;
+        a[j2 + 3] = y0i + y2i;
+        a[j3 + 2] = y0r - y2r;
+        a[j3 + 3] = y0i - y2i;
+        j0 = m - j;
+        j1 = j0 + m;
+        j2 = j1 + m;
+        j3 = j2 + m;
+        x0r = a[j0] - a[j2 + 1];
+        x0i = a[j0 + 1] + a[j2];
+        x1r = a[j0] + a[j2 + 1];
+        x1i = a[j0 + 1] - a[j2];
+        x2r = a[j1] - a[j3 + 1];
+        x2i = a[j1 + 1] + a[j3];
+        x3r = a[j1] + a[j3 + 1];
+        x3i = a[j1 + 1] - a[j3];
+        y0r = Mult_W_W(wd1i, x0r) - Mult_W_W(wd1r, x0i);
+        y0i = Mult_W_W(wd1i, x0i) + Mult_W_W(wd1r, x0r);
+        y2r = Mult_W_W(wk1i, x2r) - Mult_W_W(wk1r, x2i);
+        y2i = Mult_W_W(wk1i, x2i) + Mult_W_W(wk1r, x2r);
+        a[j0] = y0r + y2r;
+        a[j0 + 1] = y0i + y2i;
+        a[j1] = y0r - y2r;
+        a[j1 + 1] = y0i - y2i;
+        y0r = Mult_W_W(wd3i, x1r) + Mult_W_W(wd3r, x1i);
+        y0i = Mult_W_W(wd3i, x1i) - Mult_W_W(wd3r, x1r);
+        y2r = Mult_W_W(wk3i, x3r) + Mult_W_W(wk3r, x3i);
+        y2i = Mult_W_W(wk3i, x3i) - Mult_W_W(wk3r, x3r);
+        a[j2] = y0r + y2r;
+        a[j2 + 1] = y0i + y2i;
+        a[j3] = y0r - y2r;
+        a[j3 + 1] = y0i - y2i;
+        x0r = a[j0 - 2] - a[j2 - 1];
+        x0i = a[j0 - 1] + a[j2 - 2];
+        x1r = a[j0 - 2] + a[j2 - 1];
+        x1i = a[j0 - 1] - a[j2 - 2];
+        x2r = a[j1 - 2] - a[j3 - 1];
+        x2i = a[j1 - 1] + a[j3 - 2];
+        x3r = a[j1 - 2] + a[j3 - 1];
+        x3i = a[j1 - 1] - a[j3 - 2];
+        y0r = Mult_W_W(we1i, x0r) - Mult_W_W(we1r, x0i);
+        y0i = Mult_W_W(we1i, x0i) + Mult_W_W(we1r, x0r);
+        y2r = Mult_W_W(wl1i, x2r) - Mult_W_W(wl1r, x2i);
+        y2i = Mult_W_W(wl1i, x2i) + Mult_W_W(wl1r, x2r);
+        a[j0 - 2] = y0r + y2r;
+        a[j0 - 1] = y0i + y2i;
+        a[j1 - 2] = y0r - y2r;
+        a[j1 - 1] = y0i - y2i;
+        y0r = Mult_W_W(we3i, x1r) + Mult_W_W(we3r, x1i);
+        y0i = Mult_W_W(we3i, x1i) - Mult_W_W(we3r, x1r);
+        y2r = Mult_W_W(wl3i, x3r) + Mult_W_W(wl3r, x3i);
+        y2i = Mult_W_W(wl3i, x3i) - Mult_W_W(wl3r, x3r);
+        a[j2 - 2] = y0r + y2r;
+        a[j2 - 1] = y0i + y2i;
+        a[j3 - 2] = y0r - y2r;
+        a[j3 - 1] = y0i - y2i;
+#endif
     }
+    wk1r = w[0];
+    wk1i = w[1];
+    wd1r = w[2];
+    wd1i = w[3];
+    wk3r = w[4];
+    wk3i = w[5];
+    wd3r = w[6];
+    wd3i = w[7];
     wl1r = WR2500;
     wl1i = WI2500;
     j0 = mh;
@@ -2870,6 +1914,40 @@ void cftf162(PICOFFTSG_FFTTYPE *a)
 
 void cftf081(PICOFFTSG_FFTTYPE *a)
 {
+#if defined(PICODSP_SIMD)
+    picodsp_vec_t negre, neghi, wn4r, x0, x1, x2, x3, y0, y1, y2, y3, y57;
+
+    negre = picofftsg_vnegre();
+    neghi = picodsp_vset(0, 0, -1, -1);
+    wn4r = picofftsg_vtwiddle(WR5000, WR5000, WR5000, WR5000);
+    x0 = picodsp_vload(a);
+    x1 = picodsp_vload(a + 4);
+    x2 = picodsp_vload(a + 8);
+    x3 = picodsp_vload(a + 12);
+    y0 = picodsp_vadd(x0, x2);
+    y1 = picodsp_vsub(x0, x2);
+    y2 = picodsp_vadd(x1, x3);
+    y3 = picodsp_vsub(x1, x3);
+    x0 = picodsp_vadd(y0, y2);     /* (y0, y4) */
+    x2 = picodsp_vsub(y0, y2);     /* (y2, y6) */
+    y3 = picodsp_vneg(picodsp_vswap(y3), negre);
+    x1 = picodsp_vadd(y1, y3);     /* (y1, x0) */
+    x3 = picodsp_vsub(y1, y3);     /* (y3, x2) */
+    /* (y5, y7) */
+    y57 = picodsp_vhi(x1, x3);
+    y57 = picodsp_vadd(y57, picodsp_vneg(picodsp_vswap(y57), negre));
+    y57 = picodsp_vmul(wn4r, picodsp_vshrsym(y57, 14));
+    y0 = picodsp_vhi(x0, x0);
+    picodsp_vstore(a, picodsp_vadd(picodsp_vlo(x0, x0), picodsp_vneg(y0, neghi)));
+    y2 = picodsp_vhi(x2, x2);
+    y2 = picodsp_vneg(picodsp_vswap(y2), negre);
+    picodsp_vstore(a + 4, picodsp_vadd(picodsp_vlo(x2, x2), picodsp_vneg(y2, neghi)));
+    y1 = picodsp_vlo(y57, y57);
+    picodsp_vstore(a + 8, picodsp_vadd(picodsp_vlo(x1, x1), picodsp_vneg(y1, neghi)));
+    y3 = picodsp_vhi(y57, y57);
+    y3 = picodsp_vneg(picodsp_vswap(y3), negre);
+    picodsp_vstore(a + 12, picodsp_vadd(picodsp_vlo(x3, x3), picodsp_vneg(y3, neghi)));
+#else
     PICOFFTSG_FFTTYPE wn4r, x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i,
         y0r, y0i, y1r, y1i, y2r, y2i, y3r, y3i,
         y4r, y4i, y5r, y5i, y6r, y6i, y7r, y7i;
@@ -2927,11 +2005,55 @@ void cftf081(PICOFFTSG_FFTTYPE *a)
     a[5] = y2i + y6r;
     a[6] = y2r + y6i;
     a[7] = y2i - y6r;
+#endif
 }
 
 
 void cftf082(PICOFFTSG_FFTTYPE *a)
 {
+#if defined(PICODSP_SIMD)
+    picodsp_vec_t negre, neghi, wn4r, wk1, x0, x1, x2, x3, y0, y1, y2, y3;
+
+    negre = picofftsg_vnegre();
+    neghi = picodsp_vset(0, 0, -1, -1);
+    wn4r = picofftsg_vtwiddle(WR5000, WR5000, WR5000, WR5000);
+    wk1 = picofftsg_vtwiddle(WR2500, WI2500, WR2500, WI2500);
+    x0 = picodsp_vload(a);
+    x1 = picodsp_vload(a + 4);
+    x2 = picodsp_vneg(picodsp_vswap(picodsp_vload(a + 8)), negre);
+    x3 = picodsp_vneg(picodsp_vswap(picodsp_vload(a + 12)), negre);
+    y0 = picodsp_vadd(x0, x2);
+    y1 = picodsp_vsub(x0, x2);
+    y2 = picodsp_vadd(x1, x3);
+    y3 = picodsp_vsub(x1, x3);
+    /* (y2, y3) */
+    x2 = picodsp_vlo(y2, y3);
+    x2 = picodsp_vadd(x2, picodsp_vneg(picodsp_vswap(x2), negre));
+    x2 = picodsp_vmul(wn4r, picodsp_vshrsym(x2, 14));
+    /* (y4, y7) and (y5, y6) */
+    x1 = picofftsg_vcmul(wk1, picodsp_vhi(y0, y3), negre);
+    x3 = picofftsg_vcmul(picodsp_vswap(wk1), picodsp_vhi(y1, y2), negre);
+    /* (y0, y1) and (y2, i * y3) */
+    x0 = picodsp_vlo(y0, y1);
+    y3 = picodsp_vneg(picodsp_vswap(x2), negre);
+    x2 = picodsp_vlo(x2, picodsp_vhi(y3, y3));
+    y0 = picodsp_vadd(x0, x2);
+    y1 = picodsp_vsub(x0, x2);
+    /* (y4 + y6, y5 - y7) and (y4 - y6, y5 + y7) */
+    x0 = picodsp_vlo(x1, x3);
+    x2 = picodsp_vneg(picodsp_vhi(x3, x1), neghi);
+    y2 = picodsp_vadd(x0, x2);
+    y3 = picodsp_vsub(x0, x2);
+    x0 = picodsp_vadd(y0, y2);
+    x1 = picodsp_vsub(y0, y2);
+    picodsp_vstore(a, picodsp_vlo(x0, x1));
+    picodsp_vstore(a + 8, picodsp_vhi(x0, x1));
+    y3 = picodsp_vneg(picodsp_vswap(y3), negre);
+    x0 = picodsp_vadd(y1, y3);
+    x1 = picodsp_vsub(y1, y3);
+    picodsp_vstore(a + 4, picodsp_vlo(x0, x1));
+    picodsp_vstore(a + 12, picodsp_vhi(x0, x1));
+#else
     PICOFFTSG_FFTTYPE wn4r, wk1r, wk1i, x0r, x0i, x1r, x1i,
         y0r, y0i, y1r, y1i, y2r, y2i, y3r, y3i,
         y4r, y4i, y5r, y5i, y6r, y6i, y7r, y7i;
@@ -2999,6 +2121,7 @@ void cftf082(PICOFFTSG_FFTTYPE *a)
     a[13] = x0i + x1r;
     a[14] = x0r + x1i;
     a[15] = x0i - x1r;
+#endif
 }
 
 
@@ -3025,29 +2148,6 @@ void cftf040(PICOFFTSG_FFTTYPE *a)
 }
 
 
-void cftb040(PICOFFTSG_FFTTYPE *a)
-{
-    PICOFFTSG_FFTTYPE x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
-
-    x0r = a[0] + a[4];
-    x0i = a[1] + a[5];
-    x1r = a[0] - a[4];
-    x1i = a[1] - a[5];
-    x2r = a[2] + a[6];
-    x2i = a[3] + a[7];
-    x3r = a[2] - a[6];
-    x3i = a[3] - a[7];
-    a[0] = x0r + x2r;
-    a[1] = x0i + x2i;
-    a[2] = x1r + x3i;
-    a[3] = x1i - x3r;
-    a[4] = x0r - x2r;
-    a[5] = x0i - x2i;
-    a[6] = x1r - x3i;
-    a[7] = x1i + x3r;
-}
-
-
 void cftx020(PICOFFTSG_FFTTYPE *a)
 {
     PICOFFTSG_FFTTYPE x0r, x0i;
@@ -3061,69 +2161,36 @@ void cftx020(PICOFFTSG_FFTTYPE *a)
 }
 
 
-void rftfsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
+void rftfsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w)
 {
-    picoos_int32 i, i0, j, k;
-    PICOFFTSG_FFTTYPE w1r, w1i, wkr, wki, wdr, wdi, ss, xr, xi, yr, yi;
-
-    wkr = 0;
-    wki = 0;
-
-    switch (n) {
-        case 8 :
-            wdi=(PICOFFTSG_FFTTYPE)(0.353553414345*PICODSP_WGT_SHIFT); wdr=(PICOFFTSG_FFTTYPE)(0.146446630359*PICODSP_WGT_SHIFT);
-            w1r=(PICOFFTSG_FFTTYPE)(0.707106709480*PICODSP_WGT_SHIFT); w1i=(PICOFFTSG_FFTTYPE)(0.707106828690*PICODSP_WGT_SHIFT);
-            ss =(PICOFFTSG_FFTTYPE)(1.414213657379*PICODSP_WGT_SHIFT); break;
-        case 16 :
-            wdi=(PICOFFTSG_FFTTYPE)(0.191341713071*PICODSP_WGT_SHIFT); wdr=(PICOFFTSG_FFTTYPE)(0.038060232997*PICODSP_WGT_SHIFT);
-            w1r=(PICOFFTSG_FFTTYPE)(0.923879504204*PICODSP_WGT_SHIFT); w1i=(PICOFFTSG_FFTTYPE)(0.382683426142*PICODSP_WGT_SHIFT);
-            ss =(PICOFFTSG_FFTTYPE)(0.765366852283*PICODSP_WGT_SHIFT); break;
-        case 32 :
-            wdi=(PICOFFTSG_FFTTYPE)(0.097545161843*PICODSP_WGT_SHIFT); wdr=(PICOFFTSG_FFTTYPE)(0.009607359767*PICODSP_WGT_SHIFT);
-            w1r=(PICOFFTSG_FFTTYPE)(0.980785250664*PICODSP_WGT_SHIFT); w1i=(PICOFFTSG_FFTTYPE)(0.195090323687*PICODSP_WGT_SHIFT);
-            ss =(PICOFFTSG_FFTTYPE)(0.390180647373*PICODSP_WGT_SHIFT); break;
-        case 64 :
-            wdi=(PICOFFTSG_FFTTYPE)(0.049008570611*PICODSP_WGT_SHIFT); wdr=(PICOFFTSG_FFTTYPE)(0.002407636726*PICODSP_WGT_SHIFT);
-            w1r=(PICOFFTSG_FFTTYPE)(0.995184719563*PICODSP_WGT_SHIFT); w1i=(PICOFFTSG_FFTTYPE)(0.098017141223*PICODSP_WGT_SHIFT);
-            ss =(PICOFFTSG_FFTTYPE)(0.196034282446*PICODSP_WGT_SHIFT); break;
-        default :
-            wdr = 0; wdi = 0; ss = 0;
-            break;
-    }
-
-    i = n >> 1;
-    for (;;) {
-        i0 = i - RDFT_LOOP_DIV_4;
-        if (i0 < 4) {
-            i0 = 4;
-        }
-        for (j = i - 4; j >= i0; j -= 4) {
-            k = n - j;
-            xr = a[j + 2] - a[k - 2];
-            xi = a[j + 3] + a[k - 1];
-            yr = Mult_W_W(wdr, xr) - Mult_W_W(wdi, xi);
-            yi = Mult_W_W(wdr, xi) + Mult_W_W(wdi, xr);
-            a[j + 2] -= yr;
-            a[j + 3] -= yi;
-            a[k - 2] += yr;
-            a[k - 1] -= yi;
-            wkr += Mult_W_W(ss, wdi);
-            wki += picofftsg_mult_w_w(ss, (PICOFFTSG_WGT_SHIFT2 - wdr));
-            xr = a[j] - a[k];
-            xi = a[j + 1] + a[k + 1];
-            yr = Mult_W_W(wkr, xr) - Mult_W_W(wki, xi);
-            yi = Mult_W_W(wkr, xi) + Mult_W_W(wki, xr);
-            a[j] -= yr;
-            a[j + 1] -= yi;
-            a[k] += yr;
-            a[k + 1] -= yi;
-            wdr += Mult_W_W(ss, wki);
-            wdi += picofftsg_mult_w_w(ss, (PICOFFTSG_WGT_SHIFT2 - wkr));
-        }
-        if (i0 == 4) {
-            break;
-        }
+    picoos_int32 j, k;
+    PICOFFTSG_FFTTYPE wkr, wki, wdr, wdi, xr, xi, yr, yi;
+
+    for (j = (n >> 1) - 4; j >= 4; j -= 4, w += 4) {
+        wdr = w[0];
+        wdi = w[1];
+        wkr = w[2];
+        wki = w[3];
+        k = n - j;
+        xr = a[j + 2] - a[k - 2];
+        xi = a[j + 3] + a[k - 1];
+        yr = Mult_W_W(wdr, xr) - Mult_W_W(wdi, xi);
+        yi = Mult_W_W(wdr, xi) + Mult_W_W(wdi, xr);
+        a[j + 2] -= yr;
+        a[j + 3] -= yi;
+        a[k - 2] += yr;
+        a[k - 1] -= yi;
+        xr = a[j] - a[k];
+        xi = a[j + 1] + a[k + 1];
+        yr = Mult_W_W(wkr, xr) - Mult_W_W(wki, xi);
+        yi = Mult_W_W(wkr, xi) + Mult_W_W(wki, xr);
+        a[j] -= yr;
+        a[j + 1] -= yi;
+        a[k] += yr;
+        a[k + 1] -= yi;
     }
+    wdr = w[0];
+    wdi = w[1];
 
     xr = a[2] - a[n - 2];
     xi = a[3] + a[n - 1];
@@ -3139,51 +2206,36 @@ void rftfsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
 }
 
 
-void rftbsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
+void rftbsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w)
 {
-    picoos_int32 i, i0, j, k;
-    PICOFFTSG_FFTTYPE w1r, w1i, wkr, wki, wdr, wdi, ss, xr, xi, yr, yi;
-    wkr = 0;
-    wki = 0;
-    wdi=(PICOFFTSG_FFTTYPE)(0.012270614505*PICODSP_WGT_SHIFT);
-    wdr=(PICOFFTSG_FFTTYPE)(0.000150590655*PICODSP_WGT_SHIFT);
-    w1r=(PICOFFTSG_FFTTYPE)(0.999698817730*PICODSP_WGT_SHIFT);
-    w1i=(PICOFFTSG_FFTTYPE)(0.024541229010*PICODSP_WGT_SHIFT);
-    ss=(PICOFFTSG_FFTTYPE)(0.049082458019*PICODSP_WGT_SHIFT);
-
-    i = n >> 1;
-    for (;;) {
-        i0 = i - RDFT_LOOP_DIV4;
-        if (i0 < 4) {
-            i0 = 4;
-        }
-        for (j = i - 4; j >= i0; j -= 4) {
-            k = n - j;
-            xr = a[j + 2] - a[k - 2];
-            xi = a[j + 3] + a[k - 1];
-            yr = Mult_W_W(wdr, xr) + Mult_W_W(wdi, xi);
-            yi = Mult_W_W(wdr, xi) - Mult_W_W(wdi, xr);
-            a[j + 2] -= yr;
-            a[j + 3] -= yi;
-            a[k - 2] += yr;
-            a[k - 1] -= yi;
-            wkr += Mult_W_W(ss, wdi);
-            wki += picofftsg_mult_w_w(ss, (PICOFFTSG_WGT_SHIFT2 - wdr));
-            xr = a[j] - a[k];
-            xi = a[j + 1] + a[k + 1];
-            yr = Mult_W_W(wkr, xr) + Mult_W_W(wki, xi);
-            yi = Mult_W_W(wkr, xi) - Mult_W_W(wki, xr);
-            a[j] -= yr;
-            a[j + 1] -= yi;
-            a[k] += yr;
-            a[k + 1] -= yi;
-            wdr += Mult_W_W(ss, wki);
-            wdi += picofftsg_mult_w_w(ss, (PICOFFTSG_WGT_SHIFT2 - wkr));
-        }
-        if (i0 == 4) {
-            break;
-        }
+    picoos_int32 j, k;
+    PICOFFTSG_FFTTYPE wkr, wki, wdr, wdi, xr, xi, yr, yi;
+
+    for (j = (n >> 1) - 4; j >= 4; j -= 4, w += 4) {
+        wdr = w[0];
+        wdi = w[1];
+        wkr = w[2];
+        wki = w[3];
+        k = n - j;
+        xr = a[j + 2] - a[k - 2];
+        xi = a[j + 3] + a[k - 1];
+        yr = Mult_W_W(wdr, xr) + Mult_W_W(wdi, xi);
+        yi = Mult_W_W(wdr, xi) - Mult_W_W(wdi, xr);
+        a[j + 2] -= yr;
+        a[j + 3] -= yi;
+        a[k - 2] += yr;
+        a[k - 1] -= yi;
+        xr = a[j] - a[k];
+        xi = a[j + 1] + a[k + 1];
+        yr = Mult_W_W(wkr, xr) + Mult_W_W(wki, xi);
+        yi = Mult_W_W(wkr, xi) - Mult_W_W(wki, xr);
+        a[j] -= yr;
+        a[j + 1] -= yi;
+        a[k] += yr;
+        a[k + 1] -= yi;
     }
+    wdr = w[0];
+    wdi = w[1];
     xr = a[2] - a[n - 2];
     xi = a[3] + a[n - 1];
     yr = Mult_W_W(wdr, xr) + Mult_W_W(wdi, xi);
@@ -3195,56 +2247,29 @@ void rftbsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
 }
 
 
-void dctsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
+void dctsub(picoos_int32 n, PICOFFTSG_FFTTYPE *a, const PICOFFTSG_FFTTYPE *w)
 {
-    picoos_int32 i, i0, j, k, m;
-    PICOFFTSG_FFTTYPE w1r, w1i, wkr, wki, wdr, wdi, ss, xr, xi, yr, yi;
-    wkr = (PICOFFTSG_FFTTYPE)(0.5*PICODSP_WGT_SHIFT);
-    wki = (PICOFFTSG_FFTTYPE)(0.5*PICODSP_WGT_SHIFT);
-
-    switch (n) {
-        case 8 :  wdi=(PICOFFTSG_FFTTYPE)(0.587937772274*PICODSP_WGT_SHIFT);
-            wdr=(PICOFFTSG_FFTTYPE)(0.392847478390*PICODSP_WGT_SHIFT); w1r=(PICOFFTSG_FFTTYPE)(0.980785250664*PICODSP_WGT_SHIFT);
-            w1i=(PICOFFTSG_FFTTYPE)(0.195090323687*PICODSP_WGT_SHIFT); ss =(PICOFFTSG_FFTTYPE)(0.390180647373*PICODSP_WGT_SHIFT); break;
-        case 16 : wdi=(PICOFFTSG_FFTTYPE)(0.546600937843*PICODSP_WGT_SHIFT);
-            wdr=(PICOFFTSG_FFTTYPE)(0.448583781719*PICODSP_WGT_SHIFT); w1r=(PICOFFTSG_FFTTYPE)(0.995184719563*PICODSP_WGT_SHIFT);
-            w1i=(PICOFFTSG_FFTTYPE)(0.098017141223*PICODSP_WGT_SHIFT); ss =(PICOFFTSG_FFTTYPE)(0.196034282446*PICODSP_WGT_SHIFT); break;
-        case 32 : wdi=(PICOFFTSG_FFTTYPE)(0.523931562901*PICODSP_WGT_SHIFT);
-            wdr=(PICOFFTSG_FFTTYPE)(0.474863886833*PICODSP_WGT_SHIFT); w1r=(PICOFFTSG_FFTTYPE)(0.998795449734*PICODSP_WGT_SHIFT);
-            w1i=(PICOFFTSG_FFTTYPE)(0.049067676067*PICODSP_WGT_SHIFT); ss =(PICOFFTSG_FFTTYPE)(0.098135352135*PICODSP_WGT_SHIFT); break;
-        case 64 : wdi=(PICOFFTSG_FFTTYPE)(0.512120008469*PICODSP_WGT_SHIFT);
-            wdr=(PICOFFTSG_FFTTYPE)(0.487578809261*PICODSP_WGT_SHIFT); w1r=(PICOFFTSG_FFTTYPE)(0.999698817730*PICODSP_WGT_SHIFT);
-            w1i=(PICOFFTSG_FFTTYPE)(0.024541229010*PICODSP_WGT_SHIFT); ss =(PICOFFTSG_FFTTYPE)(0.049082458019*PICODSP_WGT_SHIFT); break;
-        default:
-            wdr = 0; wdi = 0; ss = 0; break;
-    }
+    picoos_int32 j, k, m;
+    PICOFFTSG_FFTTYPE wkr, wki, wdr, wdi, xr, xi, yr, yi;
 
     m = n >> 1;
-    i = 0;
-    for (;;) {
-        i0 = i + DCST_LOOP_DIV2;
-        if (i0 > m - 2) {
-            i0 = m - 2;
-        }
-        for (j = i + 2; j <= i0; j += 2) {
-            k = n - j;
-            xr = picofftsg_mult_w_a(wdi, a[j - 1]) - picofftsg_mult_w_a(wdr, a[k + 1]);
-            xi = picofftsg_mult_w_a(wdr, a[j - 1]) + picofftsg_mult_w_a(wdi, a[k + 1]);
-            wkr -= Mult_W_W(ss, wdi);
-            wki += Mult_W_W(ss, wdr);
-            yr = Mult_W_W(wki, a[j]) - Mult_W_W(wkr, a[k]);
-            yi = Mult_W_W(wkr, a[j]) + Mult_W_W(wki, a[k]);
-            wdr -= Mult_W_W(ss, wki);
-            wdi += Mult_W_W(ss, wkr);
-            a[k + 1] = xr;
-            a[k] = yr;
-            a[j - 1] = xi;
-            a[j] = yi;
-        }
-        if (i0 == m - 2) {
-            break;
-        }
+    for (j = 2; j <= m - 2; j += 2, w += 4) {
+        wdr = w[0];
+        wdi = w[1];
+        wkr = w[2];
+        wki = w[3];
+        k = n - j;
+        xr = picofftsg_mult_w_a(wdi, a[j - 1]) - picofftsg_mult_w_a(wdr, a[k + 1]);
+        xi = picofftsg_mult_w_a(wdr, a[j - 1]) + picofftsg_mult_w_a(wdi, a[k + 1]);
+        yr = Mult_W_W(wki, a[j]) - Mult_W_W(wkr, a[k]);
+        yi = Mult_W_W(wkr, a[j]) + Mult_W_W(wki, a[k]);
+        a[k + 1] = xr;
+        a[k] = yr;
+        a[j - 1] = xi;
+        a[j] = yi;
     }
+    wdr = w[0];
+    wdi = w[1];
     xr = picofftsg_mult_w_a(wdi, a[m - 1]) - picofftsg_mult_w_a(wdr, a[m + 1]);
     a[m - 1] = picofftsg_mult_w_a(wdr, a[m - 1]) + picofftsg_mult_w_a(wdi, a[m + 1]);
     a[m + 1] = xr;
@@ -3269,6 +2294,374 @@ void dctsub4(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
     a[m] = Mult_W_W(wki, a[m]);
 }
 
+#if defined(PICODSP_FLOAT)
+/* float32 complex FFT of the 128 values in a, a[2*j] + i*a[2*j+1]:
+   X[k] = sum_j=0^127 x[j]*exp(2*pi*i*j*k/128), computed in place by radix-2
+   decimation in time; the real and imaginary parts are processed separately
+   so that the butterflies work on four values at a time */
+static void cftbflt(picofftsg_plan_t *plan, picoos_single *a)
+{
+    picoos_int32 j, k, l, h;
+    picoos_single *re, *im, *wr, *wi;
+    const picoos_single *p0, *p1, *p2, *p3;
+    picoos_single x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+#if defined(PICODSP_SIMD)
+    picodsp_fvec_t vwr, vwi, var, vai, vbr, vbi, vtr, vti;
+#else
+    picoos_single tr, ti;
+#endif
+
+    /* bit reversal and stages of length 2 and 4 */
+    re = plan->fltRe;
+    im = plan->fltIm;
+    for (j = 0; j < PICOFFTSG_FLT_CFT_SIZE; j += 4) {
+        p0 = a + 2 * plan->fltRev[j];
+        p1 = a + 2 * plan->fltRev[j + 1];
+        p2 = a + 2 * plan->fltRev[j + 2];
+        p3 = a + 2 * plan->fltRev[j + 3];
+        x0r = p0[0] + p1[0];
+        x0i = p0[1] + p1[1];
+        x1r = p0[0] - p1[0];
+        x1i = p0[1] - p1[1];
+        x2r = p2[0] + p3[0];
+        x2i = p2[1] + p3[1];
+        x3r = p2[0] - p3[0];
+        x3i = p2[1] - p3[1];
+        re[j] = x0r + x2r;
+        im[j] = x0i + x2i;
+        re[j + 2] = x0r - x2r;
+        im[j + 2] = x0i - x2i;
+        re[j + 1] = x1r - x3i;
+        im[j + 1] = x1i + x3r;
+        re[j + 3] = x1r + x3i;
+        im[j + 3] = x1i - x3r;
+    }
+
+    /* stages of length 8..128 */
+    wr = plan->fltCftW;
+    for (l = 8; l <= PICOFFTSG_FLT_CFT_SIZE; l <<= 1) {
+        h = l >> 1;
+        wi = wr + h;
+        for (j = 0; j < PICOFFTSG_FLT_CFT_SIZE; j += l) {
+#if defined(PICODSP_SIMD)
+            for (k = 0; k < h; k += 4) {
+                vwr = picodsp_fvload(wr + k);
+                vwi = picodsp_fvload(wi + k);
+                vbr = picodsp_fvload(re + j + h + k);
+                vbi = picodsp_fvload(im + j + h + k);
+                vtr = picodsp_fvsub(picodsp_fvmul(vwr, vbr), picodsp_fvmul(vwi, vbi));
+                vti = picodsp_fvadd(picodsp_fvmul(vwr, vbi), picodsp_fvmul(vwi, vbr));
+                var = picodsp_fvload(re + j + k);
+                vai = picodsp_fvload(im + j + k);
+                picodsp_fvstore(re + j + h + k, picodsp_fvsub(var, vtr));
+                picodsp_fvstore(im + j + h + k, picodsp_fvsub(vai, vti));
+                picodsp_fvstore(re + j + k, picodsp_fvadd(var, vtr));
+                picodsp_fvstore(im + j + k, picodsp_fvadd(vai, vti));
+            }
+#else
+            for (k = 0; k < h; k++) {
+                tr = wr[k] * re[j + h + k] - wi[k] * im[j + h + k];
+                ti = wr[k] * im[j + h + k] + wi[k] * re[j + h + k];
+                re[j + h + k] = re[j + k] - tr;
+                im[j + h + k] = im[j + k] - ti;
+                re[j + k] += tr;
+                im[j + k] += ti;
+            }
+#endif
+        }
+        wr = wi + h;
+    }
+
+#if defined(PICODSP_SIMD)
+    for (j = 0; j < PICOFFTSG_FLT_CFT_SIZE; j += 4) {
+        var = picodsp_fvload(re + j);
+        vai = picodsp_fvload(im + j);
+        picodsp_fvstore(a + 2 * j, picodsp_fvziplo(var, vai));
+        picodsp_fvstore(a + 2 * j + 4, picodsp_fvziphi(var, vai));
+    }
+#else
+    for (j = 0; j < PICOFFTSG_FLT_CFT_SIZE; j++) {
+        a[2 * j] = re[j];
+        a[2 * j + 1] = im[j];
+    }
+#endif
+}
+#endif
+
+/* ***********************************************************************************************/
+/* plan setup: the twiddle factors are produced by the same recurrences as used formerly inside
+   the kernels, so that the results are identical */
+/* ***********************************************************************************************/
+/* twiddle factors of cftmdl1(n) or cftb1st(n), n = 64 or 256 */
+static PICOFFTSG_FFTTYPE *makewt1(picoos_int32 n, PICOFFTSG_FFTTYPE *w)
+{
+    picoos_int32 j, mh;
+    PICOFFTSG_FFTTYPE wk1r, wk1i, wk3r, wk3i,
+        wd1r, wd1i, wd3r, wd3i, ss1, ss3;
+
+    mh = n >> 3;
+    wd1r = PICODSP_WGT_SHIFT;
+    wd1i = 0;
+    wd3r = PICODSP_WGT_SHIFT;
+    wd3i = 0;
+    if (n == 64) {
+        wk1r  =  (PICOFFTSG_FFTTYPE) (0.980785250664  *PICODSP_WGT_SHIFT);
+        wk1i  =  (PICOFFTSG_FFTTYPE) (0.195090323687  *PICODSP_WGT_SHIFT);
+        ss1   =  (PICOFFTSG_FFTTYPE) (0.390180647373  *PICODSP_WGT_SHIFT);
+        wk3i  =  (PICOFFTSG_FFTTYPE) (-0.555570185184 *PICODSP_WGT_SHIFT);
+        wk3r  =  (PICOFFTSG_FFTTYPE) (0.831469595432  *PICODSP_WGT_SHIFT);
+        ss3   =  (PICOFFTSG_FFTTYPE) (-1.111140370369 *PICODSP_WGT_SHIFT);
+    } else {
+        wk1r  = (PICOFFTSG_FFTTYPE) (0.998795449734  *PICODSP_WGT_SHIFT);
+        wk1i  = (PICOFFTSG_FFTTYPE) (0.049067676067  *PICODSP_WGT_SHIFT);
+        ss1   = (PICOFFTSG_FFTTYPE) (0.098135352135  *PICODSP_WGT_SHIFT);
+        wk3i  = (PICOFFTSG_FFTTYPE) (-0.146730467677 *PICODSP_WGT_SHIFT);
+        wk3r  = (PICOFFTSG_FFTTYPE) (0.989176511765  *PICODSP_WGT_SHIFT);
+        ss3   = (PICOFFTSG_FFTTYPE) (-0.293460935354 *PICODSP_WGT_SHIFT);
+    }
+
+    for (j = 2; j < mh - 4; j += 4) {
+        wd1r -= Mult_W_W(ss1, wk1i);
+        wd1i += Mult_W_W(ss1, wk1r);
+        wd3r -= Mult_W_W(ss3, wk3i);
+        wd3i += Mult_W_W(ss3, wk3r);
+        *w++ = wk1r;
+        *w++ = wk1i;
+        *w++ = wd1r;
+        *w++ = wd1i;
+        *w++ = wk3r;
+        *w++ = wk3i;
+        *w++ = wd3r;
+        *w++ = wd3i;
+        wk1r -= Mult_W_W(ss1, wd1i);
+        wk1i += Mult_W_W(ss1, wd1r);
+        wk3r -= Mult_W_W(ss3, wd3i);
+        wk3i += Mult_W_W(ss3, wd3r);
+    }
+    *w++ = wk1r;
+    *w++ = wk1i;
+    *w++ = wk3r;
+    *w++ = wk3i;
+    return w;
+}
+
+/* twiddle factors of cftmdl2(n), n = 64 */
+static PICOFFTSG_FFTTYPE *makewt2(picoos_int32 n, PICOFFTSG_FFTTYPE *w)
+{
+    picoos_int32 j, mh;
+    PICOFFTSG_FFTTYPE wn4r, wk1r, wk1i, wk3r, wk3i,
+        wl1r, wl1i, wl3r, wl3i, wd1r, wd1i, wd3r, wd3i,
+        we1r, we1i, we3r, we3i, ss1, ss3;
+
+    mh = n >> 3;
+    wn4r = WR5000;
+    wl1r = PICODSP_WGT_SHIFT;
+    wl1i = 0;
+    wl3r = PICODSP_WGT_SHIFT;
+    wl3i = 0;
+    we1r = wn4r;
+    we1i = wn4r;
+    we3r = -wn4r;
+    we3i = -wn4r;
+
+    wk1r  =  (PICOFFTSG_FFTTYPE)(0.995184719563  *PICODSP_WGT_SHIFT);
+    wk1i  =  (PICOFFTSG_FFTTYPE)(0.098017141223  *PICODSP_WGT_SHIFT);
+    wd1r  =  (PICOFFTSG_FFTTYPE)(0.634393274784  *PICODSP_WGT_SHIFT);
+    wd1i  =  (PICOFFTSG_FFTTYPE)(0.773010432720  *PICODSP_WGT_SHIFT);
+    ss1   =  (PICOFFTSG_FFTTYPE)(0.196034282446  *PICODSP_WGT_SHIFT);
+    wk3i  =  (PICOFFTSG_FFTTYPE)(-0.290284663439 *PICODSP_WGT_SHIFT);
+    wk3r  =  (PICOFFTSG_FFTTYPE)(0.956940352917  *PICODSP_WGT_SHIFT);
+    ss3   =  (PICOFFTSG_FFTTYPE)(-0.580569326878 *PICODSP_WGT_SHIFT);
+    wd3r  =  (PICOFFTSG_FFTTYPE)(-0.881921231747 *PICODSP_WGT_SHIFT);
+    wd3i  =  (PICOFFTSG_FFTTYPE)(-0.471396744251 *PICODSP_WGT_SHIFT);
+
+    for (j = 2; j < mh - 4; j += 4) {
+        wl1r -= Mult_W_W(ss1, wk1i);
+        wl1i += Mult_W_W(ss1, wk1r);
+        wl3r -= Mult_W_W(ss3, wk3i);
+        wl3i += Mult_W_W(ss3, wk3r);
+        we1r -= Mult_W_W(ss1, wd1i);
+        we1i += Mult_W_W(ss1, wd1r);
+        we3r -= Mult_W_W(ss3, wd3i);
+        we3i += Mult_W_W(ss3, wd3r);
+        *w++ = wk1r;
+        *w++ = wk1i;
+        *w++ = wl1r;
+        *w++ = wl1i;
+        *w++ = wd1r;
+        *w++ = wd1i;
+        *w++ = we1r;
+        *w++ = we1i;
+        *w++ = wk3r;
+        *w++ = wk3i;
+        *w++ = wl3r;
+        *w++ = wl3i;
+        *w++ = wd3r;
+        *w++ = wd3i;
+        *w++ = we3r;
+        *w++ = we3i;
+        wk1r -= Mult_W_W(ss1, wl1i);
+        wk1i += Mult_W_W(ss1, wl1r);
+        wk3r -= Mult_W_W(ss3, wl3i);
+        wk3i += Mult_W_W(ss3, wl3r);
+        wd1r -= Mult_W_W(ss1, we1i);
+        wd1i += Mult_W_W(ss1, we1r);
+        wd3r -= Mult_W_W(ss3, we3i);
+        wd3i += Mult_W_W(ss3, we3r);
+    }
+    *w++ = wk1r;
+    *w++ = wk1i;
+    *w++ = wd1r;
+    *w++ = wd1i;
+    *w++ = wk3r;
+    *w++ = wk3i;
+    *w++ = wd3r;
+    *w++ = wd3i;
+    return w;
+}
+
+/* twiddle factors of rftfsub(n), n = 8..64, or rftbsub(n), n = 256 */
+static PICOFFTSG_FFTTYPE *makert(picoos_int32 n, PICOFFTSG_FFTTYPE *w)
+{
+    picoos_int32 j;
+    PICOFFTSG_FFTTYPE wkr, wki, wdr, wdi, ss;
+
+    wkr = 0;
+    wki = 0;
+
+    switch (n) {
+        case 8 :
+            wdi=(PICOFFTSG_FFTTYPE)(0.353553414345*PICODSP_WGT_SHIFT); wdr=(PICOFFTSG_FFTTYPE)(0.146446630359*PICODSP_WGT_SHIFT);
+            ss =(PICOFFTSG_FFTTYPE)(1.414213657379*PICODSP_WGT_SHIFT); break;
+        case 16 :
+            wdi=(PICOFFTSG_FFTTYPE)(0.191341713071*PICODSP_WGT_SHIFT); wdr=(PICOFFTSG_FFTTYPE)(0.038060232997*PICODSP_WGT_SHIFT);
+            ss =(PICOFFTSG_FFTTYPE)(0.765366852283*PICODSP_WGT_SHIFT); break;
+        case 32 :
+            wdi=(PICOFFTSG_FFTTYPE)(0.097545161843*PICODSP_WGT_SHIFT); wdr=(PICOFFTSG_FFTTYPE)(0.009607359767*PICODSP_WGT_SHIFT);
+            ss =(PICOFFTSG_FFTTYPE)(0.390180647373*PICODSP_WGT_SHIFT); break;
+        case 64 :
+            wdi=(PICOFFTSG_FFTTYPE)(0.049008570611*PICODSP_WGT_SHIFT); wdr=(PICOFFTSG_FFTTYPE)(0.002407636726*PICODSP_WGT_SHIFT);
+            ss =(PICOFFTSG_FFTTYPE)(0.196034282446*PICODSP_WGT_SHIFT); break;
+        case 256 :
+            wdi=(PICOFFTSG_FFTTYPE)(0.012270614505*PICODSP_WGT_SHIFT); wdr=(PICOFFTSG_FFTTYPE)(0.000150590655*PICODSP_WGT_SHIFT);
+            ss =(PICOFFTSG_FFTTYPE)(0.049082458019*PICODSP_WGT_SHIFT); break;
+        default :
+            wdr = 0; wdi = 0; ss = 0;
+            break;
+    }
+
+    for (j = (n >> 1) - 4; j >= 4; j -= 4) {
+        *w++ = wdr;
+        *w++ = wdi;
+        wkr += Mult_W_W(ss, wdi);
+        wki += picofftsg_mult_w_w(ss, (PICOFFTSG_WGT_SHIFT2 - wdr));
+        *w++ = wkr;
+        *w++ = wki;
+        wdr += Mult_W_W(ss, wki);
+        wdi += picofftsg_mult_w_w(ss, (PICOFFTSG_WGT_SHIFT2 - wkr));
+    }
+    *w++ = wdr;
+    *w++ = wdi;
+    return w;
+}
+
+/* twiddle factors of dctsub(n), n = 8..64 */
+static PICOFFTSG_FFTTYPE *makect(picoos_int32 n, PICOFFTSG_FFTTYPE *w)
+{
+    picoos_int32 j, m;
+    PICOFFTSG_FFTTYPE wkr, wki, wdr, wdi, ss;
+
+    wkr = (PICOFFTSG_FFTTYPE)(0.5*PICODSP_WGT_SHIFT);
+    wki = (PICOFFTSG_FFTTYPE)(0.5*PICODSP_WGT_SHIFT);
+
+    switch (n) {
+        case 8 :  wdi=(PICOFFTSG_FFTTYPE)(0.587937772274*PICODSP_WGT_SHIFT);
+            wdr=(PICOFFTSG_FFTTYPE)(0.392847478390*PICODSP_WGT_SHIFT);
+            ss =(PICOFFTSG_FFTTYPE)(0.390180647373*PICODSP_WGT_SHIFT); break;
+        case 16 : wdi=(PICOFFTSG_FFTTYPE)(0.546600937843*PICODSP_WGT_SHIFT);
+            wdr=(PICOFFTSG_FFTTYPE)(0.448583781719*PICODSP_WGT_SHIFT);
+            ss =(PICOFFTSG_FFTTYPE)(0.196034282446*PICODSP_WGT_SHIFT); break;
+        case 32 : wdi=(PICOFFTSG_FFTTYPE)(0.523931562901*PICODSP_WGT_SHIFT);
+            wdr=(PICOFFTSG_FFTTYPE)(0.474863886833*PICODSP_WGT_SHIFT);
+            ss =(PICOFFTSG_FFTTYPE)(0.098135352135*PICODSP_WGT_SHIFT); break;
+        case 64 : wdi=(PICOFFTSG_FFTTYPE)(0.512120008469*PICODSP_WGT_SHIFT);
+            wdr=(PICOFFTSG_FFTTYPE)(0.487578809261*PICODSP_WGT_SHIFT);
+            ss =(PICOFFTSG_FFTTYPE)(0.049082458019*PICODSP_WGT_SHIFT); break;
+        default:
+            wdr = 0; wdi = 0; ss = 0; break;
+    }
+
+    m = n >> 1;
+    for (j = 2; j <= m - 2; j += 2) {
+        *w++ = wdr;
+        *w++ = wdi;
+        wkr -= Mult_W_W(ss, wdi);
+        wki += Mult_W_W(ss, wdr);
+        *w++ = wkr;
+        *w++ = wki;
+        wdr -= Mult_W_W(ss, wki);
+        wdi += Mult_W_W(ss, wkr);
+    }
+    *w++ = wdr;
+    *w++ = wdi;
+    return w;
+}
+
+/* bit reversal of n elements (n a power of 2, n <= 128) */
+static void makeipt(picoos_int32 n, picofftsg_perm_t *ip)
+{
+    picoos_int32 i, j, k, l;
+
+    ip->num = 0;
+    for (i = 0; i < n; i++) {
+        j = 0;
+        for (k = 1, l = n >> 1; k < n; k <<= 1, l >>= 1) {
+            if (i & k) {
+                j |= l;
+            }
+        }
+        if (i < j) {
+            ip->idx[2 * ip->num] = (picoos_uint8) i;
+            ip->idx[2 * ip->num + 1] = (picoos_uint8) j;
+            ip->num++;
+        }
+    }
+}
+
+#if defined(PICODSP_FLOAT)
+/* tables of the float32 transforms */
+static void makeflt(picofftsg_plan_t *plan)
+{
+    picoos_int32 i, j, k, l;
+    picoos_single *w;
+
+    for (j = 0; j < PICOFFTSG_PLAN_RDFT_SIZE / 4; j++) {
+        plan->fltRftU[2 * j + 1] = 0.5f * (picoos_single) picoos_cos(2 * PICODSP_M_PI * j / PICOFFTSG_PLAN_RDFT_SIZE);
+        plan->fltRftU[2 * j] = -plan->fltRftU[2 * j + 1];
+        plan->fltRftV[2 * j] = -0.5f * (picoos_single) picoos_sin(2 * PICODSP_M_PI * j / PICOFFTSG_PLAN_RDFT_SIZE);
+        plan->fltRftV[2 * j + 1] = plan->fltRftV[2 * j];
+    }
+    w = plan->fltCftW;
+    for (l = 8; l <= PICOFFTSG_FLT_CFT_SIZE; l <<= 1) {
+        for (k = 0; k < l / 2; k++) {
+            w[k] = (picoos_single) picoos_cos(2 * PICODSP_M_PI * k / l);
+            w[k + l / 2] = (picoos_single) picoos_sin(2 * PICODSP_M_PI * k / l);
+        }
+        w += l;
+    }
+    PICODBG_ASSERT(w == plan->fltCftW + PICOFFTSG_FLT_CFT_TWIDDLES);
+    for (i = 0; i < PICOFFTSG_FLT_CFT_SIZE; i++) {
+        j = 0;
+        for (k = 1, l = PICOFFTSG_FLT_CFT_SIZE >> 1; k < PICOFFTSG_FLT_CFT_SIZE; k <<= 1, l >>= 1) {
+            if (i & k) {
+                j |= l;
+            }
+        }
+        plan->fltRev[i] = (picoos_uint8) j;
+    }
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
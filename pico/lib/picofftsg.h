@@ -42,10 +42,32 @@ extern "C" {
 
 #define PICOFFTSG_FFTTYPE picoos_int32
 
-extern void rdft(int n, int isgn, PICOFFTSG_FFTTYPE *a);
+/* transform plan: twiddle factors and bit reversal permutations, precomputed
+   once for the transform sizes used by SIG (rdft of 256, dfct_nmf of 128) */
+typedef struct picofftsg_plan * picofftsg_Plan;
+
+/* returns NULL if out of memory or if the sizes are not supported */
+extern picofftsg_Plan picofftsg_newPlan(picoos_MemoryManager mm,
+        picoos_int32 rdftSize, picoos_int32 dfctSize);
+extern void picofftsg_disposePlan(picoos_MemoryManager mm, picofftsg_Plan * this);
+
+/* inverse real DFT of a[0..rdftSize-1] (Ooura's rdft(n, -1, a)) */
+extern void picofftsg_rdftInv(picofftsg_Plan this, PICOFFTSG_FFTTYPE *a);
+/* cosine transform of a[0..dfctSize] (Ooura's dfct(n, a), fixed point) */
+extern void picofftsg_dfctNmf(picofftsg_Plan this, PICOFFTSG_FFTTYPE *a);
+
+#if defined(PICODSP_FLOAT)
+/* float32 versions of the above, with the same definitions */
+extern void picofftsg_rdftInvFloat(picofftsg_Plan this, picoos_single *a);
+/* a[0..2*dfctSize-1], the upper half is used as work area */
+extern void picofftsg_dfctNmfFloat(picofftsg_Plan this, picoos_single *a);
+#endif
+
 extern void dfct(int n, float *a, int VAL_SHIFT);
-extern void dfct_nmf(int n, int *a);
-extern float norm_result(int m2, PICOFFTSG_FFTTYPE *tmpX, PICOFFTSG_FFTTYPE *norm_window);
+extern float norm_result(int m2, PICOFFTSG_FFTTYPE *tmpX, const PICOFFTSG_FFTTYPE *norm_window);
+#if defined(PICODSP_FLOAT)
+extern picoos_single norm_result_float(picoos_int32 m2, picoos_single *tmpX, const PICOFFTSG_FFTTYPE *norm_window);
+#endif
 
 #ifdef __cplusplus
 }
@@ -743,6 +743,73 @@ picokdt_DtPAM  picokdt_getDtPAM (picoknow_KnowledgeBase this) {
 }
 
 
+/* ************************************************************/
+/* decision tree newDt*, disposeDt */
+/* ************************************************************/
+
+/* the input vector and classification result are part of the tree
+   subobj; to share a kb between several engines, each PU therefore
+   classifies on a private copy of the tree subobj. The copy still
+   refers to the tree data of the kb. */
+
+static kdt_subobj_t *kdtNewCopy(picoos_MemoryManager mm,
+                                picoknow_KnowledgeBase this) {
+    kdt_subobj_t *dt;
+    kdt_subobj_t *copy;
+    picoos_objsize_t size;
+
+    if ((NULL == this) || (NULL == this->subObj)) {
+        return NULL;
+    }
+    dt = (kdt_subobj_t *)this->subObj;
+    switch (dt->type) {
+        case PICOKDT_KDTTYPE_POSP: size = sizeof(kdtposp_subobj_t); break;
+        case PICOKDT_KDTTYPE_POSD: size = sizeof(kdtposd_subobj_t); break;
+        case PICOKDT_KDTTYPE_G2P:  size = sizeof(kdtg2p_subobj_t);  break;
+        case PICOKDT_KDTTYPE_PHR:  size = sizeof(kdtphr_subobj_t);  break;
+        case PICOKDT_KDTTYPE_ACC:  size = sizeof(kdtacc_subobj_t);  break;
+        case PICOKDT_KDTTYPE_PAM:  size = sizeof(kdtpam_subobj_t);  break;
+        default:
+            return NULL;
+    }
+    copy = (kdt_subobj_t *)picoos_allocate(mm, size);
+    if (NULL != copy) {
+        picoos_mem_copy(dt, copy, size);
+    }
+    return copy;
+}
+
+picokdt_DtPosP picokdt_newDtPosP(picoos_MemoryManager mm, picoknow_KnowledgeBase this) {
+    return (picokdt_DtPosP) kdtNewCopy(mm, this);
+}
+
+picokdt_DtPosD picokdt_newDtPosD(picoos_MemoryManager mm, picoknow_KnowledgeBase this) {
+    return (picokdt_DtPosD) kdtNewCopy(mm, this);
+}
+
+picokdt_DtG2P  picokdt_newDtG2P (picoos_MemoryManager mm, picoknow_KnowledgeBase this) {
+    return (picokdt_DtG2P) kdtNewCopy(mm, this);
+}
+
+picokdt_DtPHR  picokdt_newDtPHR (picoos_MemoryManager mm, picoknow_KnowledgeBase this) {
+    return (picokdt_DtPHR) kdtNewCopy(mm, this);
+}
+
+picokdt_DtACC  picokdt_newDtACC (picoos_MemoryManager mm, picoknow_KnowledgeBase this) {
+    return (picokdt_DtACC) kdtNewCopy(mm, this);
+}
+
+picokdt_DtPAM  picokdt_newDtPAM (picoos_MemoryManager mm, picoknow_KnowledgeBase this) {
+    return (picokdt_DtPAM) kdtNewCopy(mm, this);
+}
+
+void picokdt_disposeDt(picoos_MemoryManager mm, void **dt) {
+    if (NULL != *dt) {
+        picoos_deallocate(mm, dt);
+    }
+}
+
+
 
 /* ************************************************************/
 /* decision tree support functions, tree */
@@ -98,6 +98,21 @@ picokdt_DtPHR  picokdt_getDtPHR (picoknow_KnowledgeBase this);
 picokdt_DtACC  picokdt_getDtACC (picoknow_KnowledgeBase this);
 picokdt_DtPAM  picokdt_getDtPAM (picoknow_KnowledgeBase this);
 
+/* return a private copy of the kb decision tree for usage in one PU
+   instance. The tree functions below keep the input vector and the
+   classification result in the tree object, so PUs of concurrent
+   engines must not work on the shared kb tree directly. NULL if the kb
+   is missing or out of memory */
+picokdt_DtPosP picokdt_newDtPosP(picoos_MemoryManager mm, picoknow_KnowledgeBase this);
+picokdt_DtPosD picokdt_newDtPosD(picoos_MemoryManager mm, picoknow_KnowledgeBase this);
+picokdt_DtG2P  picokdt_newDtG2P (picoos_MemoryManager mm, picoknow_KnowledgeBase this);
+picokdt_DtPHR  picokdt_newDtPHR (picoos_MemoryManager mm, picoknow_KnowledgeBase this);
+picokdt_DtACC  picokdt_newDtACC (picoos_MemoryManager mm, picoknow_KnowledgeBase this);
+picokdt_DtPAM  picokdt_newDtPAM (picoos_MemoryManager mm, picoknow_KnowledgeBase this);
+
+/* dispose a decision tree copy created by one of the picokdt_newDt* functions */
+void picokdt_disposeDt(picoos_MemoryManager mm, void **dt);
+
 
 /* number of attributes (= input vector size) for each tree type */
 typedef enum {
@@ -89,6 +89,7 @@ extern "C" {
 /* general */
 #define PICOOS_MSG_WARN_INCOMPLETE    (picoos_char *)  "incomplete output"
 #define PICOOS_MSG_WARN_FALLBACK      (picoos_char *)  "using fall-back"
+#define PICOOS_MSG_WARN_CANCELLED     (picoos_char *)  "synthesis cancelled"
 #define PICOOS_MSG_WARN_OTHER         (picoos_char *)  "other warning"
 
 /* resources */
@@ -254,6 +255,13 @@ typedef struct mem_cell_hdr
     MemCellHdr prevFree, nextFree;
 } mem_cell_hdr_t;
 
+typedef struct arena_hdr * ArenaHdr;
+typedef struct arena_hdr
+{
+    ArenaHdr prev; /* previously allocated block */
+    picoos_bool freed;
+} arena_hdr_t;
+
 typedef struct memory_manager
 {
     MemBlockHdr firstBlock, lastBlock; /* memory blockList */
@@ -268,8 +276,33 @@ typedef struct memory_manager
     picoos_ptrdiff_t usedSize;
     picoos_ptrdiff_t prevUsedSize;
     picoos_ptrdiff_t maxUsedSize;
+    picoos_Mutex lock; /* NULL unless shared between threads */
+    picoos_uint8 mode; /* allocation strategy (PICOOS_MEM_...) */
+    MemCellHdr * bins; /* PICOOS_MEM_SIZE_CLASSES: free cells per size class */
+    picoos_uint32 * binMap; /* PICOOS_MEM_SIZE_CLASSES: bit set for each non-empty class */
+    ArenaHdr arenaLast; /* PICOOS_MEM_ARENA: most recently allocated block */
+    byte_ptr_t arenaTop, arenaEnd; /* PICOOS_MEM_ARENA: free part of the block */
+    picoos_objsize_t arenaHdrSize; /* PICOOS_MEM_ARENA: aligned size of block header */
+    picoos_bool grow; /* PICOOS_MEM_GROW: chain further blocks when exhausted */
+    byte_ptr_t highWater; /* end of the highest cell ever allocated in the first block */
 } memory_manager_t;
 
+/* minimum size of the blocks chained by PICOOS_MEM_GROW */
+#define MEM_GROW_BLOCK_SIZE 262144
+
+/* size classes of PICOOS_MEM_SIZE_CLASSES: cells smaller than
+   MEM_SMALL_LIMIT have a class of their own for each size (all cells of
+   a small class have the same size); larger cells are divided into
+   2^MEM_SUB_SHIFT classes per power of two up to 2^MEM_MAX_SHIFT; the last
+   class also holds all larger cells */
+#define MEM_SMALL_SHIFT     9
+#define MEM_SMALL_LIMIT     (1 << MEM_SMALL_SHIFT)
+#define MEM_SUB_SHIFT       2
+#define MEM_MAX_SHIFT       31
+#define MEM_NUM_SMALL_BINS  (MEM_SMALL_LIMIT / PICOOS_ALIGN_SIZE)
+#define MEM_NUM_BINS        (MEM_NUM_SMALL_BINS + ((MEM_MAX_SHIFT - MEM_SMALL_SHIFT + 1) << MEM_SUB_SHIFT))
+#define MEM_NUM_MAP_WORDS   ((MEM_NUM_BINS + 31) / 32)
+
 /** allocates 'alloc_size' bytes at start of raw memory block ('raw_mem',raw_mem_size)
  *  and returns pointer to allocated region. Returns remaining (correctly aligned) raw memory block
  *  in ('rest_mem','rest_mem_size').
@@ -301,6 +334,106 @@ void * picoos_raw_malloc(byte_ptr_t raw_mem,
     }
 }
 
+/** returns the size class of a cell of 'size' bytes */
+static picoos_uint32 os_sizeClass(picoos_objsize_t size)
+{
+    picoos_uint32 shift;
+
+    if (size < MEM_SMALL_LIMIT) {
+        return (picoos_uint32) (size / PICOOS_ALIGN_SIZE);
+    }
+    shift = MEM_SMALL_SHIFT;
+    while ((shift < MEM_MAX_SHIFT) && ((size >> (shift + 1)) != 0)) {
+        shift++;
+    }
+    if ((size >> MEM_MAX_SHIFT) > 1) {
+        return MEM_NUM_BINS - 1;
+    }
+    return MEM_NUM_SMALL_BINS + ((shift - MEM_SMALL_SHIFT) << MEM_SUB_SHIFT)
+            + (picoos_uint32) ((size >> (shift - MEM_SUB_SHIFT)) & ((1 << MEM_SUB_SHIFT) - 1));
+}
+
+/** returns the index of the lowest bit set in 'x' (which must not be 0) */
+static picoos_uint32 os_lowestBit(picoos_uint32 x)
+{
+    picoos_uint32 n = 0;
+
+    if (0 == (x & 0xffff)) {
+        n += 16;
+        x >>= 16;
+    }
+    if (0 == (x & 0xff)) {
+        n += 8;
+        x >>= 8;
+    }
+    if (0 == (x & 0xf)) {
+        n += 4;
+        x >>= 4;
+    }
+    if (0 == (x & 0x3)) {
+        n += 2;
+        x >>= 2;
+    }
+    if (0 == (x & 0x1)) {
+        n += 1;
+    }
+    return n;
+}
+
+/** returns the first non-empty size class starting at 'bin', or -1 */
+static picoos_int32 os_findSizeClass(picoos_MemoryManager this, picoos_uint32 bin)
+{
+    picoos_uint32 w, bits;
+
+    if (bin >= MEM_NUM_BINS) {
+        return -1;
+    }
+    w = bin >> 5;
+    bits = this->binMap[w] & (~((picoos_uint32) 0) << (bin & 31));
+    while (0 == bits) {
+        w++;
+        if (w >= MEM_NUM_MAP_WORDS) {
+            return -1;
+        }
+        bits = this->binMap[w];
+    }
+    return (picoos_int32) ((w << 5) + os_lowestBit(bits));
+}
+
+/** puts free cell 'c' into the list of its size class */
+static void os_insertFreeCell(picoos_MemoryManager this, MemCellHdr c)
+{
+    picoos_uint32 bin = os_sizeClass((picoos_objsize_t) c->size);
+
+    c->prevFree = NULL;
+    c->nextFree = this->bins[bin];
+    if (NULL != c->nextFree) {
+        c->nextFree->prevFree = c;
+    }
+    this->bins[bin] = c;
+    this->binMap[bin >> 5] |= ((picoos_uint32) 1) << (bin & 31);
+}
+
+/** removes free cell 'c' (with its size unchanged since insertion) from
+    the list of its size class */
+static void os_removeFreeCell(picoos_MemoryManager this, MemCellHdr c)
+{
+    picoos_uint32 bin;
+
+    if (NULL != c->prevFree) {
+        c->prevFree->nextFree = c->nextFree;
+    } else {
+        bin = os_sizeClass((picoos_objsize_t) c->size);
+        this->bins[bin] = c->nextFree;
+        if (NULL == c->nextFree) {
+            this->binMap[bin >> 5] &= ~(((picoos_uint32) 1) << (bin & 31));
+        }
+    }
+    if (NULL != c->nextFree) {
+        c->nextFree->prevFree = c->prevFree;
+    }
+}
+
 /** initializes the last block of mm */
 static int os_init_mem_block(picoos_MemoryManager this)
 {
@@ -323,7 +456,12 @@ static int os_init_mem_block(picoos_MemoryManager this)
     cmid->leftCell = cbeg;
     cend->size = 0;
     cend->leftCell = cmid;
-    if (isFirstBlock) {
+    if (PICOOS_MEM_SIZE_CLASSES == this->mode) {
+        /* the zero-sized border cells are never free */
+        cbeg->nextFree = cbeg->prevFree = NULL;
+        cend->nextFree = cend->prevFree = NULL;
+        os_insertFreeCell(this, cmid);
+    } else if (isFirstBlock) {
         cbeg->nextFree = cmid;
         cbeg->prevFree = NULL;
         cmid->nextFree = cend;
@@ -351,6 +489,16 @@ picoos_MemoryManager picoos_newMemoryManager(
         void *raw_memory,
         picoos_objsize_t size,
         picoos_bool enableMemProt)
+{
+    return picoos_newMemoryManagerEx(raw_memory, size, enableMemProt,
+            PICOOS_MEM_FIRST_FIT);
+}
+
+picoos_MemoryManager picoos_newMemoryManagerEx(
+        void *raw_memory,
+        picoos_objsize_t size,
+        picoos_bool enableMemProt,
+        picoos_uint8 mode)
 {
     byte_ptr_t rest_mem;
     picoos_objsize_t rest_mem_size;
@@ -384,6 +532,38 @@ picoos_MemoryManager picoos_newMemoryManager(
     this->usedSize = 0;
     this->prevUsedSize = 0;
     this->maxUsedSize = 0;
+    this->lock = NULL;
+    this->mode = mode;
+    this->bins = NULL;
+    this->binMap = NULL;
+    this->arenaLast = NULL;
+    this->arenaTop = this->arenaEnd = NULL;
+    this->arenaHdrSize = ((sizeof(arena_hdr_t) + PICOOS_ALIGN_SIZE - 1)
+            / PICOOS_ALIGN_SIZE) * PICOOS_ALIGN_SIZE;
+    this->grow = (0 != (mode & PICOOS_MEM_GROW));
+    mode &= ~PICOOS_MEM_GROW;
+    this->mode = mode;
+
+    if (PICOOS_MEM_SIZE_CLASSES == mode) {
+        raw_memory = rest_mem;
+        size = rest_mem_size;
+        this->bins = picoos_raw_malloc(raw_memory, size,
+                MEM_NUM_BINS * sizeof(MemCellHdr), &rest_mem, &rest_mem_size);
+        raw_memory = rest_mem;
+        size = rest_mem_size;
+        this->binMap = picoos_raw_malloc(raw_memory, size,
+                MEM_NUM_MAP_WORDS * sizeof(picoos_uint32), &rest_mem, &rest_mem_size);
+        if ((NULL == this->bins) || (NULL == this->binMap)) {
+            return NULL;
+        }
+        picoos_mem_set(this->bins, 0, MEM_NUM_BINS * sizeof(MemCellHdr));
+        picoos_mem_set(this->binMap, 0, MEM_NUM_MAP_WORDS * sizeof(picoos_uint32));
+    } else if (PICOOS_MEM_ARENA == mode) {
+        /* an arena is released as a whole with its raw memory block */
+        this->grow = FALSE;
+    } else {
+        this->mode = PICOOS_MEM_FIRST_FIT;
+    }
 
     /* get aligned full header size */
     this->fullCellHdrSize = ((sizeof(mem_cell_hdr_t) + PICOOS_ALIGN_SIZE - 1)
@@ -417,16 +597,82 @@ picoos_MemoryManager picoos_newMemoryManager(
     this->lastBlock->data = rest_mem;
     this->lastBlock->size = rest_mem_size;
 
-    os_init_mem_block(this);
+    if (PICOOS_MEM_ARENA == this->mode) {
+        this->arenaTop = rest_mem;
+        this->arenaEnd = rest_mem + rest_mem_size;
+        this->highWater = rest_mem;
+    } else {
+        os_init_mem_block(this);
+        this->highWater = rest_mem + this->fullCellHdrSize;
+    }
 
     return this;
 }
 
 void picoos_disposeMemoryManager(picoos_MemoryManager * mm)
 {
+    MemBlockHdr block, next;
+
+    if (NULL != *mm) {
+        if (NULL != (*mm)->lock) {
+            picopal_mutex_destroy((*mm)->lock);
+        }
+        /* each chained block starts with its header */
+        block = (*mm)->firstBlock->next;
+        while (NULL != block) {
+            next = block->next;
+            picopal_mem_free((void **) &block);
+            block = next;
+        }
+    }
     *mm = NULL;
 }
 
+/** PICOOS_MEM_GROW: chains a new block that can hold at least 'byteSize' bytes */
+static picoos_bool os_grow(picoos_MemoryManager this, picoos_objsize_t byteSize)
+{
+    void * raw;
+    picoos_objsize_t size;
+    byte_ptr_t rest_mem;
+    picoos_objsize_t rest_mem_size;
+    MemBlockHdr block;
+
+    /* first-fit only splits a cell if the rest is at least minCellSize */
+    size = byteSize + this->minContSize + this->usedCellHdrSize
+            + this->minCellSize + 2 * this->fullCellHdrSize
+            + sizeof(mem_block_hdr_t) + 2 * PICOOS_ALIGN_SIZE;
+    if (size < MEM_GROW_BLOCK_SIZE) {
+        size = MEM_GROW_BLOCK_SIZE;
+    }
+    raw = picopal_mem_alloc(size);
+    block = picoos_raw_malloc(raw, size, sizeof(mem_block_hdr_t),
+            &rest_mem, &rest_mem_size);
+    if (NULL == block) {
+        return FALSE;
+    }
+    block->next = NULL;
+    block->data = rest_mem;
+    block->size = rest_mem_size;
+    this->lastBlock->next = block;
+    this->lastBlock = block;
+    os_init_mem_block(this);
+    PICODBG_DEBUG(("memory manager grown by %i bytes", (picoos_int32) size));
+    return TRUE;
+}
+
+/** records 'cell' of 'size' bytes for the high-water mark of the first block */
+static void os_noteHighWater(picoos_MemoryManager this, void * cell,
+        picoos_objsize_t size)
+{
+    byte_ptr_t end = (byte_ptr_t) cell + size;
+
+    if ((end > this->highWater)
+            && ((byte_ptr_t) cell >= this->firstBlock->data)
+            && (end <= this->firstBlock->data + this->firstBlock->size)) {
+        this->highWater = end;
+    }
+}
+
 
 /* the following memory manager routines are for testing and
    debugging purposes */
@@ -480,12 +726,14 @@ void picoos_getMemUsage(
         picoos_int32 *incrUsedBytes,
         picoos_int32 *maxUsedBytes)
 {
+    picoos_lockMutex(this->lock);
     *usedBytes = (picoos_int32) this->usedSize;
     *incrUsedBytes = (picoos_int32) (this->usedSize - this->prevUsedSize);
     *maxUsedBytes = (picoos_int32) this->maxUsedSize;
     if (resetIncremental) {
         this->prevUsedSize = this->usedSize;
     }
+    picoos_unlockMutex(this->lock);
 }
 
 
@@ -504,7 +752,71 @@ void picoos_showMemUsage(picoos_MemoryManager this, picoos_bool incremental,
 }
 
 
-void * picoos_allocate(picoos_MemoryManager this,
+picoos_objsize_t picoos_getMemHighWater(picoos_MemoryManager this)
+{
+    picoos_objsize_t size, maxSize;
+    MemBlockHdr block;
+
+    picoos_lockMutex(this->lock);
+    size = this->highWater - (byte_ptr_t) this;
+    if (PICOOS_MEM_ARENA != this->mode) {
+        /* room for splitting off the free rest, and the end border cell */
+        size += this->minCellSize + this->fullCellHdrSize;
+    }
+    maxSize = (this->firstBlock->data + this->firstBlock->size) - (byte_ptr_t) this;
+    if (size > maxSize) {
+        size = maxSize;
+    }
+    for (block = this->firstBlock->next; NULL != block; block = block->next) {
+        size += (block->data - (byte_ptr_t) block) + block->size;
+    }
+    picoos_unlockMutex(this->lock);
+    return size;
+}
+
+void picoos_getMemFragmentation(
+        picoos_MemoryManager this,
+        picoos_int32 *freeBytes,
+        picoos_int32 *largestFreeBytes,
+        picoos_int32 *numFreeCells)
+{
+    MemCellHdr c;
+    picoos_uint32 bin;
+
+    *freeBytes = 0;
+    *largestFreeBytes = 0;
+    *numFreeCells = 0;
+    picoos_lockMutex(this->lock);
+    if ((PICOOS_MEM_ARENA == this->mode) && (this->arenaEnd > this->arenaTop)) {
+        *freeBytes = (picoos_int32) (this->arenaEnd - this->arenaTop);
+        *largestFreeBytes = *freeBytes;
+        *numFreeCells = 1;
+    }
+    for (bin = 0; bin < MEM_NUM_BINS; bin++) {
+        if (PICOOS_MEM_SIZE_CLASSES == this->mode) {
+            c = this->bins[bin];
+        } else if ((0 == bin) && (PICOOS_MEM_FIRST_FIT == this->mode)) {
+            c = this->freeCells;
+        } else {
+            break;
+        }
+        while (NULL != c) {
+            /* the first-fit list includes the zero-sized border cells */
+            if (c->size > 0) {
+                *freeBytes += (picoos_int32) c->size;
+                if ((picoos_int32) c->size > *largestFreeBytes) {
+                    *largestFreeBytes = (picoos_int32) c->size;
+                }
+                (*numFreeCells)++;
+            }
+            c = c->nextFree;
+        }
+    }
+    picoos_unlockMutex(this->lock);
+}
+
+
+static void * os_allocate(picoos_MemoryManager this,
         picoos_objsize_t byteSize)
 {
 
@@ -557,7 +869,7 @@ void * picoos_allocate(picoos_MemoryManager this,
     return adr;
 }
 
-void picoos_deallocate(picoos_MemoryManager this, void * * adr)
+static void os_deallocate(picoos_MemoryManager this, void * * adr)
 {
     MemCellHdr c;
     MemCellHdr cr;
@@ -606,6 +918,311 @@ void picoos_deallocate(picoos_MemoryManager this, void * * adr)
     *adr = NULL;
 }
 
+/* PICOOS_MEM_SIZE_CLASSES: a request is served from its own size class if
+   the first cell there is large enough, otherwise from the first non-empty
+   larger class, all of whose cells are large enough; only the (open-ended)
+   last class is searched */
+static void * os_allocateSizeClass(picoos_MemoryManager this,
+        picoos_objsize_t byteSize)
+{
+    picoos_objsize_t cellSize;
+    picoos_int32 bin;
+    MemCellHdr c, c2, c2r;
+
+    if (byteSize < this->minContSize) {
+        byteSize = this->minContSize;
+    }
+    byteSize = ((byteSize + PICOOS_ALIGN_SIZE - 1) / PICOOS_ALIGN_SIZE)
+            * PICOOS_ALIGN_SIZE;
+
+    cellSize = byteSize + this->usedCellHdrSize;
+    bin = (picoos_int32) os_sizeClass(cellSize);
+    c = this->bins[bin];
+    if (MEM_NUM_BINS - 1 == bin) {
+        while ((NULL != c) && (c->size < (picoos_ptrdiff_t) cellSize)) {
+            c = c->nextFree;
+        }
+    } else if ((NULL == c) || (c->size < (picoos_ptrdiff_t) cellSize)) {
+        bin = os_findSizeClass(this, bin + 1);
+        c = (bin < 0) ? NULL : this->bins[bin];
+    }
+    if (c == NULL) {
+        return NULL;
+    }
+    os_removeFreeCell(this, c);
+    /* split unless the remainder is too small to be a cell of its own */
+    if (c->size >= (picoos_ptrdiff_t)(cellSize + this->minCellSize)) {
+        c2 = (MemCellHdr)((picoos_objsize_t)c + cellSize);
+        c2->size = c->size - cellSize;
+        c->size = cellSize;
+        c2->leftCell = c;
+        c2r = (MemCellHdr)((picoos_objsize_t)c2 + c2->size);
+        c2r->leftCell = c2;
+        os_insertFreeCell(this, c2);
+    }
+
+    /* statistics */
+    this->usedSize += c->size;
+    if (this->usedSize > this->maxUsedSize) {
+        this->maxUsedSize = this->usedSize;
+    }
+
+    c->size = -(c->size);
+    return (void *)((picoos_objsize_t)c + this->usedCellHdrSize);
+}
+
+static void os_deallocateSizeClass(picoos_MemoryManager this, void * * adr)
+{
+    MemCellHdr c;
+    MemCellHdr cr;
+    MemCellHdr cl;
+
+    if ((*adr) != NULL) {
+        c = (MemCellHdr)((picoos_objsize_t)(*adr) - this->usedCellHdrSize);
+        c->size = -(c->size);
+
+        /* statistics */
+        this->usedSize -= c->size;
+
+        cr = (MemCellHdr)((picoos_objsize_t)c + c->size);
+        cl = c->leftCell;
+        if (cl->size > 0) {
+            os_removeFreeCell(this, cl);
+            cl->size = cl->size + c->size;
+            c = cl;
+        }
+        if (cr->size > 0) {
+            os_removeFreeCell(this, cr);
+            c->size = c->size + cr->size;
+            cr = (MemCellHdr)((picoos_objsize_t)cr + cr->size);
+        }
+        cr->leftCell = c;
+        os_insertFreeCell(this, c);
+    }
+    *adr = NULL;
+}
+
+static void * os_allocateArena(picoos_MemoryManager this,
+        picoos_objsize_t byteSize)
+{
+    picoos_objsize_t cellSize;
+    ArenaHdr c;
+
+    byteSize = ((byteSize + PICOOS_ALIGN_SIZE - 1) / PICOOS_ALIGN_SIZE)
+            * PICOOS_ALIGN_SIZE;
+    cellSize = byteSize + this->arenaHdrSize;
+    if (cellSize > (picoos_objsize_t) (this->arenaEnd - this->arenaTop)) {
+        return NULL;
+    }
+    c = (ArenaHdr) this->arenaTop;
+    c->prev = this->arenaLast;
+    c->freed = FALSE;
+    this->arenaLast = c;
+    this->arenaTop += cellSize;
+    if (this->arenaTop > this->highWater) {
+        this->highWater = this->arenaTop;
+    }
+
+    /* statistics */
+    this->usedSize += cellSize;
+    if (this->usedSize > this->maxUsedSize) {
+        this->maxUsedSize = this->usedSize;
+    }
+
+    return (void *)((picoos_objsize_t)c + this->arenaHdrSize);
+}
+
+static void os_deallocateArena(picoos_MemoryManager this, void * * adr)
+{
+    ArenaHdr c;
+
+    if ((*adr) != NULL) {
+        c = (ArenaHdr)((picoos_objsize_t)(*adr) - this->arenaHdrSize);
+        c->freed = TRUE;
+        /* reclaim deallocated blocks from the top */
+        while ((NULL != this->arenaLast) && this->arenaLast->freed) {
+            this->usedSize -= this->arenaTop - (byte_ptr_t) this->arenaLast;
+            this->arenaTop = (byte_ptr_t) this->arenaLast;
+            this->arenaLast = this->arenaLast->prev;
+        }
+    }
+    *adr = NULL;
+}
+
+static void * os_allocateMode(picoos_MemoryManager this,
+        picoos_objsize_t byteSize)
+{
+    void * adr;
+    MemCellHdr c;
+    picoos_uint8 tries = this->grow ? 2 : 1;
+
+    if (PICOOS_MEM_ARENA == this->mode) {
+        return os_allocateArena(this, byteSize);
+    }
+    do {
+        if (PICOOS_MEM_SIZE_CLASSES == this->mode) {
+            adr = os_allocateSizeClass(this, byteSize);
+        } else {
+            adr = os_allocate(this, byteSize);
+        }
+        tries--;
+    } while ((NULL == adr) && (tries > 0) && os_grow(this, byteSize));
+    if (NULL != adr) {
+        /* the size of a used cell is negative */
+        c = (MemCellHdr)((picoos_objsize_t)adr - this->usedCellHdrSize);
+        os_noteHighWater(this, c, (picoos_objsize_t) -(c->size));
+    }
+    return adr;
+}
+
+static void os_deallocateMode(picoos_MemoryManager this, void * * adr)
+{
+    if (PICOOS_MEM_SIZE_CLASSES == this->mode) {
+        os_deallocateSizeClass(this, adr);
+    } else if (PICOOS_MEM_ARENA == this->mode) {
+        os_deallocateArena(this, adr);
+    } else {
+        os_deallocate(this, adr);
+    }
+}
+
+void * picoos_allocate(picoos_MemoryManager this,
+        picoos_objsize_t byteSize)
+{
+    void * adr;
+
+    if (NULL == this->lock) {
+        return os_allocateMode(this, byteSize);
+    }
+    picoos_lockMutex(this->lock);
+    adr = os_allocateMode(this, byteSize);
+    picoos_unlockMutex(this->lock);
+    return adr;
+}
+
+void picoos_deallocate(picoos_MemoryManager this, void * * adr)
+{
+    if (NULL == this->lock) {
+        os_deallocateMode(this, adr);
+    } else {
+        picoos_lockMutex(this->lock);
+        os_deallocateMode(this, adr);
+        picoos_unlockMutex(this->lock);
+    }
+}
+
+picoos_bool picoos_enableMemLock(picoos_MemoryManager this)
+{
+    if (NULL == this->lock) {
+        /* allocated from the memory manager itself before locking is enabled */
+        this->lock = picoos_newMutex(this);
+    }
+    return (NULL != this->lock);
+}
+
+/* *****************************************************************/
+/* Mutual Exclusion                                                */
+/* *****************************************************************/
+
+picoos_Mutex picoos_newMutex(picoos_MemoryManager mm)
+{
+    picoos_objsize_t size = picopal_mutex_size();
+    void * mem;
+    picoos_Mutex this;
+
+    if (0 == size) {
+        return NULL;
+    }
+    mem = picoos_allocate(mm, size);
+    this = picopal_mutex_init(mem);
+    if ((NULL == this) && (NULL != mem)) {
+        picoos_deallocate(mm, &mem);
+    }
+    return this;
+}
+
+void picoos_disposeMutex(picoos_MemoryManager mm, picoos_Mutex * this)
+{
+    if (NULL != (*this)) {
+        picopal_mutex_destroy(*this);
+        picoos_deallocate(mm, (void *) this);
+    }
+}
+
+void picoos_lockMutex(picoos_Mutex this)
+{
+    picopal_mutex_lock(this);
+}
+
+void picoos_unlockMutex(picoos_Mutex this)
+{
+    picopal_mutex_unlock(this);
+}
+
+picoos_Cond picoos_newCond(picoos_MemoryManager mm)
+{
+    picoos_objsize_t size = picopal_cond_size();
+    void * mem;
+    picoos_Cond this;
+
+    if (0 == size) {
+        return NULL;
+    }
+    mem = picoos_allocate(mm, size);
+    this = picopal_cond_init(mem);
+    if ((NULL == this) && (NULL != mem)) {
+        picoos_deallocate(mm, &mem);
+    }
+    return this;
+}
+
+void picoos_disposeCond(picoos_MemoryManager mm, picoos_Cond * this)
+{
+    if (NULL != (*this)) {
+        picopal_cond_destroy(*this);
+        picoos_deallocate(mm, (void *) this);
+    }
+}
+
+void picoos_waitCond(picoos_Cond this, picoos_Mutex mutex)
+{
+    picopal_cond_wait(this, mutex);
+}
+
+void picoos_signalCond(picoos_Cond this)
+{
+    picopal_cond_broadcast(this);
+}
+
+/* *****************************************************************/
+/* Threads                                                         */
+/* *****************************************************************/
+
+picoos_Thread picoos_startThread(picoos_MemoryManager mm, picoos_thread_fn fn, void * arg)
+{
+    picoos_objsize_t size = picopal_thread_size();
+    void * mem;
+    picoos_Thread this;
+
+    if (0 == size) {
+        return NULL;
+    }
+    mem = picoos_allocate(mm, size);
+    this = picopal_thread_start(mem, fn, arg);
+    if ((NULL == this) && (NULL != mem)) {
+        picoos_deallocate(mm, &mem);
+    }
+    return this;
+}
+
+void picoos_joinThread(picoos_MemoryManager mm, picoos_Thread * this)
+{
+    if (NULL != (*this)) {
+        picopal_thread_join(*this);
+        picoos_deallocate(mm, (void *) this);
+    }
+}
+
 /* *****************************************************************/
 /* Exception Management                                                */
 /* *****************************************************************/
@@ -626,13 +1243,16 @@ typedef struct picoos_exception_manager
     picoos_int32 curWarningCode[PICOOS_MAX_NUM_WARNINGS];
     picoos_warn_msg curWarningMessage[PICOOS_MAX_NUM_WARNINGS];
 
+    picoos_Mutex lock; /* NULL unless shared between threads */
 } picoos_exception_manager_t;
 
 void picoos_emReset(picoos_ExceptionManager this)
 {
+    picoos_lockMutex(this->lock);
     this->curExceptionCode = PICO_OK;
     this->curExceptionMessage[0] = '\0';
     this->curNumWarnings = 0;
+    picoos_unlockMutex(this->lock);
 }
 
 picoos_ExceptionManager picoos_newExceptionManager(picoos_MemoryManager mm)
@@ -641,6 +1261,7 @@ picoos_ExceptionManager picoos_newExceptionManager(picoos_MemoryManager mm)
             mm, sizeof(*this));
     if (NULL != this) {
         /* initialize */
+        this->lock = NULL;
         picoos_emReset(this);
     }
     return this;
@@ -651,10 +1272,19 @@ void picoos_disposeExceptionManager(picoos_MemoryManager mm,
 {
     if (NULL != (*this)) {
         /* terminate */
+        picoos_disposeMutex(mm, &(*this)->lock);
         picoos_deallocate(mm, (void *)this);
     }
 }
 
+picoos_bool picoos_emEnableLock(picoos_ExceptionManager this, picoos_MemoryManager mm)
+{
+    if (NULL == this->lock) {
+        this->lock = picoos_newMutex(mm);
+    }
+    return (NULL != this->lock);
+}
+
 static void picoos_vSetErrorMsg(picoos_char * dst, picoos_objsize_t siz,
         picoos_int16 code, picoos_char * base, const picoos_char *fmt, va_list args)
 {
@@ -755,6 +1385,9 @@ static void picoos_vSetErrorMsg(picoos_char * dst, picoos_objsize_t siz,
             case PICO_WARN_FALLBACK:
                 base = PICOOS_MSG_WARN_FALLBACK;
                 break;
+            case PICO_WARN_CANCELLED:
+                base = PICOOS_MSG_WARN_CANCELLED;
+                break;
 
             case PICO_WARN_OTHER:
                 base = PICOOS_MSG_WARN_OTHER;
@@ -820,8 +1453,9 @@ pico_status_t picoos_emRaiseException(picoos_ExceptionManager this,
         pico_status_t exceptionCode, picoos_char * baseMessage, picoos_char * fmt, ...)
 {
     va_list args;
+    pico_status_t code;
 
-
+    picoos_lockMutex(this->lock);
     if (PICO_OK == this->curExceptionCode && PICO_OK != exceptionCode) {
         this->curExceptionCode = exceptionCode;
         va_start(args, (char *)fmt);
@@ -833,7 +1467,9 @@ pico_status_t picoos_emRaiseException(picoos_ExceptionManager this,
         va_end(args);
 
     }
-    return this->curExceptionCode;
+    code = this->curExceptionCode;
+    picoos_unlockMutex(this->lock);
+    return code;
 }
 
 pico_status_t picoos_emGetExceptionCode(picoos_ExceptionManager this)
@@ -843,13 +1479,16 @@ pico_status_t picoos_emGetExceptionCode(picoos_ExceptionManager this)
 
 void picoos_emGetExceptionMessage(picoos_ExceptionManager this, picoos_char * msg, picoos_uint16 maxsize)
 {
+        picoos_lockMutex(this->lock);
         picoos_strlcpy(msg,this->curExceptionMessage,maxsize);
+        picoos_unlockMutex(this->lock);
 }
 
 void picoos_emRaiseWarning(picoos_ExceptionManager this,
         pico_status_t warningCode, picoos_char * baseMessage, picoos_char * fmt, ...)
 {
     va_list args;
+    picoos_lockMutex(this->lock);
     if ((this->curNumWarnings < PICOOS_MAX_NUM_WARNINGS) && (PICO_OK != warningCode)) {
         if (PICOOS_MAX_NUM_WARNINGS-1 == this->curNumWarnings) {
             this->curWarningCode[this->curNumWarnings] = PICO_EXC_MAX_NUM_EXCEED;
@@ -867,6 +1506,7 @@ void picoos_emRaiseWarning(picoos_ExceptionManager this,
         this->curWarningCode[this->curNumWarnings-1],
         this->curWarningMessage[this->curNumWarnings-1],
         this->curNumWarnings));
+    picoos_unlockMutex(this->lock);
 }
 
 picoos_uint8 picoos_emGetNumOfWarnings(picoos_ExceptionManager this)
@@ -885,11 +1525,13 @@ pico_status_t picoos_emGetWarningCode(picoos_ExceptionManager this, picoos_uint8
 
 void picoos_emGetWarningMessage(picoos_ExceptionManager this, picoos_uint8 index, picoos_char * msg, picoos_uint16 maxsize)
 {
+        picoos_lockMutex(this->lock);
         if (index < this->curNumWarnings) {
             picoos_strlcpy(msg,this->curWarningMessage[index],maxsize);
         } else {
             msg[0] = NULLC;
         }
+        picoos_unlockMutex(this->lock);
 }
 
 
@@ -1267,6 +1909,26 @@ picoos_uint8 picoos_CloseBinary(picoos_Common g, picoos_File * f)
 
 }
 
+/* Map the whole content of binary file 'f' read-only into memory. */
+picoos_bool picoos_MapBinary(picoos_File f, picoos_uint8 ** addr, picoos_uint32 * len)
+{
+    *addr = NULL;
+    *len = 0;
+    if ((NULL != f) && !f->write && (f->lFileLen > 0)) {
+        *addr = (picoos_uint8 *) picopal_mmap_ro(f->nf, f->lFileLen);
+        if (NULL != *addr) {
+            *len = f->lFileLen;
+        }
+    }
+    return (NULL != *addr);
+}
+
+/* Release a mapping previously obtained by picoos_MapBinary. */
+void picoos_UnmapBinary(picoos_uint8 ** addr, picoos_uint32 len)
+{
+    picopal_munmap((void **) addr, len);
+}
+
 /* **************************************************************************************/
 /* *** general routines *****/
 
@@ -1305,9 +1967,8 @@ picoos_bool picoos_GetPos(picoos_File f, picoos_uint32 * pos)
         /* if (f->bFile) {
          (*pos) =  BGetPos(f);
          } else { */
-        (*pos) =  LGetPos(f, pos);
+        return LGetPos(f, pos);
         /* } */
-        return TRUE;
     } else {
         (*pos) = 0;
         return FALSE;
@@ -2301,6 +2962,11 @@ extern void picoos_get_timer(picopal_uint32 * sec, picopal_uint32 * usec)
     picopal_get_timer(sec, usec);
 }
 
+extern picopal_uint32 picoos_get_usec(void)
+{
+    return picopal_get_usec();
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -156,14 +156,58 @@ picoos_MemoryManager picoos_newMemoryManager(
         picoos_objsize_t size,
         picoos_bool enableMemProt);
 
+/* allocation strategies of a memory manager */
+
+/* free cells are kept in a single list searched first-fit */
+#define PICOOS_MEM_FIRST_FIT        0
+/* free cells are kept in segregated lists per size class; allocation and
+   deallocation take constant time */
+#define PICOOS_MEM_SIZE_CLASSES     1
+
+/* memory is handed out in order from the start of the area, like a stack;
+   a block is only reclaimed once all blocks allocated after it have been
+   deallocated as well; meant for objects that are released as a whole
+   together with the raw memory block (e.g. the contents of an engine) */
+#define PICOOS_MEM_ARENA            2
+
+/* flag to be combined with PICOOS_MEM_FIRST_FIT or PICOOS_MEM_SIZE_CLASSES:
+   when the memory area is exhausted, further blocks are allocated from the
+   platform (picopal_mem_alloc) and chained to the area instead of failing;
+   they are released by picoos_disposeMemoryManager */
+#define PICOOS_MEM_GROW             0x10
+
+/**
+ * Same as picoos_newMemoryManager, but with the allocation strategy 'mode'
+ * (one of the PICOOS_MEM_... constants above, possibly with
+ * PICOOS_MEM_GROW). The first-fit and size class strategies coalesce
+ * adjacent free cells.
+ */
+picoos_MemoryManager picoos_newMemoryManagerEx(
+        void *raw_memory,
+        picoos_objsize_t size,
+        picoos_bool enableMemProt,
+        picoos_uint8 mode);
+
 
 
+/**
+ * Releases the blocks chained to a PICOOS_MEM_GROW memory manager and
+ * its lock; the raw memory block itself remains with the caller.
+ */
 void picoos_disposeMemoryManager(picoos_MemoryManager * mm);
 
 
 void * picoos_allocate(picoos_MemoryManager this, picoos_objsize_t byteSize);
 void picoos_deallocate(picoos_MemoryManager this, void * * adr);
 
+/**
+ * Makes all subsequent allocations and deallocations of the memory manager
+ * mutually exclusive, so that it may be shared by several threads (e.g.
+ * the system memory manager from which engines are created). Returns FALSE
+ * if the platform does not support threads or the lock cannot be allocated.
+ */
+picoos_bool picoos_enableMemLock(picoos_MemoryManager this);
+
 /* the following memory manager routines are for testing and
    debugging purposes */
 
@@ -201,6 +245,76 @@ void picoos_showMemUsage(
         picoos_bool incremental,
         picoos_bool resetIncremental);
 
+/**
+ * Returns the high-water mark of the memory manager: the size of the raw
+ * memory block, counted from the start passed to picoos_newMemoryManager,
+ * that would have sufficed for all allocations so far. With
+ * PICOOS_MEM_FIRST_FIT the same sequence of allocations and deallocations
+ * succeeds in a block of exactly that size; with PICOOS_MEM_SIZE_CLASSES
+ * it is an estimate. Blocks chained because of PICOOS_MEM_GROW are added
+ * with their full size.
+ */
+picoos_objsize_t picoos_getMemHighWater(picoos_MemoryManager this);
+
+/**
+ * Returns the fragmentation of the free memory: the total number of free
+ * bytes, the size of the largest free cell (the largest block that may
+ * still be allocated is somewhat smaller because of the cell header) and
+ * the number of free cells. For PICOOS_MEM_ARENA, deallocated blocks that
+ * are not yet reclaimed do not count as free.
+ */
+void picoos_getMemFragmentation(
+        picoos_MemoryManager this,
+        picoos_int32 *freeBytes,
+        picoos_int32 *largestFreeBytes,
+        picoos_int32 *numFreeCells);
+
+/* *****************************************************************/
+/* Mutual Exclusion                                                */
+/* *****************************************************************/
+
+typedef picopal_Mutex picoos_Mutex;
+
+/* returns NULL if out of memory or if the platform does not support
+   threads; locking and unlocking a NULL mutex has no effect */
+picoos_Mutex picoos_newMutex(picoos_MemoryManager mm);
+
+void picoos_disposeMutex(picoos_MemoryManager mm, picoos_Mutex * this);
+
+void picoos_lockMutex(picoos_Mutex this);
+
+void picoos_unlockMutex(picoos_Mutex this);
+
+typedef picopal_Cond picoos_Cond;
+
+/* returns NULL if out of memory or if the platform does not support
+   threads; waiting on a NULL condition returns immediately */
+picoos_Cond picoos_newCond(picoos_MemoryManager mm);
+
+void picoos_disposeCond(picoos_MemoryManager mm, picoos_Cond * this);
+
+/* atomically releases 'mutex' and waits until 'this' is signalled;
+   'mutex' is locked again on return */
+void picoos_waitCond(picoos_Cond this, picoos_Mutex mutex);
+
+/* wakes up all threads waiting on 'this' */
+void picoos_signalCond(picoos_Cond this);
+
+/* *****************************************************************/
+/* Threads                                                         */
+/* *****************************************************************/
+
+typedef picopal_Thread picoos_Thread;
+
+typedef picopal_thread_fn picoos_thread_fn;
+
+/* starts a thread executing 'fn(arg)'; returns NULL if out of memory or if
+   the platform does not support threads */
+picoos_Thread picoos_startThread(picoos_MemoryManager mm, picoos_thread_fn fn, void * arg);
+
+/* waits for the termination of the thread and releases its handle */
+void picoos_joinThread(picoos_MemoryManager mm, picoos_Thread * this);
+
 /* *****************************************************************/
 /* Exception Management                                                */
 /* *****************************************************************/
@@ -226,6 +340,14 @@ void picoos_disposeExceptionManager(picoos_MemoryManager mm,
 
 void picoos_emReset(picoos_ExceptionManager this);
 
+/**
+ * Makes raising, resetting and querying exceptions and warnings mutually
+ * exclusive, so that the exception manager may be shared by several threads.
+ * Returns FALSE if the platform does not support threads or the lock cannot
+ * be allocated.
+ */
+picoos_bool picoos_emEnableLock(picoos_ExceptionManager this, picoos_MemoryManager mm);
+
 /* For convenience, this function returns the resulting exception code of 'this'
  * (as would be returned by emGetExceptionCode).
  * The return value therefore is NOT the status of raising
@@ -299,6 +421,16 @@ picoos_uint8  picoos_WriteBytes(picoos_File f, const picoos_char bytes[],
 /* Close previously opened binary file. */
 picoos_uint8 picoos_CloseBinary(picoos_Common g, picoos_File * f);
 
+/* Map the whole content of binary file 'f' read-only into memory. On
+ success, 'addr' returns the start of the mapping and 'len' its length
+ in bytes. The mapping is shared among processes and survives closing
+ 'f'; it must be released with 'UnmapBinary'. Returns FALSE if mapping
+ is not supported on the current platform. */
+picoos_bool picoos_MapBinary(picoos_File f, picoos_uint8 ** addr, picoos_uint32 * len);
+
+/* Release a mapping previously obtained by 'MapBinary'. */
+void picoos_UnmapBinary(picoos_uint8 ** addr, picoos_uint32 len);
+
 
 
 
@@ -542,6 +674,8 @@ pico_status_t picoos_write_mem_pi_uint16 (picoos_uint8 * data, picoos_uint32 * p
 
 void picoos_get_timer(picopal_uint32 * sec, picopal_uint32 * usec);
 
+picopal_uint32 picoos_get_usec(void);
+
 #ifdef __cplusplus
 }
 #endif
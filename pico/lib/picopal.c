@@ -89,6 +89,10 @@ extern "C" {
 #include <time.h>
 #if PICO_PLATFORM == PICO_Windows
 #include <windows.h>
+#include <io.h>
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+#include <sys/mman.h>
+#include <pthread.h>
 #endif
 
 #if defined(PRAGMA_MESSAGE)
@@ -400,6 +404,286 @@ picopal_objsize_t picopal_fread_bytes (picopal_File f, void * ptr, picopal_objsi
 }
 
 picopal_objsize_t picopal_fwrite_bytes (picopal_File f, void * ptr, picopal_objsize_t objsize, picopal_uint32 nobj){    return (picopal_objsize_t) fwrite(ptr, objsize, nobj, (FILE *)f);}
+
+/* *************************************************/
+/* dynamic memory                                  */
+/* *************************************************/
+
+void * picopal_mem_alloc (picopal_objsize_t size)
+{
+    return malloc(size);
+}
+
+void picopal_mem_free (void ** p)
+{
+    free(*p);
+    *p = NULL;
+}
+
+/* *************************************************/
+/* memory mapped files                             */
+/* *************************************************/
+
+void * picopal_mmap_ro (picopal_File f, picopal_objsize_t len)
+{
+#if PICO_PLATFORM == PICO_Windows
+    HANDLE hMap;
+    void * addr;
+
+    hMap = CreateFileMapping((HANDLE) _get_osfhandle(_fileno((FILE *)f)),
+            NULL, PAGE_READONLY, 0, 0, NULL);
+    if (NULL == hMap) {
+        return NULL;
+    }
+    addr = MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, len);
+    /* the view keeps a reference on the mapping object */
+    CloseHandle(hMap);
+    return addr;
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+    void * addr;
+
+    if (0 == len) {
+        return NULL;
+    }
+    addr = mmap(NULL, len, PROT_READ, MAP_SHARED, fileno((FILE *)f), 0);
+    return (MAP_FAILED == addr) ? NULL : addr;
+#else
+    /* not supported; callers fall back to reading the file */
+    f = f;            /* avoid warning "var not used in this function"*/
+    len = len;        /* avoid warning "var not used in this function"*/
+    return NULL;
+#endif
+}
+
+void picopal_munmap (void ** addr, picopal_objsize_t len)
+{
+    if (NULL != *addr) {
+#if PICO_PLATFORM == PICO_Windows
+        UnmapViewOfFile(*addr);
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+        munmap(*addr, len);
+#endif
+    }
+    len = len;        /* avoid warning "var not used in this function"*/
+    *addr = NULL;
+}
+
+/* *************************************************/
+/* thread synchronization                          */
+/* *************************************************/
+
+#if PICO_PLATFORM == PICO_Windows
+struct picopal_mutex {
+    CRITICAL_SECTION cs;
+};
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+struct picopal_mutex {
+    pthread_mutex_t m;
+};
+#endif
+
+picopal_objsize_t picopal_mutex_size (void)
+{
+#if (PICO_PLATFORM == PICO_Windows) || (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+    return sizeof(struct picopal_mutex);
+#else
+    return 0;
+#endif
+}
+
+picopal_Mutex picopal_mutex_init (void * mem)
+{
+    picopal_Mutex m = (picopal_Mutex) mem;
+    if (NULL == m) {
+        return NULL;
+    }
+#if PICO_PLATFORM == PICO_Windows
+    InitializeCriticalSection(&m->cs);
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+    if (0 != pthread_mutex_init(&m->m, NULL)) {
+        m = NULL;
+    }
+#else
+    m = NULL;
+#endif
+    return m;
+}
+
+void picopal_mutex_destroy (picopal_Mutex m)
+{
+    if (NULL != m) {
+#if PICO_PLATFORM == PICO_Windows
+        DeleteCriticalSection(&m->cs);
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+        pthread_mutex_destroy(&m->m);
+#endif
+    }
+}
+
+void picopal_mutex_lock (picopal_Mutex m)
+{
+    if (NULL != m) {
+#if PICO_PLATFORM == PICO_Windows
+        EnterCriticalSection(&m->cs);
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+        pthread_mutex_lock(&m->m);
+#endif
+    }
+}
+
+void picopal_mutex_unlock (picopal_Mutex m)
+{
+    if (NULL != m) {
+#if PICO_PLATFORM == PICO_Windows
+        LeaveCriticalSection(&m->cs);
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+        pthread_mutex_unlock(&m->m);
+#endif
+    }
+}
+
+#if PICO_PLATFORM == PICO_Windows
+struct picopal_cond {
+    CONDITION_VARIABLE cv;
+};
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+struct picopal_cond {
+    pthread_cond_t c;
+};
+#endif
+
+picopal_objsize_t picopal_cond_size (void)
+{
+#if (PICO_PLATFORM == PICO_Windows) || (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+    return sizeof(struct picopal_cond);
+#else
+    return 0;
+#endif
+}
+
+picopal_Cond picopal_cond_init (void * mem)
+{
+    picopal_Cond c = (picopal_Cond) mem;
+    if (NULL == c) {
+        return NULL;
+    }
+#if PICO_PLATFORM == PICO_Windows
+    InitializeConditionVariable(&c->cv);
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+    if (0 != pthread_cond_init(&c->c, NULL)) {
+        c = NULL;
+    }
+#else
+    c = NULL;
+#endif
+    return c;
+}
+
+void picopal_cond_destroy (picopal_Cond c)
+{
+    if (NULL != c) {
+#if (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+        pthread_cond_destroy(&c->c);
+#endif
+    }
+}
+
+void picopal_cond_wait (picopal_Cond c, picopal_Mutex m)
+{
+    if ((NULL != c) && (NULL != m)) {
+#if PICO_PLATFORM == PICO_Windows
+        SleepConditionVariableCS(&c->cv, &m->cs, INFINITE);
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+        pthread_cond_wait(&c->c, &m->m);
+#endif
+    }
+}
+
+void picopal_cond_broadcast (picopal_Cond c)
+{
+    if (NULL != c) {
+#if PICO_PLATFORM == PICO_Windows
+        WakeAllConditionVariable(&c->cv);
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+        pthread_cond_broadcast(&c->c);
+#endif
+    }
+}
+
+#if PICO_PLATFORM == PICO_Windows
+struct picopal_thread {
+    HANDLE h;
+    picopal_thread_fn fn;
+    void * arg;
+};
+
+static DWORD WINAPI picopal_thread_main (LPVOID t)
+{
+    ((picopal_Thread) t)->fn(((picopal_Thread) t)->arg);
+    return 0;
+}
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+struct picopal_thread {
+    pthread_t t;
+    picopal_thread_fn fn;
+    void * arg;
+};
+
+static void * picopal_thread_main (void * t)
+{
+    ((picopal_Thread) t)->fn(((picopal_Thread) t)->arg);
+    return NULL;
+}
+#endif
+
+picopal_objsize_t picopal_thread_size (void)
+{
+#if (PICO_PLATFORM == PICO_Windows) || (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+    return sizeof(struct picopal_thread);
+#else
+    return 0;
+#endif
+}
+
+picopal_Thread picopal_thread_start (void * mem, picopal_thread_fn fn, void * arg)
+{
+    picopal_Thread t = (picopal_Thread) mem;
+    if (NULL == t) {
+        return NULL;
+    }
+#if (PICO_PLATFORM == PICO_Windows) || (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+    t->fn = fn;
+    t->arg = arg;
+#endif
+#if PICO_PLATFORM == PICO_Windows
+    t->h = CreateThread(NULL, 0, picopal_thread_main, t, 0, NULL);
+    if (NULL == t->h) {
+        t = NULL;
+    }
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+    if (0 != pthread_create(&t->t, NULL, picopal_thread_main, t)) {
+        t = NULL;
+    }
+#else
+    fn = fn;        /* avoid warning "var not used in this function"*/
+    arg = arg;      /* avoid warning "var not used in this function"*/
+    t = NULL;
+#endif
+    return t;
+}
+
+void picopal_thread_join (picopal_Thread t)
+{
+    if (NULL != t) {
+#if PICO_PLATFORM == PICO_Windows
+        WaitForSingleObject(t->h, INFINITE);
+        CloseHandle(t->h);
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+        pthread_join(t->t, NULL);
+#endif
+    }
+}
+
 /* *************************************************/
 /* functions for debugging/testing purposes only   */
 /* *************************************************/
@@ -547,6 +831,25 @@ void picopal_get_timer(picopal_uint32 * sec, picopal_uint32 * usec)
 #endif /* IMPLEMENT_TIMER */
 }
 
+picopal_uint32 picopal_get_usec(void)
+{
+#if PICO_PLATFORM == PICO_Windows
+    LARGE_INTEGER now, freq;
+    if (QueryPerformanceFrequency(&freq) && QueryPerformanceCounter(&now)) {
+        return (picopal_uint32) ((now.QuadPart / freq.QuadPart) * 1000000
+                + ((now.QuadPart % freq.QuadPart) * 1000000) / freq.QuadPart);
+    }
+    return (picopal_uint32) GetTickCount() * 1000;
+#elif (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (picopal_uint32) now.tv_sec * 1000000 + (picopal_uint32) (now.tv_nsec / 1000);
+#else
+    /* processor time only */
+    return (picopal_uint32) (((double) clock() * 1000000.0) / CLOCKS_PER_SEC);
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
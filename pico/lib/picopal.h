@@ -243,6 +243,120 @@ extern pico_status_t picopal_rename (picopal_char oldname[], picopal_char newnam
 
 */
 
+/* *************************************************/
+/* dynamic memory                                  */
+/* *************************************************/
+
+/**
+ * Allocates 'size' bytes from the heap of the platform, suitably aligned
+ * for any type. Only used to grow memory managers beyond the memory area
+ * provided by the application. Returns NULL if no memory is available.
+ */
+extern void * picopal_mem_alloc (picopal_objsize_t size);
+
+/**
+ * Releases memory previously allocated by picopal_mem_alloc().
+ */
+extern void picopal_mem_free (void ** p);
+
+/* *************************************************/
+/* memory mapped files                             */
+/* *************************************************/
+
+/**
+ * Maps the first 'len' bytes of the open file 'f' read-only into memory.
+ * The mapping is shared, i.e. all processes mapping the same file use the
+ * same physical pages. Returns NULL if mapping is not supported on the
+ * current platform or failed. The mapping stays valid after 'f' is closed.
+ */
+extern void * picopal_mmap_ro (picopal_File f, picopal_objsize_t len);
+
+/**
+ * Releases a mapping of 'len' bytes previously created by picopal_mmap_ro().
+ */
+extern void picopal_munmap (void ** addr, picopal_objsize_t len);
+
+/* *************************************************/
+/* thread synchronization                          */
+/* *************************************************/
+
+typedef struct picopal_mutex * picopal_Mutex;
+
+/**
+ * Returns the number of bytes needed to hold a mutex, or 0 if the current
+ * platform does not support threads.
+ */
+extern picopal_objsize_t picopal_mutex_size (void);
+
+/**
+ * Initializes a mutex in the picopal_mutex_size() bytes at 'mem' and returns
+ * its handle, or NULL if the current platform does not support threads.
+ * Locking and unlocking a NULL mutex has no effect.
+ */
+extern picopal_Mutex picopal_mutex_init (void * mem);
+
+extern void picopal_mutex_destroy (picopal_Mutex m);
+
+extern void picopal_mutex_lock (picopal_Mutex m);
+
+extern void picopal_mutex_unlock (picopal_Mutex m);
+
+typedef struct picopal_cond * picopal_Cond;
+
+/**
+ * Condition variables, used together with a mutex. Size and initialization
+ * follow the same rules as for mutexes; waiting on a NULL condition returns
+ * immediately. picopal_cond_broadcast() wakes up all waiting threads.
+ */
+extern picopal_objsize_t picopal_cond_size (void);
+
+extern picopal_Cond picopal_cond_init (void * mem);
+
+extern void picopal_cond_destroy (picopal_Cond c);
+
+extern void picopal_cond_wait (picopal_Cond c, picopal_Mutex m);
+
+extern void picopal_cond_broadcast (picopal_Cond c);
+
+typedef struct picopal_thread * picopal_Thread;
+
+typedef void (* picopal_thread_fn) (void * arg);
+
+/**
+ * Starts a thread executing 'fn(arg)', using the picopal_thread_size() bytes
+ * at 'mem' for bookkeeping. Returns NULL if the thread could not be started
+ * or the current platform does not support threads.
+ */
+extern picopal_objsize_t picopal_thread_size (void);
+
+extern picopal_Thread picopal_thread_start (void * mem, picopal_thread_fn fn, void * arg);
+
+/**
+ * Waits for the termination of a thread started by picopal_thread_start().
+ */
+extern void picopal_thread_join (picopal_Thread t);
+
+/* atomic access to 32 bit counters shared between two threads: a value
+   stored with picopal_atomic_store() makes all writes preceding it visible
+   to the thread reading that value with picopal_atomic_load().
+   PICOPAL_HAVE_ATOMICS is 0 where the compiler offers no such guarantee;
+   the volatile accesses used then are only safe within a single thread,
+   or for flags whose late visibility does no harm */
+#if defined(__GNUC__)
+#define PICOPAL_HAVE_ATOMICS 1
+#define picopal_atomic_load(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define picopal_atomic_store(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#elif defined(_MSC_VER)
+#define PICOPAL_HAVE_ATOMICS 1
+/* volatile accesses have acquire/release semantics with MSVC */
+#define picopal_atomic_load(p) (*(volatile picopal_uint32 *)(p))
+#define picopal_atomic_store(p, v) (*(volatile picopal_uint32 *)(p) = (v))
+#else
+#define PICOPAL_HAVE_ATOMICS 0
+#define picopal_atomic_load(p) (*(volatile picopal_uint32 *)(p))
+#define picopal_atomic_store(p, v) (*(volatile picopal_uint32 *)(p) = (v))
+#endif
+
 /* *************************************************/
 /* functions for debugging/testing purposes only   */
 /* *************************************************/
@@ -281,6 +395,10 @@ picopal_double picopal_quick_exp(const picopal_double y);
 
 extern void picopal_get_timer(picopal_uint32 * sec, picopal_uint32 * usec);
 
+/* returns a monotonic wall clock time in microseconds; wraps around after
+   about 71 minutes, so only differences of near times are meaningful */
+extern picopal_uint32 picopal_get_usec(void);
+
 #ifdef __cplusplus
 }
 #endif
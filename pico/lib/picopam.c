@@ -469,12 +469,20 @@ static pico_status_t pam_allocate(picoos_MemoryManager mm, pam_subobj_t *pam)
 {
     picoos_uint8 *data;
     picoos_int16 *dataI;
+    picoos_uint8 i;
 
     pam->sSyllFeats = NULL;
     pam->sPhIds = NULL;
     pam->sPhFeats = NULL;
     pam->sSyllItems = NULL;
     pam->sSyllItemOffs = NULL;
+    pam->dtdur = NULL;
+    for (i = 0; i < PICOPAM_DT_NRLFZ; i++) {
+        pam->dtlfz[i] = NULL;
+    }
+    for (i = 0; i < PICOPAM_DT_NRMGC; i++) {
+        pam->dtmgc[i] = NULL;
+    }
 
     /*-----------------------------------------------------------------
      * PAM Local buffers ALLOCATION
@@ -621,8 +629,8 @@ static pico_status_t pam_initialize(register picodata_ProcessingUnit this, picoo
         { 1, 1, 1, 1, 1 } /*DEFAULT*/
         };
         for (i = 0; i < PICOPAM_PWIDX_SIZE; i++) {
-            for (j = 0; j < PICOPAM_PWIDX_SIZE; j++) {
-                pam->sil_weights[j][j] = tmp_weights[i][j];
+            for (j = 0; j < PICOPAM_MAX_STATES_PER_PHONE; j++) {
+                pam->sil_weights[i][j] = tmp_weights[i][j];
             }
         }
     }
@@ -631,8 +639,11 @@ static pico_status_t pam_initialize(register picodata_ProcessingUnit this, picoo
 /*-----------------------------------------------------------------
      * MANAGE LINGWARE INITIALIZATION IF NEEDED
      ------------------------------------------------------------------*/
-    /* kb dtdur */
-    pam->dtdur = picokdt_getDtPAM(this->voice->kbArray[PICOKNOW_KBID_DT_DUR]);
+    /* kb dtdur (private copies of all trees, the kbs may be shared with other engines) */
+    if (pam->dtdur == NULL) {
+        pam->dtdur = picokdt_newDtPAM(this->common->mm,
+                this->voice->kbArray[PICOKNOW_KBID_DT_DUR]);
+    }
     if (pam->dtdur == NULL) {
         picoos_emRaiseException(this->common->em, PICO_EXC_KB_MISSING, NULL,
                 NULL);
@@ -640,17 +651,11 @@ static pico_status_t pam_initialize(register picodata_ProcessingUnit this, picoo
     }PICODBG_DEBUG(("got dtdur"));
 
     /* kb dtlfz* */
-    pam->dtlfz[0] = picokdt_getDtPAM(
-            this->voice->kbArray[PICOKNOW_KBID_DT_LFZ1]);
-    pam->dtlfz[1] = picokdt_getDtPAM(
-            this->voice->kbArray[PICOKNOW_KBID_DT_LFZ2]);
-    pam->dtlfz[2] = picokdt_getDtPAM(
-            this->voice->kbArray[PICOKNOW_KBID_DT_LFZ3]);
-    pam->dtlfz[3] = picokdt_getDtPAM(
-            this->voice->kbArray[PICOKNOW_KBID_DT_LFZ4]);
-    pam->dtlfz[4] = picokdt_getDtPAM(
-            this->voice->kbArray[PICOKNOW_KBID_DT_LFZ5]);
     for (nI = 0; nI < PICOPAM_DT_NRLFZ; nI++) {
+        if (pam->dtlfz[nI] == NULL) {
+            pam->dtlfz[nI] = picokdt_newDtPAM(this->common->mm,
+                    this->voice->kbArray[PICOKNOW_KBID_DT_LFZ1 + nI]);
+        }
         if (pam->dtlfz[nI] == NULL) {
             picoos_emRaiseException(this->common->em, PICO_EXC_KB_MISSING,
                     NULL, NULL);
@@ -659,17 +664,11 @@ static pico_status_t pam_initialize(register picodata_ProcessingUnit this, picoo
     }
 
     /* kb dtmgc* */
-    pam->dtmgc[0] = picokdt_getDtPAM(
-            this->voice->kbArray[PICOKNOW_KBID_DT_MGC1]);
-    pam->dtmgc[1] = picokdt_getDtPAM(
-            this->voice->kbArray[PICOKNOW_KBID_DT_MGC2]);
-    pam->dtmgc[2] = picokdt_getDtPAM(
-            this->voice->kbArray[PICOKNOW_KBID_DT_MGC3]);
-    pam->dtmgc[3] = picokdt_getDtPAM(
-            this->voice->kbArray[PICOKNOW_KBID_DT_MGC4]);
-    pam->dtmgc[4] = picokdt_getDtPAM(
-            this->voice->kbArray[PICOKNOW_KBID_DT_MGC5]);
     for (nI = 0; nI < PICOPAM_DT_NRMGC; nI++) {
+        if (pam->dtmgc[nI] == NULL) {
+            pam->dtmgc[nI] = picokdt_newDtPAM(this->common->mm,
+                    this->voice->kbArray[PICOKNOW_KBID_DT_MGC1 + nI]);
+        }
         if (pam->dtmgc[nI] == NULL) {
             picoos_emRaiseException(this->common->em, PICO_EXC_KB_MISSING,
                     NULL, NULL);
@@ -740,6 +739,7 @@ static pico_status_t pam_subobj_deallocate(register picodata_ProcessingUnit this
 {
 
     pam_subobj_t* pam;
+    picoos_uint8 nI;
 
     if (NULL != this) {
         pam = (pam_subobj_t *) this->subObj;
@@ -762,6 +762,13 @@ static pico_status_t pam_subobj_deallocate(register picodata_ProcessingUnit this
         if (pam->sSyllItemOffs != NULL) {
             picoos_deallocate(this->common->mm, (void *) &pam->sSyllItemOffs);
         }
+        picokdt_disposeDt(this->common->mm, (void *) &pam->dtdur);
+        for (nI = 0; nI < PICOPAM_DT_NRLFZ; nI++) {
+            picokdt_disposeDt(this->common->mm, (void *) &pam->dtlfz[nI]);
+        }
+        for (nI = 0; nI < PICOPAM_DT_NRMGC; nI++) {
+            picokdt_disposeDt(this->common->mm, (void *) &pam->dtmgc[nI]);
+        }
         picoos_deallocate(this->common->mm, (void *) &this->subObj);
     }
 
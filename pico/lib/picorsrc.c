@@ -66,6 +66,8 @@ typedef struct picorsrc_resource {
     picoos_int8 lockCount;  /* count of current subscribers of this resource */
     picoos_File file;
     picoos_uint8 * raw_mem; /* pointer to allocated memory. NULL if preallocated. */
+    picoos_uint8 * map_mem; /* pointer to read-only file mapping. NULL if not mapped. */
+    picoos_uint32 map_len;  /* length of file mapping */
     /* picoos_uint32 size; */
     picoos_uint8 * start; /* start of content (after header) */
     picoknow_KnowledgeBase kbList;
@@ -104,6 +106,8 @@ static picorsrc_Resource picorsrc_newResource(picoos_MemoryManager mm)
         this->lockCount = 0;
         this->file = NULL;
         this->raw_mem = NULL;
+        this->map_mem = NULL;
+        this->map_len = 0;
         this->start = NULL;
         this->kbList = NULL;
         /* this->size=0; */
@@ -121,6 +125,9 @@ static void picorsrc_disposeResource(picoos_MemoryManager mm, picorsrc_Resource
         if ((*this)->raw_mem != NULL) {
             picoos_deallocProtMem(mm, (void *) &(*this)->raw_mem);
         }
+        if ((*this)->map_mem != NULL) {
+            picoos_UnmapBinary(&(*this)->map_mem, (*this)->map_len);
+        }
         picoos_deallocate(mm,(void * *)this);
     }
 }
@@ -137,6 +144,7 @@ static void picorsrc_initializeVoice(picorsrc_Voice this)
           this->kbArray[i] = NULL;
         }
         this->numResources = 0;
+        this->refCount = 0;
         this->next = NULL;
     }
 }
@@ -170,6 +178,7 @@ typedef struct picorsrc_voice_definition {
     picoos_char voiceName[PICO_MAX_VOICE_NAME_SIZE];
     picoos_uint8 numResources;
     picorsrc_resource_name_t resourceName[PICO_MAX_NUM_RSRC_PER_VOICE];
+    picorsrc_Voice voice; /* voice shared by all engines created for this definition */
     picorsrc_VoiceDefinition next;
 } picorsrc_voice_definition_t;
 
@@ -182,6 +191,7 @@ static picorsrc_VoiceDefinition picorsrc_newVoiceDefinition(picoos_MemoryManager
         /* initialize */
         this->voiceName[0] = NULLC;
         this->numResources = 0;
+        this->voice = NULL;
         /*
         for (i=0; i < PICO_MAX_NUM_RSRC_PER_VOICE; i++) {
             this->resourceName[i][0] = NULLC;
@@ -219,6 +229,7 @@ typedef struct picorsrc_resource_manager {
     picoos_uint16 numKbs;
     picoknow_KnowledgeBase freeKbs;
     picoos_header_string_t tmpHeader;
+    picoos_Mutex lock; /* serializes all operations on the lists above */
 } picorsrc_resource_manager_t;
 
 pico_status_t picorsrc_createDefaultResource(picorsrc_ResourceManager this /*,
@@ -240,6 +251,8 @@ picorsrc_ResourceManager picorsrc_newResourceManager(picoos_MemoryManager mm, pi
         this->numVdefs = 0;
         this->vdefs = NULL;
         this->freeVdefs = NULL;
+        /* NULL on platforms without threads */
+        this->lock = picoos_newMutex(mm);
     }
     return this;
 }
@@ -248,6 +261,7 @@ void picorsrc_disposeResourceManager(picoos_MemoryManager mm, picorsrc_ResourceM
 {
     if (NULL != (*this)) {
         /* terminate */
+        picoos_disposeMutex(mm, &(*this)->lock);
         picoos_deallocate(mm,(void *)this);
     }
 }
@@ -530,11 +544,36 @@ static pico_status_t picorsrc_getKbList(picorsrc_ResourceManager this,
 
 }
 
+/* maps the resource content of 'len' bytes, starting at the current position of res->file,
+ * read-only into memory. returns FALSE if the file cannot be mapped. the content starts at
+ * the offset left by the variable length header; this is fine, since the knowledge bases
+ * read their data byte by byte */
+static picoos_bool picorsrc_mapResource(picorsrc_Resource res, picoos_uint32 len)
+{
+    picoos_uint32 pos;
+
+    if (!picoos_GetPos(res->file, &pos)) {
+        return FALSE;
+    }
+    if (!picoos_MapBinary(res->file, &res->map_mem, &res->map_len)) {
+        return FALSE;
+    }
+    if (pos + len > res->map_len) {
+        /* truncated file; let the copying path report the error */
+        picoos_UnmapBinary(&res->map_mem, res->map_len);
+        return FALSE;
+    }
+    res->start = res->map_mem + pos;
+    return TRUE;
+}
+
 /* load resource file. the type of resource file etc. are in the header,
- * then follows the directory, then the knowledge bases themselves (as byte streams) */
+ * then follows the directory, then the knowledge bases themselves (as byte streams).
+ * with PICO_LOAD_MAP, the knowledge bases are built directly on a read-only mapping
+ * of the file instead of a copy in the system memory area */
 
-pico_status_t picorsrc_loadResource(picorsrc_ResourceManager this,
-        picoos_char * fileName, picorsrc_Resource * resource)
+static pico_status_t loadResource(picorsrc_ResourceManager this,
+        picoos_char * fileName, picoos_int32 loadMode, picorsrc_Resource * resource)
 {
     picorsrc_Resource res;
     picoos_uint32 headerlen, len,maxlen;
@@ -594,15 +633,24 @@ pico_status_t picorsrc_loadResource(picorsrc_ResourceManager this,
             /* get data length */
         status = picoos_read_pi_uint32(res->file, &len);
         PICODBG_DEBUG(("found net resource len of %i",len));
+        if ((PICO_OK == status) && (PICO_LOAD_MAP == loadMode)) {
+            if (picorsrc_mapResource(res, len)) {
+                PICODBG_DEBUG(("mapped resource content at %p", res->start));
+            } else {
+                PICODBG_WARN(("cannot map %s, loading it into memory", fileName));
+                picoos_emRaiseWarning(this->common->em, PICO_WARN_FALLBACK, NULL,
+                        (picoos_char *) "cannot map %s", fileName);
+            }
+        }
         /* allocate memory */
-        if (PICO_OK == status) {
+        if ((PICO_OK == status) && (NULL == res->map_mem)) {
             PICODBG_TRACE((">>> 2"));
             maxlen = len + PICOOS_ALIGN_SIZE; /* once would be sufficient? */
             res->raw_mem = picoos_allocProtMem(this->common->mm, maxlen);
             /* res->size = maxlen; */
             status = (NULL == res->raw_mem) ? PICO_EXC_OUT_OF_MEM : PICO_OK;
         }
-        if (PICO_OK == status) {
+        if ((PICO_OK == status) && (NULL == res->map_mem)) {
             rem = (uintptr_t) res->raw_mem % PICOOS_ALIGN_SIZE;
             if (rem > 0) {
                 res->start = res->raw_mem + (PICOOS_ALIGN_SIZE - rem);
@@ -617,6 +665,10 @@ pico_status_t picorsrc_loadResource(picorsrc_ResourceManager this,
              has an effect in test configurations only */
             picoos_protectMem(this->common->mm, res->start, len, /*enable*/TRUE);
         }
+        if ((PICO_OK == status) && (NULL != res->map_mem)) {
+            /* the mapping stays valid after the file is closed */
+            picoos_CloseBinary(this->common, &res->file);
+        }
         /* note resource unique name */
         if (PICO_OK == status) {
             if (picoos_strlcpy(res->name,header.field[PICOOS_HEADER_NAME].value,PICORSRC_MAX_RSRC_NAME_SIZ) < PICORSRC_MAX_RSRC_NAME_SIZ) {
@@ -672,6 +724,20 @@ pico_status_t picorsrc_loadResource(picorsrc_ResourceManager this,
     }
 }
 
+pico_status_t picorsrc_loadResource(picorsrc_ResourceManager this,
+        picoos_char * fileName, picoos_int32 loadMode, picorsrc_Resource * resource)
+{
+    pico_status_t status;
+
+    if (NULL == this) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+    picoos_lockMutex(this->lock);
+    status = loadResource(this, fileName, loadMode, resource);
+    picoos_unlockMutex(this->lock);
+    return status;
+}
+
 static pico_status_t picorsrc_releaseKbList(picorsrc_ResourceManager this, picoknow_KnowledgeBase * kbList)
 {
     picoknow_KnowledgeBase kbprev, kb;
@@ -686,7 +752,7 @@ static pico_status_t picorsrc_releaseKbList(picorsrc_ResourceManager this, picok
 }
 
 /* unload resource file. (if resource file is busy, warn and don't unload) */
-pico_status_t picorsrc_unloadResource(picorsrc_ResourceManager this, picorsrc_Resource * resource) {
+static pico_status_t unloadResource(picorsrc_ResourceManager this, picorsrc_Resource * resource) {
 
     picorsrc_Resource r1, r2, rsrc;
 
@@ -707,6 +773,10 @@ pico_status_t picorsrc_unloadResource(picorsrc_ResourceManager this, picorsrc_Re
         picoos_deallocProtMem(this->common->mm, (void *) &rsrc->raw_mem);
         PICODBG_DEBUG(("deallocated raw mem"));
     }
+    if (NULL != rsrc->map_mem) {
+        picoos_UnmapBinary(&rsrc->map_mem, rsrc->map_len);
+        PICODBG_DEBUG(("unmapped resource file"));
+    }
 
     r1 = NULL;
     r2 = this->resources;
@@ -733,6 +803,18 @@ pico_status_t picorsrc_unloadResource(picorsrc_ResourceManager this, picorsrc_Re
     return PICO_OK;
 }
 
+pico_status_t picorsrc_unloadResource(picorsrc_ResourceManager this, picorsrc_Resource * resource) {
+    pico_status_t status;
+
+    if (NULL == this) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+    picoos_lockMutex(this->lock);
+    status = unloadResource(this, resource);
+    picoos_unlockMutex(this->lock);
+    return status;
+}
+
 
 pico_status_t picorsrc_createDefaultResource(picorsrc_ResourceManager this
         /*, picorsrc_Resource * resource */)
@@ -811,7 +893,7 @@ static pico_status_t findVoiceDefinition(picorsrc_ResourceManager this,
 }
 
 
-pico_status_t picorsrc_addResourceToVoiceDefinition(picorsrc_ResourceManager this,
+static pico_status_t addResourceToVoiceDefinition(picorsrc_ResourceManager this,
         picoos_char * voiceName, picoos_char * resourceName)
 {
     picorsrc_VoiceDefinition vdef;
@@ -821,6 +903,8 @@ pico_status_t picorsrc_addResourceToVoiceDefinition(picorsrc_ResourceManager thi
         return PICO_ERR_NULLPTR_ACCESS;
     }
     if ((PICO_OK == findVoiceDefinition(this,voiceName,&vdef)) && (NULL != vdef)) {
+        /* engines created from now on get a new voice; existing engines keep theirs */
+        vdef->voice = NULL;
         if (PICO_MAX_NUM_RSRC_PER_VOICE <= vdef->numResources) {
             return picoos_emRaiseException(this->common->em,PICO_EXC_MAX_NUM_EXCEED,NULL,(picoos_char *)"no more than %i resources per voice",PICO_MAX_NUM_RSRC_PER_VOICE);
         }
@@ -838,8 +922,23 @@ pico_status_t picorsrc_addResourceToVoiceDefinition(picorsrc_ResourceManager thi
     }
 }
 
+pico_status_t picorsrc_addResourceToVoiceDefinition(picorsrc_ResourceManager this,
+        picoos_char * voiceName, picoos_char * resourceName)
+{
+    pico_status_t status;
+
+    if (NULL == this) {
+        PICODBG_ERROR(("this is NULL"));
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+    picoos_lockMutex(this->lock);
+    status = addResourceToVoiceDefinition(this, voiceName, resourceName);
+    picoos_unlockMutex(this->lock);
+    return status;
+}
+
 
-pico_status_t picorsrc_createVoiceDefinition(picorsrc_ResourceManager this,
+static pico_status_t createVoiceDefinition(picorsrc_ResourceManager this,
         picoos_char * voiceName)
 {
     picorsrc_VoiceDefinition vdef;
@@ -863,6 +962,7 @@ pico_status_t picorsrc_createVoiceDefinition(picorsrc_ResourceManager this,
         this->freeVdefs = vdef->next;
         vdef->voiceName[0] = NULLC;
         vdef->numResources = 0;
+        vdef->voice = NULL;
         vdef->next = NULL;
     }
     if (NULL == vdef) {
@@ -873,7 +973,7 @@ pico_status_t picorsrc_createVoiceDefinition(picorsrc_ResourceManager this,
         vdef->next = this->vdefs;
         this->vdefs = vdef;
         this->numVdefs++;
-        if (PICO_OK != picorsrc_addResourceToVoiceDefinition(this,voiceName,PICOKNOW_DEFAULT_RESOURCE_NAME)) {
+        if (PICO_OK != addResourceToVoiceDefinition(this,voiceName,PICOKNOW_DEFAULT_RESOURCE_NAME)) {
             return picoos_emRaiseException(this->common->em,PICO_ERR_OTHER,NULL,(picoos_char *)"problem loading default resource %s",voiceName);
         }
         PICODBG_DEBUG(("vdef created (%s)",voiceName));
@@ -884,6 +984,21 @@ pico_status_t picorsrc_createVoiceDefinition(picorsrc_ResourceManager this,
     }
 }
 
+pico_status_t picorsrc_createVoiceDefinition(picorsrc_ResourceManager this,
+        picoos_char * voiceName)
+{
+    pico_status_t status;
+
+    if (NULL == this) {
+        PICODBG_ERROR(("this is NULL"));
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+    picoos_lockMutex(this->lock);
+    status = createVoiceDefinition(this, voiceName);
+    picoos_unlockMutex(this->lock);
+    return status;
+}
+
 
 pico_status_t picorsrc_releaseVoiceDefinition(picorsrc_ResourceManager this,
         picoos_char *voiceName)
@@ -894,6 +1009,7 @@ pico_status_t picorsrc_releaseVoiceDefinition(picorsrc_ResourceManager this,
         return PICO_ERR_NULLPTR_ACCESS;
     }
 
+    picoos_lockMutex(this->lock);
     l = NULL;
     v = this->vdefs;
     while ((v != NULL) && (picoos_strcmp(v->voiceName, voiceName) != 0)) {
@@ -907,16 +1023,18 @@ pico_status_t picorsrc_releaseVoiceDefinition(picorsrc_ResourceManager this,
         } else {
             this->vdefs = v->next;
         }
-        /* insert v at head of freeVdefs list */
+        /* insert v at head of freeVdefs list; a shared voice stays
+           alive until the last engine using it releases it */
+        v->voice = NULL;
         v->next = this->freeVdefs;
         this->freeVdefs = v;
         this->numVdefs--;
-        return PICO_OK;
     } else {
         /* we should rather return a warning, here */
         /* return picoos_emRaiseException(this->common->em,PICO_EXC_NAME_UNDEFINED,"%s", NULL); */
-        return PICO_OK;
     }
+    picoos_unlockMutex(this->lock);
+    return PICO_OK;
 }
 
 
@@ -924,9 +1042,11 @@ pico_status_t picorsrc_releaseVoiceDefinition(picorsrc_ResourceManager this,
 /* ******* accessing voices **************************************/
 
 
-/* create voice, given a voice name. the corresponding lock counts are incremented */
+/* create voice, given a voice name. the corresponding lock counts are incremented.
+ * a voice only holds read-only references to knowledge bases, so all engines created
+ * for the same voice definition share one voice object (reference counted) */
 
-pico_status_t picorsrc_createVoice(picorsrc_ResourceManager this, const picoos_char * voiceName, picorsrc_Voice * voice) {
+static pico_status_t createVoice(picorsrc_ResourceManager this, const picoos_char * voiceName, picorsrc_Voice * voice) {
 
     picorsrc_VoiceDefinition vdef;
     picorsrc_Resource rsrc;
@@ -941,6 +1061,14 @@ pico_status_t picorsrc_createVoice(picorsrc_ResourceManager this, const picoos_c
         return PICO_ERR_NULLPTR_ACCESS;
 
     }
+    /* share voice of an engine created earlier for the same definition */
+    if ((PICO_OK == findVoiceDefinition(this,voiceName,&vdef)) && (NULL != vdef) && (NULL != vdef->voice)) {
+        *voice = vdef->voice;
+        (*voice)->refCount++;
+        PICODBG_DEBUG(("sharing voice %s (%i users)",voiceName,(*voice)->refCount));
+        return PICO_OK;
+    }
+
     /* check number of voices */
     if (PICORSRC_MAX_NUM_VOICES <= this->numVoices) {
         PICODBG_ERROR(("PICORSRC_MAX_NUM_VOICES exceeded"));
@@ -976,6 +1104,8 @@ pico_status_t picorsrc_createVoice(picorsrc_ResourceManager this, const picoos_c
         return picoos_emRaiseException(this->common->em, PICO_EXC_OUT_OF_MEM, NULL, NULL);
     }
     this->numVoices++;
+    (*voice)->refCount = 1;
+    vdef->voice = *voice;
 
     /* copy resource kb pointers into kb array of voice */
     for (i = 0; i < vdef->numResources; i++) {
@@ -1002,21 +1132,46 @@ pico_status_t picorsrc_createVoice(picorsrc_ResourceManager this, const picoos_c
     return PICO_OK;
 }
 
+pico_status_t picorsrc_createVoice(picorsrc_ResourceManager this, const picoos_char * voiceName, picorsrc_Voice * voice) {
+    pico_status_t status;
+
+    if (NULL == this) {
+        PICODBG_ERROR(("this is NULL"));
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+    picoos_lockMutex(this->lock);
+    status = createVoice(this, voiceName, voice);
+    picoos_unlockMutex(this->lock);
+    return status;
+}
+
 /* dispose voice. the corresponding lock counts are decremented. */
 
 pico_status_t picorsrc_releaseVoice(picorsrc_ResourceManager this, picorsrc_Voice * voice)
 {
     picoos_uint16 i;
+    picorsrc_VoiceDefinition vdef;
     picorsrc_Voice v = *voice;
     if (NULL == this || NULL == v) {
         return PICO_ERR_NULLPTR_ACCESS;
     }
-    for (i = 0; i < v->numResources; i++) {
-        v->resourceArray[i]->lockCount--;
+    picoos_lockMutex(this->lock);
+    v->refCount--;
+    if (v->refCount == 0) {
+        for (i = 0; i < v->numResources; i++) {
+            v->resourceArray[i]->lockCount--;
+        }
+        for (vdef = this->vdefs; NULL != vdef; vdef = vdef->next) {
+            if (vdef->voice == v) {
+                vdef->voice = NULL;
+            }
+        }
+        v->next = this->freeVoices;
+        this->freeVoices = v;
+        this->numVoices--;
     }
-    v->next = this->freeVoices;
-    this->freeVoices = v;
-    this->numVoices--;
+    picoos_unlockMutex(this->lock);
+    *voice = NULL;
 
     return PICO_OK;
 }
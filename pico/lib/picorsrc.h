@@ -112,9 +112,10 @@ void picorsrc_disposeResourceManager(picoos_MemoryManager mm, picorsrc_ResourceM
 picoos_int16 picoctrl_isValidResourceHandle(picorsrc_Resource resource);
 
 /* load resource file. the type of resource file, magic numbers, checksum etc. are in the header, then follows the directory
- * (with fixed structure per resource type), then the knowledge bases themselves (as byte streams) */
+ * (with fixed structure per resource type), then the knowledge bases themselves (as byte streams).
+ * 'loadMode' is one of PICO_LOAD_COPY, PICO_LOAD_MAP */
 pico_status_t picorsrc_loadResource(picorsrc_ResourceManager this,
-        picoos_char * fileName, picorsrc_Resource * resource);
+        picoos_char * fileName, picoos_int32 loadMode, picorsrc_Resource * resource);
 
 /* unload resource file. (warn if resource file is busy) */
 pico_status_t picorsrc_unloadResource(picorsrc_ResourceManager this, picorsrc_Resource * rsrc);
@@ -165,15 +166,19 @@ typedef struct picorsrc_voice {
 
     picorsrc_Resource resourceArray[PICO_MAX_NUM_RSRC_PER_VOICE];
 
+    picoos_uint16 refCount; /* number of engines using this voice */
 
 } picorsrc_voice_t;
 
 
 
-/* create voice, given a voice name. the corresponding lock counts are incremented */
+/* create voice, given a voice name. the corresponding lock counts are incremented.
+ * engines created for the same voice definition share the voice object.
+ * all resource manager functions may be called concurrently from different threads */
 pico_status_t picorsrc_createVoice(picorsrc_ResourceManager this, const picoos_char * voiceName, picorsrc_Voice * voice);
 
-/* dispose voice. the corresponding lock counts are decremented. */
+/* release voice. the voice is disposed and the corresponding lock counts are
+ * decremented when the last engine using it releases it. */
 pico_status_t picorsrc_releaseVoice(picorsrc_ResourceManager this, picorsrc_Voice * voice);
 
 #ifdef __cplusplus
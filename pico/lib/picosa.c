@@ -187,6 +187,12 @@ typedef struct sa_subobj {
     picoos_uint8 needsmoreitems; /* flag: need more items */
     picoos_uint8 phonesTransduced; /* flag: */
 
+    /* low latency: if > 0, the first phrase of an utterance is cut after
+       this many words */
+    picoos_uint8 firstPhraseWords;
+    picoos_uint8 inFirstPhrase;  /* flag: collecting the first phrase of an utterance */
+    picoos_uint8 nrWords;        /* words collected in the current phrase */
+
     picoos_uint8 tmpbuf[PICODATA_MAX_ITEMSIZE];  /* tmp. location for an item */
 
     picosa_headx_t headx[PICOSA_MAXNR_HEADX];
@@ -264,6 +270,8 @@ static pico_status_t saInitialize(register picodata_ProcessingUnit this, picoos_
 
     sa->inspaceok = TRUE;
     sa->needsmoreitems = TRUE;
+    sa->inFirstPhrase = TRUE;
+    sa->nrWords = 0;
 
     sa->headxBottom = 0;
     sa->headxLen = 0;
@@ -383,16 +391,22 @@ static pico_status_t saInitialize(register picodata_ProcessingUnit this, picoos_
     }
     PICODBG_DEBUG(("got tabpos"));
 
-    /* kb dtposd */
-    sa->dtposd = picokdt_getDtPosD(this->voice->kbArray[PICOKNOW_KBID_DT_POSD]);
+    /* kb dtposd (private copy, the kb may be shared with other engines) */
+    if (sa->dtposd == NULL) {
+        sa->dtposd = picokdt_newDtPosD(this->common->mm,
+                this->voice->kbArray[PICOKNOW_KBID_DT_POSD]);
+    }
     if (sa->dtposd == NULL) {
         return picoos_emRaiseException(this->common->em, PICO_EXC_KB_MISSING,
                                        NULL, NULL);
     }
     PICODBG_DEBUG(("got dtposd"));
 
-    /* kb dtg2p */
-    sa->dtg2p = picokdt_getDtG2P(this->voice->kbArray[PICOKNOW_KBID_DT_G2P]);
+    /* kb dtg2p (private copy) */
+    if (sa->dtg2p == NULL) {
+        sa->dtg2p = picokdt_newDtG2P(this->common->mm,
+                this->voice->kbArray[PICOKNOW_KBID_DT_G2P]);
+    }
     if (sa->dtg2p == NULL) {
         return picoos_emRaiseException(this->common->em, PICO_EXC_KB_MISSING,
                                        NULL, NULL);
@@ -434,6 +448,8 @@ static pico_status_t saSubObjDeallocate(register picodata_ProcessingUnit this,
     if (NULL != this) {
         sa = (sa_subobj_t *) this->subObj;
         picotrns_deallocate_alt_desc_buf(mm,&sa->altDescBuf);
+        picokdt_disposeDt(mm, (void *) &sa->dtposd);
+        picokdt_disposeDt(mm, (void *) &sa->dtg2p);
         picoos_deallocate(mm, (void *) &this->subObj);
     }
     return PICO_OK;
@@ -466,6 +482,9 @@ picodata_ProcessingUnit picosa_newSentAnaUnit(picoos_MemoryManager mm,
     }
 
     sa = (sa_subobj_t *) this->subObj;
+    sa->dtposd = NULL;
+    sa->dtg2p = NULL;
+    sa->firstPhraseWords = 0;
 
     sa->altDescBuf = picotrns_allocate_alt_desc_buf(mm, SA_MAX_ALTDESC_SIZE, &sa->maxAltDescLen);
     if (NULL == sa->altDescBuf) {
@@ -480,6 +499,21 @@ picodata_ProcessingUnit picosa_newSentAnaUnit(picoos_MemoryManager mm,
     return this;
 }
 
+/**
+ * sets the number of words after which the first phrase of an utterance
+ * is cut (low latency mode)
+ * @param    this : the SA PU
+ * @param    numWords : number of words; 0 disables cutting
+ * @callgraph
+ * @callergraph
+ */
+void picosa_setFirstPhraseWords(picodata_ProcessingUnit this,
+                                picoos_uint8 numWords) {
+    if ((NULL != this) && (NULL != this->subObj)) {
+        ((sa_subobj_t *) this->subObj)->firstPhraseWords = numWords;
+    }
+}
+
 
 /* ***********************************************************************/
 /* PROCESS_POSD disambiguation functions */
@@ -1150,6 +1184,10 @@ static pico_status_t getNextPosSym(sa_subobj_t * sa, picoos_int16 * pos, picoos_
 
 
 
+/* low latency: TRUE if the first phrase of an utterance is to be cut now */
+#define SA_CUT_FIRST_PHRASE(sa) ((sa)->inFirstPhrase && ((sa)->firstPhraseWords > 0) \
+                                 && ((sa)->nrWords >= (sa)->firstPhraseWords))
+
 /* ***********************************************************************/
 /*                          saStep function                              */
 /* ***********************************************************************/
@@ -1217,6 +1255,7 @@ static picodata_step_result_t saStep(register picodata_ProcessingUnit this,
             case SA_STEPSTATE_COLLECT:
 
                 while (sa->inspaceok && sa->needsmoreitems
+                       && !SA_CUT_FIRST_PHRASE(sa)
                        && (PICO_OK ==
                            (rv = picodata_cbGetItem(this->cbIn, sa->tmpbuf,
                                             PICOSA_MAXITEMSIZE, &blen)))) {
@@ -1281,6 +1320,18 @@ static picodata_step_result_t saStep(register picodata_ProcessingUnit this,
                     if (sa->headx[sa->headxLen].head.type ==
                         PICODATA_ITEM_PUNC) {
                         sa->needsmoreitems = FALSE;
+                        /* the next utterance starts after a flush */
+                        sa->inFirstPhrase =
+                            (sa->headx[sa->headxLen].head.info1 ==
+                             PICODATA_ITEMINFO1_PUNC_FLUSH);
+                        sa->nrWords = 0;
+                    } else if ((sa->headx[sa->headxLen].head.type ==
+                                PICODATA_ITEM_WORDGRAPH) ||
+                               (sa->headx[sa->headxLen].head.type ==
+                                PICODATA_ITEM_WORDINDEX) ||
+                               (sa->headx[sa->headxLen].head.type ==
+                                PICODATA_ITEM_WORDPHON)) {
+                        sa->nrWords++;
                     }
 
                     /* check/set inspaceok, keep spare slot for forcing */
@@ -1303,7 +1354,7 @@ static picodata_step_result_t saStep(register picodata_ProcessingUnit this,
                     /* 1, phrase buffered */
                     sa->procState = SA_STEPSTATE_PROCESS_POSD;
                     return PICODATA_PU_ATOMIC;
-                } else if (!sa->inspaceok) {
+                } else if (!sa->inspaceok || SA_CUT_FIRST_PHRASE(sa)) {
                     /* 2, forced phrase end */
                     /* at least one slot is still free, use it to
                        force a trailing PUNC item */
@@ -1315,10 +1366,18 @@ static picodata_step_result_t saStep(register picodata_ProcessingUnit this,
                     sa->headx[sa->headxLen].head.len = 0;
                     sa->needsmoreitems = FALSE; /* not really needed for now */
                     sa->headxLen++;
-                    PICODBG_WARN(("forcing phrase end, added PUNC_PHRASEEND"));
-                    picoos_emRaiseWarning(this->common->em,
-                                          PICO_WARN_FALLBACK, NULL,
-                                          (picoos_char *)"forced phrase end");
+                    if (sa->inspaceok) {
+                        /* low latency cut, no fallback */
+                        PICODBG_DEBUG(("cutting first phrase after %d words",
+                                       sa->nrWords));
+                    } else {
+                        PICODBG_WARN(("forcing phrase end, added PUNC_PHRASEEND"));
+                        picoos_emRaiseWarning(this->common->em,
+                                              PICO_WARN_FALLBACK, NULL,
+                                              (picoos_char *)"forced phrase end");
+                    }
+                    sa->inFirstPhrase = FALSE;
+                    sa->nrWords = 0;
                     sa->procState = SA_STEPSTATE_PROCESS_POSD;
                     return PICODATA_PU_ATOMIC;
                 } else if (rv == PICO_EOF) {
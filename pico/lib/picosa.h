@@ -208,6 +208,13 @@ picodata_ProcessingUnit picosa_newSentAnaUnit(
         picodata_CharBuffer cbOut,
         picorsrc_Voice voice);
 
+/* low latency: cut the first phrase of each utterance (i.e. after a flush)
+   after 'numWords' words, so that synthesis of the following PUs can start
+   early; 0 (default) disables cutting */
+void picosa_setFirstPhraseWords(
+        picodata_ProcessingUnit this,
+        picoos_uint8 numWords);
+
 #ifdef __cplusplus
 }
 #endif
@@ -320,7 +320,6 @@ static pico_status_t getPhsFromPdf(register picodata_ProcessingUnit this,
 {
     sig_subobj_t *sig_subObj;
     picokpdf_PdfPHS pdf;
-    static int nFrame = 0;
 
     picoos_uint32 nIndexValue;
     picoos_uint8 *nCurrIndexOffset, *nContent;
@@ -342,7 +341,7 @@ static pico_status_t getPhsFromPdf(register picodata_ProcessingUnit this,
     nContent += nIndexValue;
     *numComponents = (picoos_int16) *nContent++;
     if (*numComponents>PICODSP_PHASEORDER) {
-        PICODBG_DEBUG(("WARNING : Frame %d -- Phase vector[%d] Components = %d --> too big\n",  nFrame, phsIndex, *numComponents));
+        PICODBG_DEBUG(("WARNING : Phase vector[%d] Components = %d --> too big\n", phsIndex, *numComponents));
         *numComponents = PICODSP_PHASEORDER;
     }
     for (nI=0; nI<*numComponents; nI++) {
@@ -351,7 +350,6 @@ static pico_status_t getPhsFromPdf(register picodata_ProcessingUnit this,
     for (nI=*numComponents; nI<PICODSP_PHASEORDER; nI++) {
         phsVect[nI] = 0;
     }
-    nFrame++;
     return PICO_OK;
 }/*getPhsFromPdf*/
 
@@ -1015,9 +1013,6 @@ static picodata_step_result_t sigStep(register picodata_ProcessingUnit this,
                                             sig_subObj->sMod = f_value;
                                             sig_subObj->sig_inner.sMod_p
                                                     = sig_subObj->sMod;
-                                            /*call the function needed to initialize the speaker factor*/
-                                            mel_2_lin_init(
-                                                    &(sig_subObj->sig_inner));
                                                  break;
                                             default :
                                                 break;
@@ -31,6 +31,7 @@
 
 #include "picoos.h"
 #include "picodsp.h"
+#include "picofftsg.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -49,7 +50,6 @@ typedef struct sig_innerobj
 
     /*-----------------------Definition of the local storage for this PU--------*/
     picoos_int16 *idx_vect1; /*reserved for bit reversal tables*/
-    picoos_int16 *idx_vect2; /*reserved for table lookup "A" vector*/
     picoos_int16 *idx_vect4; /*reserved for max peak index arrax in pchip*/
     picoos_int16 *idx_vect5; /*reserved for min index arrax in sigana_singleIMF*/
     picoos_int16 *idx_vect6; /*reserved for max index arrax in sigana_singleIMF*/
@@ -57,27 +57,21 @@ typedef struct sig_innerobj
     picoos_int16 *idx_vect8; /*reserved for LocV*/
     picoos_int16 *idx_vect9; /*reserved for LocU*/
 
-    picoos_int32 *int_vec22; /*reserved for normalized hanning window - fixed point */
     picoos_int32 *int_vec23; /*reserved for impresp  - fixed point */
     picoos_int32 *int_vec24; /*reserved for impresp  - fixed point */
-    picoos_int32 *int_vec25; /*reserved for window  - fixed point */
     picoos_int32 *int_vec26; /*reserved for wavBuf  - fixed point */
     picoos_int32 *int_vec28; /*reserved for cepstral vectors input - fixed point */
     picoos_int32 *int_vec29; /*reserved for cepstral vectors input - fixed point */
-    picoos_int32 *int_vec38; /*reserved for cepstral vectors input - fixed point */
     picoos_int32 *int_vec30; /*reserved for cepstral vectors input - fixed point */
     picoos_int32 *int_vec31; /*reserved for cepstral vectors input - fixed point */
 
     picoos_int32 *int_vec32; /*reserved for cepstral vectors input - fixed point */
     picoos_int32 *int_vec33; /*reserved for cepstral vectors input - fixed point */
 
-    picoos_int32 *int_vec34; /* reserved for sin table- fixed point */
-    picoos_int32 *int_vec35; /* reserved for cos table - fixed point */
     picoos_int32 *int_vec36; /* reserved for currently used sin table- fixed point */
     picoos_int32 *int_vec37; /* reserved for currently used cos table - fixed point */
 
     picoos_int32 *int_vec39; /* reserved for ang - fixed point */
-    picoos_int32 *int_vec40; /* reserved for cos table - fixed point */
 
     picoos_int32 *int_vec41[CEPST_BUFF_SIZE]; /*reserved for phase smoothing - cepstrum buffers */
     picoos_int32 *int_vec42[PHASE_BUFF_SIZE]; /*reserved for phase smoothing - phase buffers */
@@ -90,6 +84,11 @@ typedef struct sig_innerobj
 
     picoos_int32 *sig_vec1;
 
+    picofftsg_Plan fftPlan; /* precomputed tables of the FFT and DCT */
+#if defined(PICODSP_FLOAT)
+    picoos_single *flt_vec1; /*reserved for the float32 FFT and DCT*/
+#endif
+
     picoos_single bvalue1; /*reserved for warp*/
     picoos_int32 ibvalue2; /*reserved for voxbnd*/
     picoos_int32 ibvalue3; /*reserved for voxbnd2*/
@@ -145,9 +144,7 @@ extern void sigDspInitialize(sig_innerobj_t *sig_inObj, picoos_int32 resetMode);
  Exported (to picosig.c) Processing routines :
  routine number, name and content can be changed. unique I/O parameter should be  "sig"
  ------------------------------------------------------------------*/
-extern void mel_2_lin_init(sig_innerobj_t *sig_inObj);
 extern void save_transition_frame(sig_innerobj_t *sig_inObj);
-extern void mel_2_lin_init(sig_innerobj_t *sig_inObj);
 extern void post_filter_init(sig_innerobj_t *sig_inObj);
 extern void mel_2_lin_lookup(sig_innerobj_t *sig_inObj, picoos_uint32 mgc);
 extern void post_filter(sig_innerobj_t *sig_inObj);
@@ -162,7 +159,6 @@ extern void overlap_add(sig_innerobj_t *sig_inObj);
  * symbolic vs area assignements
  * -------------------------------------------------------------------*/
 #define WavBuff_p   int_vec26       /*output is Wav buffer (2*FFTSize)*/
-#define window_p    int_vec25       /*window function (hanning) */
 #define ImpResp_p   int_vec23       /*output step 6*/
 #define imp_p       int_vec24       /*output step 6*/
 #define warp_p      bvalue1         /*warp factor */
@@ -194,18 +190,11 @@ extern void overlap_add(sig_innerobj_t *sig_inObj);
 #define UVCutoff_p  lvalue3         /*unvoicing cut off frequency in Hz*/
 /* Reusable area */
 #define wcep_pI     int_vec28       /*input step1*/
-#define d_p         int_vec38       /*output mel_2_lin_init  : table lookup  vector D*/
-#define A_p         idx_vect2       /*output mel_2_lin_init  : table lookup  vector A*/
 #define ang_p       int_vec39       /*output step4*/
 #define EnV         int_vec30
 #define EnU         int_vec31
-#define randCosTbl  int_vec34
-#define randSinTbl  int_vec35
 #define outCosTbl   int_vec36
 #define outSinTbl   int_vec37
-#define cos_table   int_vec40
-#define norm_window_p int_vec22     /*window function (hanning) */
-#define norm_window2_p int_vec27    /*window function (hanning) */
 #define F2r_p       int_vec32       /*output step 7*/
 #define F2i_p       int_vec33       /*output step 7*/
 #define LocV        idx_vect8       /*excitation position voiced pulses*/
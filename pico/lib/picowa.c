@@ -129,8 +129,11 @@ static pico_status_t waInitialize(register picodata_ProcessingUnit this, picoos_
     }
     PICODBG_DEBUG(("got tabpos"));
 
-    /* kb dtposp */
-    wa->dtposp = picokdt_getDtPosP(this->voice->kbArray[PICOKNOW_KBID_DT_POSP]);
+    /* kb dtposp (private copy, the kb may be shared with other engines) */
+    if (wa->dtposp == NULL) {
+        wa->dtposp = picokdt_newDtPosP(this->common->mm,
+                this->voice->kbArray[PICOKNOW_KBID_DT_POSP]);
+    }
     if (wa->dtposp == NULL) {
         return picoos_emRaiseException(this->common->em, PICO_EXC_KB_MISSING,
                                        NULL, NULL);
@@ -150,6 +153,8 @@ static pico_status_t waTerminate(register picodata_ProcessingUnit this) {
 static pico_status_t waSubObjDeallocate(register picodata_ProcessingUnit this,
                                         picoos_MemoryManager mm) {
     if (NULL != this) {
+        wa_subobj_t * wa = (wa_subobj_t *) this->subObj;
+        picokdt_disposeDt(this->common->mm, (void *) &wa->dtposp);
         picoos_deallocate(this->common->mm, (void *) &this->subObj);
     }
     mm = mm;        /* avoid warning "var not used in this function"*/
@@ -180,6 +185,7 @@ picodata_ProcessingUnit picowa_newWordAnaUnit(picoos_MemoryManager mm,
         picoos_emRaiseException(common->em, PICO_EXC_OUT_OF_MEM, NULL, NULL);
         return NULL;
     }
+    ((wa_subobj_t *) this->subObj)->dtposp = NULL;
 
     waInitialize(this, PICO_RESET_FULL);
     return this;
@@ -0,0 +1,109 @@
+/* fftcheck.c
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *   Runs the transforms of picofftsg.c, in the sizes used by SIG, on
+ *   pseudo-random input and prints the results, one value per line. The
+ *   program is built against the library with its vector kernels
+ *   (fftcheck) and against one built with PICODSP_NO_SIMD
+ *   (fftcheck_nosimd); fftcheck.sh requires their output to be identical.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <picoos.h>
+#include <picodsp.h>
+#include <picofftsg.h>
+
+#define NUM_TRIALS  500
+#define MEM_SIZE    200000
+
+static unsigned long seed = 1;
+
+/* portable linear congruential generator, so that every build sees the
+   same input */
+static long nextRandom(void)
+{
+    seed = (seed * 1103515245UL + 12345UL) & 0xffffffffUL;
+    return (long) (seed >> 1);
+}
+
+/* random value of up to 'bits' bits and either sign */
+static picoos_int32 randomValue(int bits)
+{
+    long r = nextRandom() & ((1L << bits) - 1);
+
+    return (picoos_int32) ((nextRandom() & 1) ? -r : r);
+}
+
+int main(int argc, char *argv[])
+{
+    static char mem[MEM_SIZE];
+    picoos_MemoryManager mm;
+    picofftsg_Plan plan;
+    PICOFFTSG_FFTTYPE a[PICODSP_FFTSIZE];
+#if defined(PICODSP_FLOAT)
+    picoos_single f[PICODSP_FFTSIZE];
+#endif
+    int trial, bits, i;
+
+    mm = picoos_newMemoryManager(mem, sizeof(mem), FALSE);
+    plan = (NULL == mm) ? NULL : picofftsg_newPlan(mm, PICODSP_FFTSIZE, PICODSP_H_FFTSIZE);
+    if (NULL == plan) {
+        fprintf(stderr, "Cannot create the transform plan\n");
+        return 1;
+    }
+
+    for (trial = 0; trial < NUM_TRIALS; trial++) {
+        /* from small values up to the magnitudes SIG passes in */
+        bits = 4 + trial % 21;
+
+        for (i = 0; i < PICODSP_FFTSIZE; i++) {
+            a[i] = randomValue(bits);
+        }
+        picofftsg_rdftInv(plan, a);
+        for (i = 0; i < PICODSP_FFTSIZE; i++) {
+            printf("rdft %d %d %ld\n", trial, i, (long) a[i]);
+        }
+
+        for (i = 0; i <= PICODSP_H_FFTSIZE; i++) {
+            a[i] = randomValue(bits);
+        }
+        picofftsg_dfctNmf(plan, a);
+        for (i = 0; i <= PICODSP_H_FFTSIZE; i++) {
+            printf("dfct %d %d %ld\n", trial, i, (long) a[i]);
+        }
+
+#if defined(PICODSP_FLOAT)
+        for (i = 0; i < PICODSP_FFTSIZE; i++) {
+            f[i] = (picoos_single) randomValue(bits);
+        }
+        picofftsg_rdftInvFloat(plan, f);
+        for (i = 0; i < PICODSP_FFTSIZE; i++) {
+            printf("rdftf %d %d %a\n", trial, i, (double) f[i]);
+        }
+
+        for (i = 0; i <= PICODSP_H_FFTSIZE; i++) {
+            f[i] = (picoos_single) randomValue(bits);
+        }
+        picofftsg_dfctNmfFloat(plan, f);
+        for (i = 0; i <= PICODSP_H_FFTSIZE; i++) {
+            printf("dfctf %d %d %a\n", trial, i, (double) f[i]);
+        }
+#endif
+    }
+
+    picofftsg_disposePlan(mm, &plan);
+    return 0;
+}
@@ -0,0 +1,11 @@
+#!/bin/sh
+# fftcheck.sh -- the transforms of the vector kernels (fftcheck) must give
+# exactly the results of the scalar code (fftcheck_nosimd)
+
+./fftcheck > fftcheck.out || exit 1
+./fftcheck_nosimd > fftcheck_nosimd.out || exit 1
+if ! cmp fftcheck.out fftcheck_nosimd.out; then
+    echo "fftcheck: SIMD and scalar transforms differ" >&2
+    exit 1
+fi
+rm -f fftcheck.out fftcheck_nosimd.out
@@ -0,0 +1,165 @@
+/* lsdcheck.c
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *   Computes the mean band log spectral distance of two speech signals
+ *   (16 bit little endian PCM) and fails if it exceeds a threshold. The
+ *   signals are cut into Hanning windowed frames of FRAME_LEN samples,
+ *   overlapping by half; the power spectrum of each frame is summed in
+ *   NUM_BANDS bands of equal width, and the distance of a frame is the
+ *   RMS of the band level differences in dB. Frames in which the first
+ *   signal is silent are skipped.
+ *
+ *   usage: lsdcheck <first.raw> <second.raw> <threshold in dB>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define FRAME_LEN   512
+#define NUM_BINS    (FRAME_LEN / 2)
+#define NUM_BANDS   32
+#define MIN_ENERGY  (FRAME_LEN * 1.0e4)  /* mean square of a silent frame */
+#define BAND_FLOOR  1.0e-5  /* of the frame energy, added to every band */
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Hanning windowed cosine and sine of the DFT, per bin */
+static double cosTable[NUM_BINS][FRAME_LEN];
+static double sinTable[NUM_BINS][FRAME_LEN];
+
+static void initTables(void)
+{
+    int f, k;
+    double w;
+
+    for (f = 0; f < NUM_BINS; f++) {
+        for (k = 0; k < FRAME_LEN; k++) {
+            w = 0.5 - 0.5 * cos(2 * M_PI * k / FRAME_LEN);
+            cosTable[f][k] = w * cos(2 * M_PI * f * k / FRAME_LEN);
+            sinTable[f][k] = w * sin(2 * M_PI * f * k / FRAME_LEN);
+        }
+    }
+}
+
+/* reads the whole file as 16 bit little endian samples */
+static short *readSamples(const char *fileName, long *numSamples)
+{
+    FILE *file;
+    short *samples = NULL;
+    long n = 0, size = 0;
+    int lo, hi;
+
+    if (NULL == (file = fopen(fileName, "rb"))) {
+        fprintf(stderr, "Cannot open %s\n", fileName);
+        return NULL;
+    }
+    while ((EOF != (lo = getc(file))) && (EOF != (hi = getc(file)))) {
+        if (n == size) {
+            size = size ? 2 * size : 65536;
+            samples = (short *) realloc(samples, size * sizeof(short));
+            if (NULL == samples) {
+                fprintf(stderr, "Out of memory\n");
+                fclose(file);
+                return NULL;
+            }
+        }
+        samples[n++] = (short) ((hi << 8) | lo);
+    }
+    fclose(file);
+    *numSamples = n;
+    return samples;
+}
+
+/* power of the frame at 'x' in NUM_BANDS bands, without the DC bin */
+static void bandPower(const short *x, double *band)
+{
+    int f, k;
+    double re, im;
+
+    for (f = 0; f < NUM_BANDS; f++) {
+        band[f] = 0;
+    }
+    for (f = 1; f < NUM_BINS; f++) {
+        re = im = 0;
+        for (k = 0; k < FRAME_LEN; k++) {
+            re += cosTable[f][k] * x[k];
+            im += sinTable[f][k] * x[k];
+        }
+        band[f * NUM_BANDS / NUM_BINS] += re * re + im * im;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    short *a, *b;
+    long na, nb, n, i;
+    int k, numFrames = 0;
+    double bandA[NUM_BANDS], bandB[NUM_BANDS];
+    double energy, floor, d, dist, sum = 0, threshold;
+
+    if (argc != 4) {
+        fprintf(stderr, "usage: %s <first.raw> <second.raw> <threshold in dB>\n", argv[0]);
+        return 2;
+    }
+    threshold = atof(argv[3]);
+    a = readSamples(argv[1], &na);
+    b = readSamples(argv[2], &nb);
+    if ((NULL == a) || (NULL == b)) {
+        return 1;
+    }
+    n = (na < nb) ? na : nb;
+    initTables();
+
+    for (i = 0; i + FRAME_LEN <= n; i += FRAME_LEN / 2) {
+        energy = 0;
+        for (k = 0; k < FRAME_LEN; k++) {
+            energy += (double) a[i + k] * a[i + k];
+        }
+        if (energy < MIN_ENERGY) {
+            continue;
+        }
+        bandPower(a + i, bandA);
+        bandPower(b + i, bandB);
+        floor = 0;
+        for (k = 0; k < NUM_BANDS; k++) {
+            floor += bandA[k];
+        }
+        floor *= BAND_FLOOR;
+        dist = 0;
+        for (k = 0; k < NUM_BANDS; k++) {
+            d = 10 * log10((bandA[k] + floor) / (bandB[k] + floor));
+            dist += d * d;
+        }
+        sum += sqrt(dist / NUM_BANDS);
+        numFrames++;
+    }
+    free(a);
+    free(b);
+
+    if (0 == numFrames) {
+        fprintf(stderr, "%s: no speech\n", argv[1]);
+        return 1;
+    }
+    printf("%s %s: mean band log spectral distance %.3f dB over %d frames\n",
+            argv[1], argv[2], sum / numFrames, numFrames);
+    if ((na != nb) || (sum / numFrames > threshold)) {
+        fprintf(stderr, "lsdcheck: %s and %s differ by more than %g dB or in length\n",
+                argv[1], argv[2], threshold);
+        return 1;
+    }
+    return 0;
+}
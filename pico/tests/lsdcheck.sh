@@ -0,0 +1,14 @@
+#!/bin/sh
+# lsdcheck.sh -- the speech of the float32 DSP code (pcmcheck_float) must stay
+# close to that of the fixed point code (pcmcheck_fixed): in every language,
+# a mean band log spectral distance below 1.5 dB (measured: 0.7 to 1.1 dB)
+
+lang=${srcdir:-.}/lang
+./pcmcheck_fixed "$lang" lsdcheck-fixed- > /dev/null || exit 1
+./pcmcheck_float "$lang" lsdcheck-float- > /dev/null || exit 1
+ret=0
+for l in en-US en-GB de-DE es-ES fr-FR it-IT; do
+    ./lsdcheck lsdcheck-fixed-$l.raw lsdcheck-float-$l.raw 1.5 || ret=1
+done
+rm -f lsdcheck-*.raw
+exit $ret
@@ -0,0 +1,203 @@
+/* pcmcheck.c
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *   Synthesizes a fixed text in every supported language and prints, per
+ *   language, the number of samples and a hash (FNV-1a) of the PCM,
+ *   after a line naming the arithmetic of the DSP code. Like
+ *   fftcheck, the program is built against the library with its vector
+ *   kernels (pcmcheck) and against one built with PICODSP_NO_SIMD
+ *   (pcmcheck_nosimd); pcmcheck.sh requires both to print the same, and
+ *   the fixed point builds to print tests/pcmcheck.ref. With a second
+ *   argument, the speech of each language is also written to
+ *   <prefix><language>.raw (16 bit little endian); lsdcheck.sh compares
+ *   those of a fixed and a float build (pcmcheck_fixed, pcmcheck_float).
+ *
+ *   usage: pcmcheck <lingware directory> [<prefix>]
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <picoapi.h>
+
+/* the memory area of pico2wave; the resources are copied into it, so that
+   the engine of every build must fit next to the largest voice */
+#define MEM_SIZE    2500000
+#define VOICE_NAME  "PcmCheck"
+
+typedef struct {
+    const char *lang;
+    const char *ta;
+    const char *sg;
+    const char *text;
+} check_lang_t;
+
+/* the texts include numbers and questions, which take other paths through
+   the front-end; non-ASCII characters are UTF8 escapes */
+static const check_lang_t checkLang[] = {
+    { "en-US", "en-US_ta.bin", "en-US_lh0_sg.bin",
+      "The quick brown fox jumps over the lazy dog. Is it 12.50 dollars?" },
+    { "en-GB", "en-GB_ta.bin", "en-GB_kh0_sg.bin",
+      "The quick brown fox jumps over the lazy dog. Is it 12.50 pounds?" },
+    { "de-DE", "de-DE_ta.bin", "de-DE_gl0_sg.bin",
+      "Der schnelle braune Fuchs springt \xc3\xbc" "ber den faulen Hund. "
+      "Kostet das 12,50 Euro?" },
+    { "es-ES", "es-ES_ta.bin", "es-ES_zl0_sg.bin",
+      "El veloz murci\xc3\xa9lago hind\xc3\xba com\xc3\xad" "a feliz cardillo y kiwi. "
+      "\xc2\xbf" "Cuesta 12,50 euros?" },
+    { "fr-FR", "fr-FR_ta.bin", "fr-FR_nk0_sg.bin",
+      "Portez ce vieux whisky au juge blond qui fume. "
+      "Est-ce que \xc3\xa7" "a co\xc3\xbb" "te 12,50 euros ?" },
+    { "it-IT", "it-IT_ta.bin", "it-IT_cm0_sg.bin",
+      "Ma la volpe, col suo balzo, ha raggiunto il quieto Fido. "
+      "Costa 12,50 euro?" }
+};
+
+#define NUM_LANG    (sizeof(checkLang) / sizeof(checkLang[0]))
+
+typedef struct {
+    unsigned long hash;
+    unsigned long numSamples;
+    FILE *file;     /* NULL, or where the samples are written to */
+    int writeError;
+} pcm_sum_t;
+
+static pico_Status addSamples(void *userData, pico_Int16 event,
+        const pico_Int16 *samples, pico_Int32 numSamples,
+        const pico_Char *markName)
+{
+    pcm_sum_t *sum = (pcm_sum_t *) userData;
+    pico_Int32 i;
+    unsigned int s;
+    unsigned char b[2];
+
+    (void) markName;
+    if (PICO_EVENT_AUDIO != event) {
+        return PICO_OK;
+    }
+    /* little endian bytes of each sample, independent of the host */
+    for (i = 0; i < numSamples; i++) {
+        s = (unsigned int) (unsigned short) samples[i];
+        sum->hash = ((sum->hash ^ (s & 0xff)) * 16777619UL) & 0xffffffffUL;
+        sum->hash = ((sum->hash ^ (s >> 8)) * 16777619UL) & 0xffffffffUL;
+        if (NULL != sum->file) {
+            b[0] = (unsigned char) (s & 0xff);
+            b[1] = (unsigned char) (s >> 8);
+            sum->writeError |= (fwrite(b, 1, 2, sum->file) != 2);
+        }
+    }
+    sum->numSamples += numSamples;
+    return PICO_OK;
+}
+
+static int checkLanguage(pico_System system, const char *dir,
+        const char *prefix, const check_lang_t *l)
+{
+    char fileName[1024];
+    pico_Retstring taName, sgName;
+    pico_Resource ta = NULL, sg = NULL;
+    pico_Engine engine = NULL;
+    pcm_sum_t sum;
+    pico_Status status;
+
+    sprintf(fileName, "%s/%s", dir, l->ta);
+    status = pico_loadResource(system, (pico_Char *) fileName, &ta);
+    if (PICO_OK == status) {
+        sprintf(fileName, "%s/%s", dir, l->sg);
+        status = pico_loadResource(system, (pico_Char *) fileName, &sg);
+    }
+    if (PICO_OK == status) {
+        status = pico_getResourceName(system, ta, taName);
+    }
+    if (PICO_OK == status) {
+        status = pico_getResourceName(system, sg, sgName);
+    }
+    if (PICO_OK == status) {
+        status = pico_createVoiceDefinition(system, (pico_Char *) VOICE_NAME);
+    }
+    if (PICO_OK == status) {
+        status = pico_addResourceToVoiceDefinition(system, (pico_Char *) VOICE_NAME, (pico_Char *) taName);
+    }
+    if (PICO_OK == status) {
+        status = pico_addResourceToVoiceDefinition(system, (pico_Char *) VOICE_NAME, (pico_Char *) sgName);
+    }
+    if (PICO_OK == status) {
+        status = pico_newEngine(system, (pico_Char *) VOICE_NAME, &engine);
+    }
+    if (PICO_OK == status) {
+        sum.hash = 2166136261UL;
+        sum.numSamples = 0;
+        sum.file = NULL;
+        sum.writeError = 0;
+        if (NULL != prefix) {
+            sprintf(fileName, "%s%s.raw", prefix, l->lang);
+            sum.file = fopen(fileName, "wb");
+            sum.writeError = (NULL == sum.file);
+        }
+        status = pico_synthesize(engine, (pico_Char *) l->text,
+                (pico_Int32) strlen(l->text) + 1, addSamples, &sum);
+        if ((NULL != sum.file) && (0 != fclose(sum.file))) {
+            sum.writeError = 1;
+        }
+        if ((PICO_OK == status) && sum.writeError) {
+            fprintf(stderr, "%s: cannot write %s\n", l->lang, fileName);
+            status = PICO_ERR_OTHER;
+        }
+    }
+    if (PICO_OK == status) {
+        printf("%s %lu %08lx\n", l->lang, sum.numSamples, sum.hash);
+    } else {
+        fprintf(stderr, "%s: synthesis failed with status %d\n", l->lang, (int) status);
+    }
+
+    if (NULL != engine) {
+        pico_disposeEngine(system, &engine);
+    }
+    pico_releaseVoiceDefinition(system, (pico_Char *) VOICE_NAME);
+    if (NULL != sg) {
+        pico_unloadResource(system, &sg);
+    }
+    if (NULL != ta) {
+        pico_unloadResource(system, &ta);
+    }
+    return (PICO_OK == status) ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    static char mem[MEM_SIZE];
+    pico_System system;
+    unsigned int i;
+    int ret = 0;
+
+    if ((argc != 2) && (argc != 3)) {
+        fprintf(stderr, "usage: %s <lingware directory> [<prefix>]\n", argv[0]);
+        return 2;
+    }
+    if (PICO_OK != pico_initialize(mem, sizeof(mem), &system)) {
+        fprintf(stderr, "Cannot initialize pico\n");
+        return 1;
+    }
+#if defined(PICODSP_FLOAT)
+    printf("dsp float\n");
+#else
+    printf("dsp fixed\n");
+#endif
+    for (i = 0; i < NUM_LANG; i++) {
+        ret |= checkLanguage(system, argv[1], (argc > 2) ? argv[2] : NULL,
+                &checkLang[i]);
+    }
+    pico_terminate(&system);
+    return ret;
+}
@@ -0,0 +1,20 @@
+#!/bin/sh
+# pcmcheck.sh -- the speech of the vector kernels (pcmcheck) must be exactly
+# that of the scalar code (pcmcheck_nosimd); in fixed point builds on x86_64,
+# both must also match the reference hashes of tests/pcmcheck.ref, which are
+# to be updated only by changes meant to change the output
+
+lang=${srcdir:-.}/lang
+./pcmcheck "$lang" > pcmcheck.out || exit 1
+./pcmcheck_nosimd "$lang" > pcmcheck_nosimd.out || exit 1
+if ! cmp pcmcheck.out pcmcheck_nosimd.out; then
+    echo "pcmcheck: SIMD and scalar speech differ" >&2
+    exit 1
+fi
+if test "`sed -n 1p pcmcheck.out`" = "dsp fixed" && test "`uname -m`" = x86_64; then
+    if ! diff ${srcdir:-.}/tests/pcmcheck.ref pcmcheck.out; then
+        echo "pcmcheck: speech differs from tests/pcmcheck.ref" >&2
+        exit 1
+    fi
+fi
+rm -f pcmcheck.out pcmcheck_nosimd.out
@@ -0,0 +1,251 @@
+/* sigbench.c
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *   Microbenchmark of the per-frame signal generation (picosig2). It runs
+ *   the steps of sigProcess (mel_2_lin_lookup to overlap_add) on a
+ *   sequence of synthetic frames, alternating unvoiced and voiced stretches
+ *   with values in the ranges CEP produces, and prints the time per frame
+ *   of each step and of sigDspInitialize (full reset). Every run starts
+ *   from the same state and frames; the minimum over the runs is printed.
+ *   The program is built by 'make check' but not run as a test; it is
+ *   meant to compare the library before and after a change to SIG.
+ *
+ *   usage: sigbench [<frames> [<runs>]]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <picoos.h>
+#include <picosig2.h>
+
+#define MEM_SIZE        400000
+#define MGC_POW         10      /* bigpow - meanpow of the MGC pdf of the voices */
+#define CYCLE_LEN       40      /* frames of an unvoiced plus a voiced stretch */
+#define UNVOICED_LEN    10
+#define NUM_STEPS       7
+
+static const char *stepName[NUM_STEPS] = {
+    "save_transition_frame", "mel_2_lin_lookup", "phase_spec2", "env_spec",
+    "impulse_response", "td_psola2", "overlap_add"
+};
+
+typedef struct {
+    picoos_int16 F0;        /* Hz, 0 if unvoiced */
+    picoos_int16 Fuv;       /* Hz */
+    picoos_int16 voicing;   /* 0..15 */
+    picoos_int16 voxBnd;    /* number of phase components, 71 in most voiced frames */
+    picoos_int32 cep[PICODSP_CEPORDER];
+    picoos_int32 phs[PICODSP_PHASEORDER];
+} bench_frame_t;
+
+static double now(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static unsigned long seed = 1;
+
+static picoos_int32 randRange(picoos_int32 range)
+{
+    seed = (seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+    return (picoos_int32) ((seed >> 8) % (2 * range + 1)) - range;
+}
+
+/* smooth trajectories; the cepstra follow a random walk around a decaying
+   envelope, the phases of voiced frames a random walk in 0..255 */
+static void makeFrames(bench_frame_t *frame, int numFrames)
+{
+    int n, i, k;
+    picoos_int32 c[PICODSP_CEPORDER], p;
+
+    for (i = 0; i < PICODSP_CEPORDER; i++) {
+        c[i] = 0;
+    }
+    for (n = 0; n < numFrames; n++) {
+        k = n % CYCLE_LEN;
+        if (k < UNVOICED_LEN) {
+            frame[n].F0 = 0;
+            frame[n].voicing = 3;
+            frame[n].voxBnd = 0;
+        } else {
+            frame[n].F0 = 110 + (80 * (k - UNVOICED_LEN)) / (CYCLE_LEN - UNVOICED_LEN);
+            frame[n].voicing = (k < UNVOICED_LEN + 2) ? 12 : 15;
+            frame[n].voxBnd = PICODSP_PHASEORDER - 1;
+        }
+        frame[n].Fuv = 180 + (picoos_int16) randRange(10);
+        for (i = 0; i < PICODSP_CEPORDER; i++) {
+            c[i] += randRange(400 / (i + 1));
+            if (c[i] > 4000 / (i + 1)) {
+                c[i] = 4000 / (i + 1);
+            } else if (c[i] < -4000 / (i + 1)) {
+                c[i] = -4000 / (i + 1);
+            }
+            frame[n].cep[i] = c[i];
+        }
+        frame[n].cep[0] += 9000;
+        p = 0;
+        for (i = 0; i < PICODSP_PHASEORDER; i++) {
+            p = (i < frame[n].voxBnd) ? (p + 256 + randRange(40)) % 256 : 0;
+            frame[n].phs[i] = p;
+        }
+    }
+}
+
+/* puts the frame into the newest buffer entries and takes the oldest,
+   as sigProcess does with an item FRAME_PAR */
+static void loadFrame(sig_innerobj_t *sig, const bench_frame_t *frame)
+{
+    picoos_int32 *tmp;
+    picoos_int16 i;
+
+    for (i = 0; i < CEPST_BUFF_SIZE - 1; i++) {
+        sig->F0Buff[i] = sig->F0Buff[i + 1];
+        sig->VoicingBuff[i] = sig->VoicingBuff[i + 1];
+        sig->FuVBuff[i] = sig->FuVBuff[i + 1];
+    }
+    for (i = 0; i < PHASE_BUFF_SIZE - 1; i++) {
+        sig->VoxBndBuff[i] = sig->VoxBndBuff[i + 1];
+    }
+    tmp = sig->CepBuff[0];
+    for (i = 0; i < CEPST_BUFF_SIZE - 1; i++) {
+        sig->CepBuff[i] = sig->CepBuff[i + 1];
+    }
+    sig->CepBuff[CEPST_BUFF_SIZE - 1] = tmp;
+    tmp = sig->PhsBuff[0];
+    for (i = 0; i < PHASE_BUFF_SIZE - 1; i++) {
+        sig->PhsBuff[i] = sig->PhsBuff[i + 1];
+    }
+    sig->PhsBuff[PHASE_BUFF_SIZE - 1] = tmp;
+
+    sig->prevVoiced_p = sig->voiced_p;
+    sig->F0Buff[CEPST_BUFF_SIZE - 1] = frame->F0;
+    sig->VoicingBuff[CEPST_BUFF_SIZE - 1] = frame->voicing;
+    sig->FuVBuff[CEPST_BUFF_SIZE - 1] = frame->Fuv;
+    sig->F0_p = (picoos_single) sig->F0Buff[0];
+    sig->voicing = (picoos_single) sig->VoicingBuff[0] / (picoos_single) 15.0f;
+    sig->Fuv_p = (picoos_single) sig->FuVBuff[0];
+    sig->voiced_p = (sig->F0_p > 0.0f) ? 1 : 0;
+    for (i = 0; i < PICODSP_CEPORDER; i++) {
+        sig->CepBuff[CEPST_BUFF_SIZE - 1][i] = frame->cep[i];
+        sig->wcep_pI[i] = sig->CepBuff[0][i];
+    }
+    for (i = 0; i < PICODSP_PHASEORDER; i++) {
+        sig->PhsBuff[PHASE_BUFF_SIZE - 1][i] = frame->phs[i];
+    }
+    sig->VoxBndBuff[PHASE_BUFF_SIZE - 1] = frame->voxBnd;
+}
+
+/* runs all frames once and adds the time of each step to 'ns'; like
+   sigProcess, the steps start when the frame buffers are full */
+static void runFrames(sig_innerobj_t *sig, const bench_frame_t *frame,
+        int numFrames, double *ns)
+{
+    double t0, t1;
+    int n;
+
+    for (n = 0; n < numFrames; n++) {
+        loadFrame(sig, &frame[n]);
+        if (n < CEPST_BUFF_SIZE - 1) {
+            continue;
+        }
+        t0 = now();
+        save_transition_frame(sig);
+        t1 = now(); ns[0] += t1 - t0; t0 = t1;
+        mel_2_lin_lookup(sig, MGC_POW);
+        t1 = now(); ns[1] += t1 - t0; t0 = t1;
+        phase_spec2(sig);
+        t1 = now(); ns[2] += t1 - t0; t0 = t1;
+        env_spec(sig);
+        t1 = now(); ns[3] += t1 - t0; t0 = t1;
+        impulse_response(sig);
+        t1 = now(); ns[4] += t1 - t0; t0 = t1;
+        td_psola2(sig);
+        t1 = now(); ns[5] += t1 - t0; t0 = t1;
+        overlap_add(sig);
+        t1 = now(); ns[6] += t1 - t0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    static char mem[MEM_SIZE];
+    picoos_MemoryManager mm;
+    sig_innerobj_t sig;
+    bench_frame_t *frame;
+    int numFrames = 2000, numRuns = 20, run, s;
+    double ns[NUM_STEPS], best[NUM_STEPS], total, bestTotal = 0, t0, init,
+            bestInit = 0;
+
+    if (argc > 1) {
+        numFrames = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        numRuns = atoi(argv[2]);
+    }
+    if ((numFrames < 1) || (numRuns < 1)) {
+        fprintf(stderr, "usage: %s [<frames> [<runs>]]\n", argv[0]);
+        return 2;
+    }
+    frame = (bench_frame_t *) malloc(numFrames * sizeof(bench_frame_t));
+    mm = picoos_newMemoryManager(mem, sizeof(mem), FALSE);
+    if ((NULL == frame) || (NULL == mm)
+            || (PICO_OK != sigAllocate(mm, &sig))) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    makeFrames(frame, numFrames);
+
+    for (run = 0; run < numRuns; run++) {
+        t0 = now();
+        sigDspInitialize(&sig, PICO_RESET_FULL);
+        init = now() - t0;
+        for (s = 0; s < NUM_STEPS; s++) {
+            ns[s] = 0;
+        }
+        runFrames(&sig, frame, numFrames, ns);
+        total = 0;
+        for (s = 0; s < NUM_STEPS; s++) {
+            total += ns[s];
+        }
+        if ((0 == run) || (total < bestTotal)) {
+            bestTotal = total;
+            for (s = 0; s < NUM_STEPS; s++) {
+                best[s] = ns[s];
+            }
+        }
+        if ((0 == run) || (init < bestInit)) {
+            bestInit = init;
+        }
+    }
+
+#if defined(PICODSP_FLOAT)
+    printf("dsp float, %d frames, best of %d runs\n", numFrames, numRuns);
+#else
+    printf("dsp fixed, %d frames, best of %d runs\n", numFrames, numRuns);
+#endif
+    for (s = 0; s < NUM_STEPS; s++) {
+        printf("%-22s %8.0f ns/frame\n", stepName[s], best[s] / numFrames);
+    }
+    printf("%-22s %8.0f ns/frame\n", "total", bestTotal / numFrames);
+    printf("%-22s %8.0f ns\n", "sigDspInitialize", bestInit);
+
+    sigDeallocate(mm, &sig);
+    free(frame);
+    return 0;
+}
@@ -39,6 +39,7 @@
 
 #include <utils/Log.h>
 #include <utils/String16.h>                     /* for strlen16 */
+#include <utils/threads.h>                      /* for Mutex */
 #include <android_runtime/AndroidRuntime.h>
 #include <TtsEngine.h>
 
@@ -51,6 +52,8 @@
 using namespace android;
 
 /* adaptation layer defines */
+/* initial size of the Pico memory; if a voice needs more, Pico extends it
+   from the heap (PICO_MEM_GROW) */
 #define PICO_MEM_SIZE       2500000
 /* speaking rate    */
 #define PICO_MIN_RATE        20
@@ -103,13 +106,15 @@ pico_Resource   picoTaResource      = NULL;
 pico_Resource   picoSgResource      = NULL;
 pico_Resource   picoUtppResource    = NULL;
 pico_Engine     picoEngine          = NULL;
+/* held while picoEngine is created or disposed, and by stop(), which may be
+   called from another thread than the synthesis */
+Mutex           picoEngineLock;
 pico_Char *     picoTaFileName      = NULL;
 pico_Char *     picoSgFileName      = NULL;
 pico_Char *     picoUtppFileName    = NULL;
 pico_Char *     picoTaResourceName  = NULL;
 pico_Char *     picoSgResourceName  = NULL;
 pico_Char *     picoUtppResourceName = NULL;
-int     picoSynthAbort = 0;
 char *  picoProp_currLang   = NULL;                 /* current language */
 int     picoProp_currRate   = PICO_DEF_RATE;        /* current rate     */
 int     picoProp_currPitch  = PICO_DEF_PITCH;       /* current pitch    */
@@ -177,10 +182,13 @@ static int checkForLocale( const char * locale )
 */
 static void cleanResources( void )
 {
-    if (picoEngine) {
-        pico_disposeEngine( picoSystem, &picoEngine );
-        pico_releaseVoiceDefinition( picoSystem, (pico_Char *) PICO_VOICE_NAME );
-        picoEngine = NULL;
+    {
+        Mutex::Autolock lock( picoEngineLock );
+        if (picoEngine) {
+            pico_disposeEngine( picoSystem, &picoEngine );
+            pico_releaseVoiceDefinition( picoSystem, (pico_Char *) PICO_VOICE_NAME );
+            picoEngine = NULL;
+        }
     }
     if (picoUtppResource) {
         pico_unloadResource( picoSystem, &picoUtppResource );
@@ -327,7 +335,7 @@ static tts_result doLanguageSwitchFromLangIndex( int langIndex )
 
     if (picoSystem==NULL) {
         /*re-init system object*/
-        ret = pico_initialize( picoMemArea, PICO_MEM_SIZE, &picoSystem );
+        ret = pico_initializeEx( picoMemArea, PICO_MEM_SIZE, PICO_MEM_FIRST_FIT | PICO_MEM_GROW, &picoSystem );
         if (PICO_OK != ret) {
             ALOGE("Failed to initialize the pico system object\n");
             return TTS_FAILURE;
@@ -477,7 +485,10 @@ static tts_result doLanguageSwitchFromLangIndex( int langIndex )
         return TTS_FAILURE;
     }
 
-    ret = pico_newEngine( picoSystem, (const pico_Char *) PICO_VOICE_NAME, &picoEngine );
+    {
+        Mutex::Autolock lock( picoEngineLock );
+        ret = pico_newEngine( picoSystem, (const pico_Char *) PICO_VOICE_NAME, &picoEngine );
+    }
     if (PICO_OK != ret) {
         ALOGE("Failed to create engine for %s [%d]", picoSupportedLang[langIndex], ret);
         cleanResources();
@@ -1055,7 +1066,7 @@ tts_result TtsEngine::init( synthDoneCB_t synthDoneCBPtr, const char *config )
         return TTS_FAILURE;
     }
 
-    pico_Status ret = pico_initialize( picoMemArea, PICO_MEM_SIZE, &picoSystem );
+    pico_Status ret = pico_initializeEx( picoMemArea, PICO_MEM_SIZE, PICO_MEM_FIRST_FIT | PICO_MEM_GROW, &picoSystem );
     if (PICO_OK != ret) {
         ALOGE("Failed to initialize Pico system");
         free( picoMemArea );
@@ -1445,6 +1456,53 @@ tts_result TtsEngine::getProperty( const char * property, char * value, size_t *
 }
 
 
+/* output state of synthesizeText */
+typedef struct {
+    int8_t *    buffer;
+    size_t      bufferSize;
+    size_t      bufused;
+    void *      userdata;
+} synthOutput_t;
+
+/** synthOutput
+ *  Synthesis callback of synthesizeText: collects the samples in the caller's
+ *  buffer and passes it on to the callback function whenever it is full.
+ *  return PICO_OK to continue, anything else to stop synthesis
+*/
+static pico_Status synthOutput( void * ctx, pico_Int16 event, const pico_Int16 * samples,
+        pico_Int32 numSamples, const pico_Char * markName )
+{
+    synthOutput_t * out = (synthOutput_t *) ctx;
+    size_t bytes = numSamples * sizeof(pico_Int16);
+    size_t n;
+    int cbret;
+
+    if (event != PICO_EVENT_AUDIO) {
+        return PICO_OK;
+    }
+    while (bytes > 0) {
+        if (out->bufused == out->bufferSize) {
+            /* The buffer filled; pass this on to the callback function.    */
+            cbret = picoSynthDoneCBPtr(out->userdata, 16000, TTS_AUDIO_FORMAT_PCM_16_BIT, 1,
+                    out->buffer, out->bufused, TTS_SYNTH_PENDING);
+            if (cbret == TTS_CALLBACK_HALT) {
+                ALOGI("Halt requested by caller. Halting.");
+                return PICO_WARN_CANCELLED;
+            }
+            out->bufused = 0;
+        }
+        n = out->bufferSize - out->bufused;
+        if (n > bytes) {
+            n = bytes;
+        }
+        memcpy(out->buffer + out->bufused, samples, n);
+        out->bufused += n;
+        samples += n / sizeof(pico_Int16);
+        bytes -= n;
+    }
+    return PICO_OK;
+}
+
 /** synthesizeText
  *  Synthesizes a text string.
  *  The text string could be annotated with SSML tags.
@@ -1457,16 +1515,11 @@ tts_result TtsEngine::getProperty( const char * property, char * value, size_t *
 tts_result TtsEngine::synthesizeText( const char * text, int8_t * buffer, size_t bufferSize, void * userdata )
 {
     int         err;
-    int         cbret;
-    pico_Char * inp = NULL;
     char *      expanded_text = NULL;
     pico_Char * local_text = NULL;
-    short       outbuf[MAX_OUTBUF_SIZE/2];
-    pico_Int16  bytes_sent, bytes_recv, text_remaining, out_data_type;
     pico_Status ret;
     SvoxSsmlParser * parser = NULL;
 
-    picoSynthAbort = 0;
     if (text == NULL) {
         ALOGE("synthesizeText called with NULL string");
         return TTS_FAILURE;
@@ -1546,86 +1599,33 @@ tts_result TtsEngine::synthesizeText( const char * text, int8_t * buffer, size_t
         }
     }
 
-    text_remaining = strlen((const char *) local_text) + 1;
-
-    inp = (pico_Char *) local_text;
-
-    size_t bufused = 0;
-
-    /* synthesis loop   */
-    while (text_remaining) {
-        if (picoSynthAbort) {
-            ret = pico_resetEngine( picoEngine, PICO_RESET_SOFT );
-            break;
-        }
-
-        /* Feed the text into the engine.   */
-        ret = pico_putTextUtf8( picoEngine, inp, text_remaining, &bytes_sent );
-        if (ret != PICO_OK) {
-            ALOGE("Error synthesizing string '%s': [%d]", text, ret);
-            if (local_text) {
-                free( local_text );
-            }
-            return TTS_FAILURE;
-        }
+    synthOutput_t output = { buffer, bufferSize, 0, userdata };
 
-        text_remaining -= bytes_sent;
-        inp += bytes_sent;
-        do {
-            if (picoSynthAbort) {
-                ret = pico_resetEngine( picoEngine, PICO_RESET_SOFT );
-                break;
-            }
-            /* Retrieve the samples and add them to the buffer. */
-            ret = pico_getData( picoEngine, (void *) outbuf, MAX_OUTBUF_SIZE, &bytes_recv,
-                    &out_data_type );
-            if (bytes_recv) {
-                if ((bufused + bytes_recv) <= bufferSize) {
-                    memcpy(buffer+bufused, (int8_t *) outbuf, bytes_recv);
-                    bufused += bytes_recv;
-                } else {
-                    /* The buffer filled; pass this on to the callback function.    */
-                    cbret = picoSynthDoneCBPtr(userdata, 16000, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer,
-                            bufused, TTS_SYNTH_PENDING);
-                    if (cbret == TTS_CALLBACK_HALT) {
-                        ALOGI("Halt requested by caller. Halting.");
-                        picoSynthAbort = 1;
-                        ret = pico_resetEngine( picoEngine, PICO_RESET_SOFT );
-                        break;
-                    }
-                    bufused = 0;
-                    memcpy(buffer, (int8_t *) outbuf, bytes_recv);
-                    bufused += bytes_recv;
-                }
-            }
-        } while (PICO_STEP_BUSY == ret);
-
-        /* This chunk of synthesis is finished; pass the remaining samples.
-           Use 16 KHz, 16-bit samples.                                              */
-        if (!picoSynthAbort) {
-            picoSynthDoneCBPtr( userdata, 16000, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer, bufused,
-                    TTS_SYNTH_PENDING);
+    /* synthesis loop: pico_synthesize passes the samples to synthOutput */
+    ret = pico_synthesize( picoEngine, local_text, strlen((const char *) local_text),
+            synthOutput, &output );
+    if ((ret != PICO_OK) && (ret != PICO_WARN_CANCELLED)) {
+        ALOGE("Error occurred during synthesis [%d]", ret);
+        if (local_text) {
+            free(local_text);
         }
-        picoSynthAbort = 0;
+        ALOGV("Synth loop: sending TTS_SYNTH_DONE after error");
+        picoSynthDoneCBPtr( userdata, 16000, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer, output.bufused,
+                TTS_SYNTH_DONE);
+        pico_resetEngine( picoEngine, PICO_RESET_SOFT );
+        return TTS_FAILURE;
+    }
 
-        if (ret != PICO_STEP_IDLE) {
-            if (ret != 0){
-                ALOGE("Error occurred during synthesis [%d]", ret);
-            }
-            if (local_text) {
-                free(local_text);
-            }
-            ALOGV("Synth loop: sending TTS_SYNTH_DONE after error");
-            picoSynthDoneCBPtr( userdata, 16000, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer, bufused,
-                    TTS_SYNTH_DONE);
-            pico_resetEngine( picoEngine, PICO_RESET_SOFT );
-            return TTS_FAILURE;
-        }
+    /* Synthesis is finished; pass the remaining samples.
+       Use 16 KHz, 16-bit samples.                                              */
+    if (ret != PICO_WARN_CANCELLED) {
+        picoSynthDoneCBPtr( userdata, 16000, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer, output.bufused,
+                TTS_SYNTH_PENDING);
     }
 
     /* Synthesis is done; notify the caller */
     ALOGV("Synth loop: sending TTS_SYNTH_DONE after all done, or was asked to stop");
-    picoSynthDoneCBPtr( userdata, 16000, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer, bufused,
+    picoSynthDoneCBPtr( userdata, 16000, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer, output.bufused,
             TTS_SYNTH_DONE);
 
     if (local_text) {
@@ -1642,7 +1642,12 @@ tts_result TtsEngine::synthesizeText( const char * text, int8_t * buffer, size_t
 */
 tts_result TtsEngine::stop( void )
 {
-    picoSynthAbort = 1;
+    /* the synthesis loop returns PICO_WARN_CANCELLED within one step; the
+       lock keeps a language switch from disposing the engine meanwhile */
+    Mutex::Autolock lock( picoEngineLock );
+    if (picoEngine) {
+        pico_cancelEngine( picoEngine );
+    }
     return TTS_SUCCESS;
 }
 